@@ -0,0 +1,282 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+
+// External
+
+// Project
+#include "../src/NetMessage/Ver/NetMessageV1.h"
+#include "../src/NetMessage/NetResponse.h"
+#include "../src/Database/Memory/MemoryStore.h"
+#include "../src/SharedList.h"
+#include "./Bench.h"
+
+using namespace NetMessageV1;
+
+namespace
+{
+    thread_local size_t us_Allocation = 0;
+}
+
+// @NOTE: Allocations are counted per thread, the counter is
+//        read before and after each step.
+void* operator new(size_t us_Size)
+{
+    ++us_Allocation;
+    
+    void* p_Memory = malloc(us_Size > 0 ? us_Size : 1);
+    
+    if (p_Memory == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    
+    return p_Memory;
+}
+
+void operator delete(void* p_Memory) noexcept
+{
+    free(p_Memory);
+}
+
+void operator delete(void* p_Memory, size_t) noexcept
+{
+    free(p_Memory);
+}
+
+namespace
+{
+    //*************************************************************************************
+    // Client
+    //*************************************************************************************
+    
+    // @NOTE: The steps a client performs for each message, without
+    //        the connection. Sent messages are released like after
+    //        send completion.
+    struct Cycle
+    {
+        enum Step
+        {
+            STEP_AUTH = 0,
+            STEP_STORE = 1,
+            STEP_POLL = 2,
+            STEP_POLL_EMPTY = 3,
+            
+            STEP_COUNT = STEP_POLL_EMPTY + 1
+        };
+        
+        Cycle() : s_DeviceKey(us_SizeDeviceKey, 'd')
+        {
+            v_AuthRequest.assign(us_SizeMsgAuthRequest, 'a');
+            v_AuthRequest[NetMessage::us_IDPos] = NetMessage::MSG_AUTH_REQUEST;
+            
+            v_AuthProof.assign(us_SizeMsgAuthProof, 'p');
+            v_AuthProof[NetMessage::us_IDPos] = NetMessage::MSG_AUTH_PROOF;
+            
+            v_Text.assign(200, 't');
+            v_Text[NetMessage::us_IDPos] = NetMessage::MSG_TEXT;
+            
+            v_GetData.assign(NetMessage::us_DataPos, NetMessage::MSG_GET_DATA);
+        }
+        
+        IntrusivePointer<NetMessage> Recieve(std::vector<uint8_t> const& v_Bytes)
+        {
+            // Stream bytes are appended to the reused recieve buffer
+            v_Recieve.clear();
+            v_Recieve.reserve(NET_MESSAGE_BUFFER_SIZE);
+            v_Recieve.insert(v_Recieve.end(), v_Bytes.begin(), v_Bytes.end());
+            
+            return MakeIntrusive<NetMessage>(v_Recieve);
+        }
+        
+        void Send()
+        {
+            IntrusivePointer<NetMessage> p_Message;
+            
+            while ((p_Message = c_Send.GetElement()) != nullptr)
+            {
+                Bench::Keep(p_Message->v_Data.size());
+            }
+        }
+        
+        void Auth()
+        {
+            IntrusivePointer<NetMessage> p_Request = Recieve(v_AuthRequest);
+            MSG_AUTH_REQUEST_DATA c_Request;
+            
+            if (ToData(p_Request->v_Data, c_Request) == false)
+            {
+                abort();
+            }
+            
+            MSG_AUTH_CHALLENGE_DATA c_Challenge;
+            memset(c_Challenge.p_Salt, 's', sizeof(c_Challenge.p_Salt));
+            c_Challenge.u32_Nonce = 42;
+            c_Challenge.u8_HashType = 1;
+            
+            c_Send.Add(MakeIntrusive<NetMessage>(ToBuffer(c_Challenge)));
+            Send();
+            
+            IntrusivePointer<NetMessage> p_Proof = Recieve(v_AuthProof);
+            MSG_AUTH_PROOF_DATA c_Proof;
+            
+            if (ToData(p_Proof->v_Data, c_Proof) == false)
+            {
+                abort();
+            }
+            
+            c_Send.Add(NetResponse::Get(NetResponse::RESPONSE_AUTH_RESULT));
+            Send();
+        }
+        
+        void Store()
+        {
+            IntrusivePointer<NetMessage> p_Text = Recieve(v_Text);
+            
+            c_Store.StoreMessage(1, s_DeviceKey, 0, p_Text->v_Data);
+        }
+        
+        void Poll()
+        {
+            IntrusivePointer<NetMessage> p_Request = Recieve(v_GetData);
+            std::vector<uint8_t> v_Message;
+            uint64_t u64_MessageID;
+            
+            if (c_Store.RetrieveMessage(1, s_DeviceKey, 0, v_Message, u64_MessageID) == false)
+            {
+                c_Send.Add(NetResponse::Get(NetResponse::RESPONSE_NO_DATA));
+                Send();
+                return;
+            }
+            
+            c_Send.Add(MakeIntrusive<NetMessage>(std::move(v_Message)));
+            Send();
+            
+            // Acknowledged on send completion
+            c_Store.AcknowledgeMessage(1, s_DeviceKey, 0, u64_MessageID);
+        }
+        
+        void Run(size_t* p_Count)
+        {
+            size_t us_Start = us_Allocation;
+            
+            Auth();
+            p_Count[STEP_AUTH] += us_Allocation - us_Start;
+            us_Start = us_Allocation;
+            
+            Store();
+            p_Count[STEP_STORE] += us_Allocation - us_Start;
+            us_Start = us_Allocation;
+            
+            Poll();
+            p_Count[STEP_POLL] += us_Allocation - us_Start;
+            us_Start = us_Allocation;
+            
+            Poll();
+            p_Count[STEP_POLL_EMPTY] += us_Allocation - us_Start;
+        }
+        
+        std::string s_DeviceKey;
+        std::vector<uint8_t> v_AuthRequest;
+        std::vector<uint8_t> v_AuthProof;
+        std::vector<uint8_t> v_Text;
+        std::vector<uint8_t> v_GetData;
+        
+        std::vector<uint8_t> v_Recieve;
+        SharedList<NetMessage, IntrusivePointer<NetMessage>> c_Send;
+        MemoryStore c_Store;
+    };
+}
+
+
+int main()
+{
+    constexpr size_t us_Warmup = 1000;
+    constexpr size_t us_Cycles = 100000;
+    constexpr size_t us_Threads = 4;
+    
+    Cycle c_Cycle;
+    size_t p_Count[Cycle::STEP_COUNT] = { 0 };
+    
+    for (size_t i = 0; i < us_Warmup; ++i)
+    {
+        c_Cycle.Run(p_Count);
+    }
+    
+    memset(p_Count, 0, sizeof(p_Count));
+    
+    for (size_t i = 0; i < us_Cycles; ++i)
+    {
+        c_Cycle.Run(p_Count);
+    }
+    
+    const char* p_Name[Cycle::STEP_COUNT] =
+    {
+        "Auth (request, challenge, proof, result)",
+        "Store (recieve text, store)",
+        "Poll (get data, retrieve, send, acknowledge)",
+        "Poll (get data, no data)"
+    };
+    size_t us_Total = 0;
+    
+    for (size_t i = 0; i < Cycle::STEP_COUNT; ++i)
+    {
+        Bench::Print(p_Name[i], static_cast<double>(p_Count[i]) / us_Cycles, "allocations/cycle");
+        us_Total += p_Count[i];
+    }
+    
+    Bench::Print("Auth + store + poll", static_cast<double>(us_Total) / us_Cycles, "allocations/cycle");
+    
+    // Created and released on several threads at once, each thread
+    // uses its own buffers
+    const std::vector<uint8_t> v_Message(200, NetMessage::MSG_TEXT);
+    
+    auto c_Start = std::chrono::steady_clock::now();
+    std::vector<std::thread> v_Thread;
+    
+    for (size_t i = 0; i < us_Threads; ++i)
+    {
+        v_Thread.emplace_back([&]()
+        {
+            for (size_t j = 0; j < us_Cycles; ++j)
+            {
+                IntrusivePointer<NetMessage> p_Message = MakeIntrusive<NetMessage>(v_Message);
+                Bench::Keep(p_Message->v_Data.size());
+            }
+        });
+    }
+    
+    for (auto& Thread : v_Thread)
+    {
+        Thread.join();
+    }
+    
+    double f64_Time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - c_Start).count();
+    
+    Bench::Print("Create + release, " + std::to_string(us_Threads) + " threads",
+                 f64_Time / us_Cycles,
+                 "ns/message per thread");
+    
+    return 0;
+}
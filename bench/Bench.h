@@ -0,0 +1,205 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef Bench_h
+#define Bench_h
+
+// C / C++
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <string>
+#ifdef __linux__
+    #include <unistd.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <linux/perf_event.h>
+#endif
+
+// External
+
+// Project
+
+
+// @NOTE: Benchmarks print one line per measurement, the best of
+//        several runs is reported to hide scheduling noise.
+namespace Bench
+{
+    //*************************************************************************************
+    // Optimization
+    //*************************************************************************************
+    
+    /**
+     *  Keep a value alive for the compiler, results of measured
+     *  code are otherwise removed.
+     *
+     *  \param Value The value to keep.
+     */
+    
+    template <typename T> inline void Keep(T const& Value) noexcept
+    {
+        asm volatile("" : : "g"(&Value) : "memory");
+    }
+    
+    //*************************************************************************************
+    // Measure
+    //*************************************************************************************
+    
+    /**
+     *  Measure a function.
+     *
+     *  \param s_Name The name to print.
+     *  \param us_Iterations The calls per run.
+     *  \param c_Function The function to call.
+     *
+     *  \return The best time per call in nanoseconds.
+     */
+    
+    template <typename Function> double Measure(std::string const& s_Name, size_t us_Iterations, Function&& c_Function)
+    {
+        constexpr size_t us_Runs = 5;
+        double f64_Best = 0.0;
+        
+        // First run warms caches and is not counted
+        for (size_t i = 0; i <= us_Runs; ++i)
+        {
+            auto c_Start = std::chrono::steady_clock::now();
+            
+            for (size_t j = 0; j < us_Iterations; ++j)
+            {
+                c_Function();
+            }
+            
+            double f64_Time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - c_Start).count() / us_Iterations;
+            
+            if (i == 1 || (i > 1 && f64_Time < f64_Best))
+            {
+                f64_Best = f64_Time;
+            }
+        }
+        
+        printf("%-48s %12.1f ns/op\n", s_Name.c_str(), f64_Best);
+        
+        return f64_Best;
+    }
+    
+    /**
+     *  Print a counted value.
+     *
+     *  \param s_Name The name to print.
+     *  \param f64_Value The value to print.
+     *  \param p_Unit The unit of the value.
+     */
+    
+    inline void Print(std::string const& s_Name, double f64_Value, const char* p_Unit) noexcept
+    {
+        printf("%-48s %12.1f %s\n", s_Name.c_str(), f64_Value, p_Unit);
+    }
+    
+    //*************************************************************************************
+    // Counter
+    //*************************************************************************************
+    
+    // @NOTE: Hardware counters are read with perf_event_open, systems
+    //        without a PMU (most virtual machines) report them missing.
+    class Counter
+    {
+    public:
+        
+        /**
+         *  Default constructor.
+         *
+         *  \param u64_Config The PERF_COUNT_HW_* event to count.
+         */
+        
+        Counter(uint64_t u64_Config) noexcept : i_FD(-1)
+        {
+#ifdef __linux__
+            perf_event_attr c_Attr;
+            memset(&c_Attr, 0, sizeof(c_Attr));
+            
+            c_Attr.type = PERF_TYPE_HARDWARE;
+            c_Attr.size = sizeof(c_Attr);
+            c_Attr.config = u64_Config;
+            c_Attr.disabled = 1;
+            c_Attr.exclude_kernel = 1;
+            c_Attr.exclude_hv = 1;
+            
+            i_FD = static_cast<int>(syscall(SYS_perf_event_open, &c_Attr, 0, -1, -1, 0));
+#endif
+        }
+        
+        /**
+         *  Default destructor.
+         */
+        
+        ~Counter() noexcept
+        {
+#ifdef __linux__
+            if (i_FD >= 0)
+            {
+                close(i_FD);
+            }
+#endif
+        }
+        
+        /**
+         *  Reset and start counting.
+         */
+        
+        void Start() noexcept
+        {
+#ifdef __linux__
+            if (i_FD >= 0)
+            {
+                ioctl(i_FD, PERF_EVENT_IOC_RESET, 0);
+                ioctl(i_FD, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+        
+        /**
+         *  Stop counting.
+         *
+         *  \return The counted events, -1 if the counter is unavailable.
+         */
+        
+        double Stop() noexcept
+        {
+#ifdef __linux__
+            uint64_t u64_Count;
+            
+            if (i_FD >= 0)
+            {
+                ioctl(i_FD, PERF_EVENT_IOC_DISABLE, 0);
+                
+                if (read(i_FD, &u64_Count, sizeof(u64_Count)) == sizeof(u64_Count))
+                {
+                    return static_cast<double>(u64_Count);
+                }
+            }
+#endif
+            return -1.0;
+        }
+        
+    private:
+        
+        int i_FD;
+    };
+}
+
+#endif /* Bench_h */
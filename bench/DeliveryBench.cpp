@@ -0,0 +1,173 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <thread>
+#include <deque>
+#include <vector>
+
+// External
+
+// Project
+#include "../src/Server/DirectQueue.h"
+#include "../src/Server/SendTracker.h"
+#include "../src/Server/NotificationWindow.h"
+#include "../src/Database/Memory/MemoryStore.h"
+#include "./Bench.h"
+
+
+namespace
+{
+    //*************************************************************************************
+    // Recipient
+    //*************************************************************************************
+    
+    constexpr uint32_t u32_UserID = 1;
+    const std::string s_DeviceKey = "device";
+    constexpr uint8_t u8_ActorType = 0;
+    
+    //*************************************************************************************
+    // Delivery
+    //*************************************************************************************
+    
+    // @NOTE: Online recipients queue, send and finish the send,
+    //        offline ones store, retrieve and acknowledge.
+    void Online(DirectQueue& c_Direct, SendTracker& c_Tracker, std::vector<uint8_t> const& v_Message, uint64_t& u64_SendID)
+    {
+        std::deque<NetMessage> dq_Send;
+        std::vector<SendTracker::Result> v_Result;
+        std::vector<uint64_t> v_Expired;
+        
+        c_Direct.Add(NetMessage(v_Message));
+        c_Direct.Take(dq_Send);
+        
+        for (auto& Send : dq_Send)
+        {
+            SendTracker::Send& c_Tracked = c_Tracker.Add(++u64_SendID);
+            c_Tracked.v_Data = Send.v_Data;
+            c_Tracker.Complete(u64_SendID, true);
+        }
+        
+        c_Tracker.Update(std::chrono::steady_clock::now(), v_Result, v_Expired);
+        Bench::Keep(v_Result);
+    }
+    
+    void Offline(MemoryStore& c_Store, std::vector<uint8_t> const& v_Message)
+    {
+        std::vector<uint8_t> v_Retrieved;
+        uint64_t u64_MessageID;
+        
+        c_Store.StoreMessage(u32_UserID, s_DeviceKey, u8_ActorType, v_Message);
+        
+        if (c_Store.RetrieveMessage(u32_UserID, s_DeviceKey, u8_ActorType, v_Retrieved, u64_MessageID) == true)
+        {
+            c_Store.AcknowledgeMessage(u32_UserID, s_DeviceKey, u8_ActorType, u64_MessageID);
+        }
+        
+        Bench::Keep(v_Retrieved);
+    }
+    
+    //*************************************************************************************
+    // Notification
+    //*************************************************************************************
+    
+    // A burst of notifications, each forwarded and read by the recipient
+    size_t Forwarded(MemoryStore& c_Store, std::vector<uint8_t> const& v_Notification, size_t us_Burst)
+    {
+        for (size_t i = 0; i < us_Burst; ++i)
+        {
+            Offline(c_Store, v_Notification);
+        }
+        
+        return us_Burst;
+    }
+    
+    // The same burst within one window, the newest is forwarded once
+    size_t Coalesced(MemoryStore& c_Store, NotificationWindow& c_Window, std::vector<uint8_t> const& v_Notification, size_t us_Burst)
+    {
+        auto c_Time = std::chrono::steady_clock::now();
+        std::vector<uint8_t> v_Forward;
+        
+        for (size_t i = 0; i < us_Burst; ++i)
+        {
+            c_Window.Add(v_Notification, c_Time);
+        }
+        
+        if (c_Window.Take(c_Time, v_Forward) == false)
+        {
+            return 0;
+        }
+        
+        Offline(c_Store, v_Forward);
+        
+        return 1;
+    }
+}
+
+int main()
+{
+    constexpr size_t us_Iterations = 100000;
+    constexpr size_t us_Burst = 100;
+    
+    std::thread([](){}).join();
+    
+    std::vector<uint8_t> v_Message(256, 0);
+    v_Message[NetMessage::us_IDPos] = NetMessage::MSG_TEXT;
+    
+    std::vector<uint8_t> v_Notification(128, 0);
+    v_Notification[NetMessage::us_IDPos] = NetMessage::MSG_NOTIFICATION;
+    
+    // Delivery latency
+    DirectQueue c_Direct;
+    SendTracker c_Tracker;
+    MemoryStore c_Store;
+    uint64_t u64_SendID = 0;
+    
+    c_Direct.SetDrained(c_Direct.GetGeneration());
+    
+    double f64_Online = Bench::Measure("Deliver (online, direct)", us_Iterations, [&]()
+    {
+        Online(c_Direct, c_Tracker, v_Message, u64_SendID);
+    });
+    double f64_Offline = Bench::Measure("Deliver (offline, store + retrieve + ack)", us_Iterations, [&]()
+    {
+        Offline(c_Store, v_Message);
+    });
+    
+    Bench::Print("Offline / online", f64_Offline / f64_Online, "x");
+    
+    // Notification burst throughput
+    NotificationWindow c_Window;
+    size_t us_Stored = 0;
+    
+    double f64_Forwarded = Bench::Measure("Notification burst of 100 (forward each)", us_Iterations / us_Burst, [&]()
+    {
+        us_Stored = Forwarded(c_Store, v_Notification, us_Burst);
+    });
+    
+    Bench::Print("Notifications stored per burst (forward each)", static_cast<double>(us_Stored), "msg");
+    
+    double f64_Coalesced = Bench::Measure("Notification burst of 100 (coalesced)", us_Iterations / us_Burst, [&]()
+    {
+        us_Stored = Coalesced(c_Store, c_Window, v_Notification, us_Burst);
+    });
+    
+    Bench::Print("Notifications stored per burst (coalesced)", static_cast<double>(us_Stored), "msg");
+    Bench::Print("Burst throughput (forward each)", us_Burst * 1e9 / f64_Forwarded, "msg/s");
+    Bench::Print("Burst throughput (coalesced)", us_Burst * 1e9 / f64_Coalesced, "msg/s");
+    
+    return 0;
+}
@@ -0,0 +1,228 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <cstring>
+#include <vector>
+#ifdef __APPLE__
+    #include <libkern/OSByteOrder.h>
+#else
+    #include <byteswap.h>
+#endif
+
+// External
+
+// Project
+#include "../src/NetMessage/Ver/NetMessageV1.h"
+#include "./Bench.h"
+
+// Pre-defined
+#define IS_BIG_ENDIAN (*(uint16_t *)"\0\xff" < 0x100)
+#ifdef __APPLE__
+    #define bswap_32(x) OSSwapInt32(x)
+    #define bswap_64(x) OSSwapInt64(x)
+#endif
+
+using namespace NetMessageV1;
+
+// @NOTE: The hand-written parsing and serialization replaced by
+//        the compile-time layouts, kept as reference. Not inlined,
+//        the layout versions are called from their own file too.
+namespace HandWritten
+{
+    constexpr size_t us_MsgAckRangeSize = us_SizeMessageID + us_SizeMessageID;
+    constexpr size_t us_MsgAuthChallengeSize = NetMessage::us_DataPos +
+                                               us_SizeAccountPasswordSalt +
+                                               sizeof(uint32_t) +
+                                               sizeof(uint8_t);
+    
+    uint64_t ToLittleEndian(uint64_t u64_Value) noexcept
+    {
+        return IS_BIG_ENDIAN ? bswap_64(u64_Value) : u64_Value;
+    }
+    
+    __attribute__((noinline)) MSG_AUTH_REQUEST_DATA ToAuthRequest(std::vector<uint8_t> const& v_Buffer)
+    {
+        if (v_Buffer.size() != us_SizeMsgAuthRequest)
+        {
+            throw Exception("Invalid data buffer!");
+        }
+        
+        MSG_AUTH_REQUEST_DATA c_Data;
+        size_t us_Pos = NetMessage::us_IDPos + NetMessage::us_IDSize;
+        
+        c_Data.c_Mail = BufferRef(v_Buffer,
+                                  us_Pos,
+                                  us_SizeAccountMail);
+        us_Pos += us_SizeAccountMail;
+        
+        c_Data.c_DeviceKey = BufferRef(v_Buffer,
+                                       us_Pos,
+                                       us_SizeDeviceKey);
+        us_Pos += us_SizeDeviceKey;
+        
+        c_Data.u8_ClientType = v_Buffer[us_Pos];
+        us_Pos += 1;
+        
+        c_Data.u8_Version = v_Buffer[us_Pos];
+        
+        return c_Data;
+    }
+    
+    __attribute__((noinline)) MSG_ACK_DATA ToAck(std::vector<uint8_t> const& v_Buffer)
+    {
+        size_t us_Pos = NetMessage::us_IDPos + NetMessage::us_IDSize;
+        
+        if (v_Buffer.size() <= us_Pos ||
+            (v_Buffer.size() - us_Pos) % us_MsgAckRangeSize != 0 ||
+            (v_Buffer.size() - us_Pos) / us_MsgAckRangeSize > us_SizeAckRangeMax)
+        {
+            throw Exception("Invalid data buffer!");
+        }
+        
+        MSG_ACK_DATA c_Data;
+        uint64_t u64_First;
+        uint64_t u64_Last;
+        
+        while (us_Pos < v_Buffer.size())
+        {
+            memcpy(&u64_First,
+                   &(v_Buffer[us_Pos]),
+                   us_SizeMessageID);
+            us_Pos += us_SizeMessageID;
+            
+            memcpy(&u64_Last,
+                   &(v_Buffer[us_Pos]),
+                   us_SizeMessageID);
+            us_Pos += us_SizeMessageID;
+            
+            u64_First = ToLittleEndian(u64_First);
+            u64_Last = ToLittleEndian(u64_Last);
+            
+            if (u64_First > u64_Last)
+            {
+                throw Exception("Invalid acknowledgement range!");
+            }
+            
+            c_Data.v_Range.emplace_back(u64_First, u64_Last);
+        }
+        
+        return c_Data;
+    }
+    
+    __attribute__((noinline)) std::vector<uint8_t> ToBuffer(MSG_AUTH_CHALLENGE_DATA const& Data)
+    {
+        std::vector<uint8_t> v_Buffer(us_MsgAuthChallengeSize, '\0');
+        size_t us_Pos = NetMessage::us_IDPos;
+        
+        v_Buffer[NetMessage::us_IDPos] = NetMessage::MSG_AUTH_CHALLENGE;
+        us_Pos += NetMessage::us_IDSize;
+        
+        memcpy(&(v_Buffer[us_Pos]),
+               &(Data.p_Salt[0]),
+               us_SizeAccountPasswordSalt);
+        us_Pos += us_SizeAccountPasswordSalt;
+        
+        if (IS_BIG_ENDIAN)
+        {
+            uint32_t u32_Nonce = bswap_32(Data.u32_Nonce);
+            
+            memcpy(&(v_Buffer[us_Pos]),
+                   &u32_Nonce,
+                   sizeof(u32_Nonce));
+        }
+        else
+        {
+            memcpy(&(v_Buffer[us_Pos]),
+                   &(Data.u32_Nonce),
+                   sizeof(Data.u32_Nonce));
+        }
+        
+        us_Pos += sizeof(Data.u32_Nonce);
+        
+        v_Buffer[us_Pos] = Data.u8_HashType;
+        
+        return v_Buffer;
+    }
+}
+
+
+int main()
+{
+    constexpr size_t us_Iterations = 2000000;
+    
+    std::vector<uint8_t> v_AuthRequest(us_SizeMsgAuthRequest, 'a');
+    v_AuthRequest[NetMessage::us_IDPos] = NetMessage::MSG_AUTH_REQUEST;
+    
+    std::vector<uint8_t> v_Ack(NetMessage::us_DataPos, NetMessage::MSG_ACK);
+    
+    for (uint64_t i = 0; i < 8; ++i)
+    {
+        uint64_t u64_Range[2] = { i * 10, i * 10 + 5 };
+        const uint8_t* p_Range = reinterpret_cast<const uint8_t*>(u64_Range);
+        
+        v_Ack.insert(v_Ack.end(), p_Range, p_Range + sizeof(u64_Range));
+    }
+    
+    MSG_AUTH_CHALLENGE_DATA c_Challenge;
+    memset(c_Challenge.p_Salt, 's', sizeof(c_Challenge.p_Salt));
+    c_Challenge.u32_Nonce = 0x01020304;
+    c_Challenge.u8_HashType = 1;
+    
+    // Both versions have to produce the same wire data
+    if (HandWritten::ToBuffer(c_Challenge) != NetMessageV1::ToBuffer(c_Challenge))
+    {
+        printf("MSG_AUTH_CHALLENGE mismatch!\n");
+        return -1;
+    }
+    
+    // Parsed data is written to the same object by both versions
+    MSG_AUTH_REQUEST_DATA c_AuthRequest;
+    MSG_ACK_DATA c_Ack;
+    
+    Bench::Measure("MSG_AUTH_REQUEST parse, hand-written", us_Iterations, [&]()
+    {
+        c_AuthRequest = HandWritten::ToAuthRequest(v_AuthRequest);
+        Bench::Keep(c_AuthRequest);
+    });
+    Bench::Measure("MSG_AUTH_REQUEST parse, layout", us_Iterations, [&]()
+    {
+        Bench::Keep(NetMessageV1::ToData(v_AuthRequest, c_AuthRequest));
+        Bench::Keep(c_AuthRequest);
+    });
+    
+    Bench::Measure("MSG_ACK parse (8 ranges), hand-written", us_Iterations, [&]()
+    {
+        c_Ack = HandWritten::ToAck(v_Ack);
+        Bench::Keep(c_Ack);
+    });
+    Bench::Measure("MSG_ACK parse (8 ranges), layout", us_Iterations, [&]()
+    {
+        Bench::Keep(NetMessageV1::ToData(v_Ack, c_Ack));
+        Bench::Keep(c_Ack);
+    });
+    
+    Bench::Measure("MSG_AUTH_CHALLENGE serialize, hand-written", us_Iterations, [&]()
+    {
+        Bench::Keep(HandWritten::ToBuffer(c_Challenge));
+    });
+    Bench::Measure("MSG_AUTH_CHALLENGE serialize, layout", us_Iterations, [&]()
+    {
+        Bench::Keep(NetMessageV1::ToBuffer(c_Challenge));
+    });
+    
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// External
+
+// Project
+#include "../src/Database/Log/LogStore.h"
+#include "./Bench.h"
+
+
+namespace
+{
+    //*************************************************************************************
+    // Directory
+    //*************************************************************************************
+    
+    /**
+     *  Create a empty log directory.
+     *
+     *  \return The full directory path.
+     */
+    
+    std::string CreateDirectory()
+    {
+        const char* p_Base = access("/dev/shm", W_OK) == 0 ? "/dev/shm" : "/tmp";
+        std::string s_Path = std::string(p_Base) + "/mrhnetserver_bench_log_XXXXXX";
+        
+        if (mkdtemp(&(s_Path[0])) == NULL)
+        {
+            fprintf(stderr, "Failed to create %s!\n", s_Path.c_str());
+            exit(-1);
+        }
+        
+        return s_Path;
+    }
+    
+    //*************************************************************************************
+    // Read
+    //*************************************************************************************
+    
+    /**
+     *  Measure claiming messages of a inbox.
+     *
+     *  \param s_Name The name to print.
+     *  \param us_Messages The messages to read.
+     *  \param us_Backlog The messages stored before reading, 1 reads at the tail.
+     */
+    
+    void Read(std::string const& s_Name, size_t us_Messages, size_t us_Backlog)
+    {
+        constexpr size_t us_Runs = 5;
+        
+        std::string s_Directory = CreateDirectory();
+        std::vector<uint8_t> v_Message(257, 0x42);
+        std::vector<uint8_t> v_Read;
+        uint64_t u64_MessageID;
+        double f64_Best = 0.0;
+        
+        v_Message[NetMessage::us_IDPos] = NetMessage::MSG_TEXT;
+        
+        {
+            // Every write synced, only the read is timed
+            LogStore c_Store(s_Directory, 0);
+            
+            for (size_t i = 0; i < us_Runs; ++i)
+            {
+                double f64_Total = 0.0;
+                
+                for (size_t us_Read = 0; us_Read < us_Messages; us_Read += us_Backlog)
+                {
+                    for (size_t j = 0; j < us_Backlog; ++j)
+                    {
+                        c_Store.StoreMessage(1, "bench", 0, v_Message);
+                    }
+                    
+                    auto c_Start = std::chrono::steady_clock::now();
+                    
+                    for (size_t j = 0; j < us_Backlog; ++j)
+                    {
+                        if (c_Store.RetrieveMessage(1, "bench", 0, v_Read, u64_MessageID) == false)
+                        {
+                            fprintf(stderr, "%s: message missing!\n", s_Name.c_str());
+                            exit(-1);
+                        }
+                        
+                        c_Store.AcknowledgeMessage(1, "bench", 0, u64_MessageID);
+                    }
+                    
+                    f64_Total += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - c_Start).count();
+                }
+                
+                if (i == 0 || f64_Total / us_Messages < f64_Best)
+                {
+                    f64_Best = f64_Total / us_Messages;
+                }
+            }
+        }
+        
+        Bench::Print(s_Name, f64_Best, "ns/op");
+        
+        std::string s_Remove = "rm -rf '" + s_Directory + "'";
+        
+        if (system(s_Remove.c_str()) != 0)
+        {
+            fprintf(stderr, "Failed to remove %s!\n", s_Directory.c_str());
+        }
+    }
+}
+
+// @NOTE: A live inbox is read right after each store, a backlog
+//        is read in one go from the same mapping.
+int main()
+{
+    constexpr size_t us_Messages = 10000;
+    
+    std::thread([](){}).join();
+    
+    Read("Retrieve + acknowledge (live tail)", us_Messages, 1);
+    Read("Retrieve + acknowledge (backlog of 100)", us_Messages, 100);
+    
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <cstring>
+#include <string>
+#include <vector>
+
+// External
+
+// Project
+#include "../src/NetMessage/Ver/NetMessageV1.h"
+#include "./Bench.h"
+
+using namespace NetMessageV1;
+
+
+// @NOTE: The previous parse path threw on invalid data and the client
+//        caught the exception and built a log string. Emulated here
+//        with the current parser, the log string is built but not
+//        written to keep file I/O out of the measurement.
+namespace Throwing
+{
+    template <typename T> __attribute__((noinline)) T ToData(std::vector<uint8_t> const& v_Buffer)
+    {
+        T Data;
+        
+        if (NetMessageV1::ToData(v_Buffer, Data) == false)
+        {
+            throw Exception("Invalid data buffer!");
+        }
+        
+        return Data;
+    }
+    
+    template <typename T> __attribute__((noinline)) bool Perform(std::vector<uint8_t> const& v_Buffer, std::string& s_Log)
+    {
+        try
+        {
+            Bench::Keep(ToData<T>(v_Buffer));
+            return true;
+        }
+        catch (std::exception& e)
+        {
+            s_Log = "(Client ID: " +
+                    std::to_string(42) +
+                    ", User ID " +
+                    std::to_string(1337) +
+                    "): Failed to process recieved net message: " +
+                    e.what();
+            return false;
+        }
+    }
+}
+
+namespace Result
+{
+    template <typename T> __attribute__((noinline)) bool Perform(std::vector<uint8_t> const& v_Buffer, size_t& us_Exceptions)
+    {
+        try
+        {
+            T Data;
+            
+            if (ToData(v_Buffer, Data) == false)
+            {
+                // Disconnect
+                return false;
+            }
+            
+            Bench::Keep(Data);
+            return true;
+        }
+        catch (...)
+        {
+            ++us_Exceptions;
+            return false;
+        }
+    }
+}
+
+
+int main()
+{
+    constexpr size_t us_Iterations = 500000;
+    
+    // Wrong size auth request, one byte short
+    std::vector<uint8_t> v_AuthRequest(us_SizeMsgAuthRequest - 1, 'a');
+    v_AuthRequest[NetMessage::us_IDPos] = NetMessage::MSG_AUTH_REQUEST;
+    
+    // Acknowledgement with first > last
+    uint64_t u64_Range[2] = { 10, 5 };
+    std::vector<uint8_t> v_Ack(NetMessage::us_DataPos + sizeof(u64_Range), NetMessage::MSG_ACK);
+    memcpy(&(v_Ack[NetMessage::us_DataPos]), u64_Range, sizeof(u64_Range));
+    
+    std::string s_Log;
+    size_t us_Exceptions = 0;
+    size_t us_Rejected = 0;
+    
+    Bench::Measure("MSG_AUTH_REQUEST malformed, throw + catch", us_Iterations, [&]()
+    {
+        Throwing::Perform<MSG_AUTH_REQUEST_DATA>(v_AuthRequest, s_Log);
+        Bench::Keep(s_Log);
+    });
+    Bench::Measure("MSG_AUTH_REQUEST malformed, result", us_Iterations, [&]()
+    {
+        us_Rejected += Result::Perform<MSG_AUTH_REQUEST_DATA>(v_AuthRequest, us_Exceptions) ? 0 : 1;
+    });
+    Bench::Measure("MSG_ACK inverted range, throw + catch", us_Iterations, [&]()
+    {
+        Throwing::Perform<MSG_ACK_DATA>(v_Ack, s_Log);
+        Bench::Keep(s_Log);
+    });
+    Bench::Measure("MSG_ACK inverted range, result", us_Iterations, [&]()
+    {
+        us_Rejected += Result::Perform<MSG_ACK_DATA>(v_Ack, us_Exceptions) ? 0 : 1;
+    });
+    
+    // Every malformed message is rejected without unwinding
+    Bench::Print("Rejected, result", static_cast<double>(us_Rejected), "messages");
+    Bench::Print("Exceptions caught, result", static_cast<double>(us_Exceptions), "exceptions");
+    
+    return us_Exceptions == 0 ? 0 : -1;
+}
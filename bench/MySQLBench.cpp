@@ -0,0 +1,286 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <cstdlib>
+#include <vector>
+
+// External
+#include <mysqlx/xdevapi.h>
+
+// Project
+#include "../src/Database/MySQL/MySQLStore.h"
+#include "./Bench.h"
+
+using namespace DatabaseTable;
+using namespace mysqlx;
+
+
+namespace
+{
+    //*************************************************************************************
+    // Environment
+    //*************************************************************************************
+    
+    /**
+     *  Get a connection setting.
+     *
+     *  \param p_Name The environment variable name.
+     *  \param p_Default The value to use if unset.
+     *
+     *  \return The setting value.
+     */
+    
+    std::string GetSetting(const char* p_Name, const char* p_Default)
+    {
+        const char* p_Value = getenv(p_Name);
+        
+        return p_Value != NULL ? p_Value : p_Default;
+    }
+    
+    //*************************************************************************************
+    // Inbox
+    //*************************************************************************************
+    
+    // @NOTE: Both workloads read one inbox, the messages are stored
+    //        before each run and not part of the measured time.
+    class Inbox
+    {
+    public:
+        
+        Inbox(MySQLStore& c_Store,
+              Session& c_Session,
+              std::string const& s_Database) : c_Store(c_Store),
+                                               c_Session(c_Session),
+                                               s_Database(s_Database),
+                                               s_DeviceKey("bench"),
+                                               u8_ActorType(0),
+                                               v_Message(257, 0x42)
+        {
+            std::string s_Mail = "bench@mrh.invalid";
+            std::string s_Password;
+            
+            if (c_Store.GetAccount(s_Mail, u32_UserID, s_Password) == false)
+            {
+                c_Store.CreateAccount(s_Mail, "bench");
+                c_Store.GetAccount(s_Mail, u32_UserID, s_Password);
+            }
+            
+            v_Message[0] = NetMessage::MSG_TEXT;
+            Clear();
+        }
+        
+        ~Inbox() noexcept
+        {
+            try
+            {
+                Clear();
+                c_Store.RemoveAccount(u32_UserID);
+            }
+            catch (...)
+            {}
+        }
+        
+        void Clear()
+        {
+            Table c_Data = c_Session.getSchema(s_Database).getTable(p_MDTableName);
+            Table c_Cursor = c_Session.getSchema(s_Database).getTable(p_MCTableName);
+            
+            c_Data.remove()
+                .where(std::string(p_MDFieldName[MD_USER_ID]) +
+                       " == :value")
+                .bind("value",
+                      u32_UserID)
+                .execute();
+            c_Cursor.remove()
+                .where(std::string(p_MCFieldName[MC_USER_ID]) +
+                       " == :value")
+                .bind("value",
+                      u32_UserID)
+                .execute();
+        }
+        
+        void Fill(size_t us_Count)
+        {
+            for (size_t i = 0; i < us_Count; ++i)
+            {
+                c_Store.StoreMessage(u32_UserID, s_DeviceKey, u8_ActorType, v_Message);
+            }
+        }
+        
+        // Claim and remove each message on read, one transaction each
+        size_t ReadDelete()
+        {
+            Table c_Data = c_Session.getSchema(s_Database).getTable(p_MDTableName);
+            size_t us_Read = 0;
+            
+            while (true)
+            {
+                c_Session.startTransaction();
+                
+                RowResult c_Result = c_Data
+                                        .select(p_MDFieldName[MD_MESSAGE_ID],      /* 0 */
+                                                p_MDFieldName[MD_MESSAGE_TYPE],    /* 1 */
+                                                p_MDFieldName[MD_MESSAGE_DATA])    /* 2 */
+                                        .where(std::string(p_MDFieldName[MD_USER_ID]) +
+                                               " == :valueA AND " +
+                                               p_MDFieldName[MD_DEVICE_KEY] +
+                                               " == :valueB AND " +
+                                               p_MDFieldName[MD_ACTOR_TYPE] +
+                                               " == :valueC")
+                                        .orderBy(p_MDFieldName[MD_MESSAGE_ID])
+                                        .limit(1)
+                                        .lockExclusive(LockContention::SKIP_LOCKED)
+                                        .bind("valueA",
+                                              u32_UserID)
+                                        .bind("valueB",
+                                              s_DeviceKey)
+                                        .bind("valueC",
+                                              u8_ActorType)
+                                        .execute();
+                
+                if (c_Result.count() == 0)
+                {
+                    c_Session.commit();
+                    return us_Read;
+                }
+                
+                Row c_Row = c_Result.fetchOne();
+                Bench::Keep(c_Row[2].get<bytes>().size());
+                
+                c_Data.remove()
+                    .where(std::string(p_MDFieldName[MD_MESSAGE_ID]) +
+                           " == :value")
+                    .bind("value",
+                          c_Row[0].get<uint64_t>())
+                    .execute();
+                
+                c_Session.commit();
+                ++us_Read;
+            }
+        }
+        
+        // Claim with the cursor store, acknowledge, purge afterwards
+        size_t ReadCursor(size_t us_PurgeLimit)
+        {
+            std::vector<uint8_t> v_Read;
+            uint64_t u64_MessageID;
+            size_t us_Read = 0;
+            
+            while (c_Store.RetrieveMessage(u32_UserID, s_DeviceKey, u8_ActorType, v_Read, u64_MessageID) == true)
+            {
+                c_Store.AcknowledgeMessage(u32_UserID, s_DeviceKey, u8_ActorType, u64_MessageID);
+                ++us_Read;
+            }
+            
+            while (c_Store.PurgeMessages(us_PurgeLimit) > 0)
+            {}
+            
+            return us_Read;
+        }
+        
+    private:
+        
+        MySQLStore& c_Store;
+        Session& c_Session;
+        std::string s_Database;
+        
+        uint32_t u32_UserID;
+        std::string s_DeviceKey;
+        uint8_t u8_ActorType;
+        std::vector<uint8_t> v_Message;
+    };
+    
+    //*************************************************************************************
+    // Measure
+    //*************************************************************************************
+    
+    /**
+     *  Measure the read throughput of a workload.
+     *
+     *  \param s_Name The name to print.
+     *  \param c_Inbox The inbox to read.
+     *  \param us_Count The messages stored per run.
+     *  \param c_Function The read function, returns the messages read.
+     */
+    
+    template <typename Function> void Throughput(std::string const& s_Name, Inbox& c_Inbox, size_t us_Count, Function&& c_Function)
+    {
+        constexpr size_t us_Runs = 3;
+        double f64_Best = 0.0;
+        
+        for (size_t i = 0; i < us_Runs; ++i)
+        {
+            c_Inbox.Clear();
+            c_Inbox.Fill(us_Count);
+            
+            auto c_Start = std::chrono::steady_clock::now();
+            size_t us_Read = c_Function();
+            double f64_Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - c_Start).count();
+            
+            if (us_Read != us_Count)
+            {
+                fprintf(stderr, "%s: read %zu of %zu messages!\n", s_Name.c_str(), us_Read, us_Count);
+                exit(-1);
+            }
+            
+            if (us_Read / f64_Seconds > f64_Best)
+            {
+                f64_Best = us_Read / f64_Seconds;
+            }
+        }
+        
+        Bench::Print(s_Name, f64_Best, "msg/s");
+    }
+}
+
+// @NOTE: Needs a server with the schema of sql/build_db.sql, the
+//        connection is read from MRH_BENCH_MYSQL_* variables.
+int main()
+{
+    constexpr size_t us_Messages = 2000;
+    constexpr size_t us_PurgeLimit = 1000;
+    
+    std::string s_Address = GetSetting("MRH_BENCH_MYSQL_ADDRESS", "127.0.0.1");
+    int i_Port = std::stoi(GetSetting("MRH_BENCH_MYSQL_PORT", "33060"));
+    std::string s_User = GetSetting("MRH_BENCH_MYSQL_USER", "root");
+    std::string s_Password = GetSetting("MRH_BENCH_MYSQL_PASSWORD", "");
+    std::string s_Database = GetSetting("MRH_BENCH_MYSQL_DATABASE", "mrhnetserver");
+    
+    try
+    {
+        MySQLStore c_Store(s_Address, i_Port, s_User, s_Password, s_Database);
+        Session c_Session(s_Address, i_Port, s_User, s_Password);
+        Inbox c_Inbox(c_Store, c_Session, s_Database);
+        
+        Throughput("Delete on read (claim, delete)", c_Inbox, us_Messages, [&]()
+        {
+            return c_Inbox.ReadDelete();
+        });
+        
+        Throughput("Cursor (claim, acknowledge, purge)", c_Inbox, us_Messages, [&]()
+        {
+            return c_Inbox.ReadCursor(us_PurgeLimit);
+        });
+    }
+    catch (std::exception& e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        return -1;
+    }
+    
+    return 0;
+}
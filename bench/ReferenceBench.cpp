@@ -0,0 +1,165 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <vector>
+
+// External
+
+// Project
+#include "../src/NetMessage/NetMessage.h"
+#include "../src/Job/JobList.h"
+#include "./Bench.h"
+
+
+namespace
+{
+    //*************************************************************************************
+    // Client
+    //*************************************************************************************
+    
+    // @NOTE: Stands in for a client, performing only touches the object.
+    class BenchJob : public Job
+    {
+    public:
+        
+        BenchJob() noexcept : u64_Performed(0)
+        {}
+        
+        bool Perform(std::shared_ptr<ThreadShared>& p_Shared) noexcept override
+        {
+            ++u64_Performed;
+            return true;
+        }
+        
+        uint64_t u64_Performed;
+    };
+    
+    // A client pool member, looked up for each event
+    template <typename Pointer> struct Member
+    {
+        std::mutex c_Mutex;
+        Pointer p_Client;
+    };
+    
+    template <typename Pointer, typename List> void ClientEvent(Member<Pointer>& c_Member, List& c_List, std::shared_ptr<ThreadShared>& p_Shared)
+    {
+        c_Member.c_Mutex.lock();
+        Pointer p_Client = c_Member.p_Client;
+        c_Member.c_Mutex.unlock();
+        
+        c_List.Add(std::move(p_Client));
+        
+        Pointer p_Job = c_List.GetElement();
+        p_Job->Perform(p_Shared);
+    }
+    
+    //*************************************************************************************
+    // Message
+    //*************************************************************************************
+    
+    template <typename Pointer, typename List> void MessageEvent(Pointer p_Message, List& c_List)
+    {
+        c_List.Add(std::move(p_Message));
+        
+        Pointer p_Send = c_List.GetElement();
+        Bench::Keep(p_Send->v_Data.size());
+    }
+    
+    //*************************************************************************************
+    // Run
+    //*************************************************************************************
+    
+    template <typename Function> void Run(std::string const& s_Name, size_t us_Iterations, Function&& c_Function)
+    {
+        Bench::Counter c_Miss(PERF_COUNT_HW_CACHE_MISSES);
+        Bench::Counter c_Instruction(PERF_COUNT_HW_INSTRUCTIONS);
+        
+        Bench::Measure(s_Name, us_Iterations, c_Function);
+        
+        c_Miss.Start();
+        c_Instruction.Start();
+        
+        for (size_t i = 0; i < us_Iterations; ++i)
+        {
+            c_Function();
+        }
+        
+        double f64_Instruction = c_Instruction.Stop();
+        double f64_Miss = c_Miss.Stop();
+        
+        if (f64_Miss < 0.0 || f64_Instruction < 0.0)
+        {
+            printf("%-48s %12s\n", "  hardware counters", "unavailable");
+            return;
+        }
+        
+        Bench::Print("  cache misses", f64_Miss / us_Iterations, "per event");
+        Bench::Print("  instructions", f64_Instruction / us_Iterations, "per event");
+    }
+}
+
+
+int main()
+{
+    constexpr size_t us_Iterations = 2000000;
+    
+    // @NOTE: The standard library skips atomic shared_ptr counting while
+    //        the process has one thread, the server always has several.
+    std::thread([]() {}).join();
+    
+    std::shared_ptr<ThreadShared> p_Shared;
+    
+    // Clients, copied from the pool member and moved through the job list
+    Member<std::shared_ptr<Job>> c_SharedMember;
+    c_SharedMember.p_Client = std::make_shared<BenchJob>();
+    SharedList<Job> c_SharedJobList;
+    
+    Member<IntrusivePointer<Job>> c_IntrusiveMember;
+    c_IntrusiveMember.p_Client = MakeIntrusive<BenchJob>();
+    SharedList<Job, IntrusivePointer<Job>> c_IntrusiveJobList;
+    
+    Run("Client event, shared_ptr", us_Iterations, [&]()
+    {
+        ClientEvent(c_SharedMember, c_SharedJobList, p_Shared);
+    });
+    Run("Client event, intrusive", us_Iterations, [&]()
+    {
+        ClientEvent(c_IntrusiveMember, c_IntrusiveJobList, p_Shared);
+    });
+    
+    // Messages, created and moved through the send queue
+    const std::vector<uint8_t> v_Data(64, NetMessage::MSG_TEXT);
+    SharedList<NetMessage> c_SharedSend;
+    SharedList<NetMessage, IntrusivePointer<NetMessage>> c_IntrusiveSend;
+    
+    Run("Message send, shared_ptr", us_Iterations, [&]()
+    {
+        MessageEvent(std::make_shared<NetMessage>(v_Data), c_SharedSend);
+    });
+    Run("Message send, intrusive", us_Iterations, [&]()
+    {
+        MessageEvent(MakeIntrusive<NetMessage>(v_Data), c_IntrusiveSend);
+    });
+    
+    Bench::Print("Handle size, shared_ptr", sizeof(std::shared_ptr<Job>), "bytes");
+    Bench::Print("Handle size, intrusive", sizeof(IntrusivePointer<Job>), "bytes");
+    
+    return 0;
+}
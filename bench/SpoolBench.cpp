@@ -0,0 +1,218 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// External
+
+// Project
+#include "../src/Server/CustomSpool.h"
+#include "./Bench.h"
+
+
+namespace
+{
+    // Bytes handed over per quic recieve event
+    constexpr size_t us_RecieveSize = 16 * 1024;
+    
+    // Net message id and message id in front of a spooled MSG_DATA_ID
+    constexpr size_t us_PrefixSize = NetMessage::us_DataPos + sizeof(uint64_t);
+    
+    //*************************************************************************************
+    // Transfer
+    //*************************************************************************************
+    
+    /**
+     *  Recieve a custom net message into the spool and send it back in chunks,
+     *  the same steps the stream callbacks perform.
+     *
+     *  \param c_CustomSpool The spool to use.
+     *  \param v_Payload The full custom net message buffer.
+     *  \param v_Sent The sent bytes to write, prefix included.
+     *  \param us_Held The most bytes held in memory at once to write.
+     */
+    
+    void Spooled(CustomSpool& c_CustomSpool, std::vector<uint8_t> const& v_Payload, std::vector<uint8_t>& v_Sent, size_t& us_Held)
+    {
+        std::vector<uint8_t> v_Bytes;
+        int i_FD = -1;
+        
+        // Recieve, every event is written out
+        uint64_t u64_SpoolID = c_CustomSpool.Create(i_FD);
+        
+        for (size_t us_Pos = 0; us_Pos < v_Payload.size(); us_Pos += us_RecieveSize)
+        {
+            size_t us_Size = std::min(us_RecieveSize, v_Payload.size() - us_Pos);
+            
+            v_Bytes.assign(v_Payload.begin() + us_Pos, v_Payload.begin() + us_Pos + us_Size);
+            CustomSpool::Write(i_FD, v_Bytes.data(), v_Bytes.size());
+        }
+        
+        CustomSpool::Close(i_FD);
+        
+        std::vector<uint8_t> v_Reference = CustomSpool::ToReference(u64_SpoolID);
+        
+        if (CustomSpool::ToSpoolID(v_Reference) != u64_SpoolID)
+        {
+            fprintf(stderr, "Spool reference mismatch!\n");
+            exit(-1);
+        }
+        
+        // Send, the prefix goes in front of the first chunk
+        uint64_t u64_Remaining;
+        
+        i_FD = c_CustomSpool.Open(u64_SpoolID, u64_Remaining);
+        v_Bytes.assign(us_PrefixSize, NetMessage::MSG_DATA_ID);
+        v_Sent.clear();
+        us_Held = 0;
+        
+        for (size_t us_Offset = us_PrefixSize; true; us_Offset = 0)
+        {
+            CustomSpool::ReadChunk(i_FD, u64_Remaining, v_Bytes, us_Offset);
+            
+            us_Held = std::max(us_Held, v_Bytes.size());
+            v_Sent.insert(v_Sent.end(), v_Bytes.begin(), v_Bytes.end());
+            
+            if (u64_Remaining == 0)
+            {
+                break;
+            }
+        }
+        
+        CustomSpool::Close(i_FD);
+        c_CustomSpool.Remove(u64_SpoolID);
+    }
+    
+    /**
+     *  Recieve a custom net message into memory and send it whole.
+     *
+     *  \param v_Payload The full custom net message buffer.
+     *  \param v_Sent The sent bytes to write, prefix included.
+     *  \param us_Held The most bytes held in memory at once to write.
+     */
+    
+    void Buffered(std::vector<uint8_t> const& v_Payload, std::vector<uint8_t>& v_Sent, size_t& us_Held)
+    {
+        std::vector<uint8_t> v_Bytes;
+        
+        for (size_t us_Pos = 0; us_Pos < v_Payload.size(); us_Pos += us_RecieveSize)
+        {
+            size_t us_Size = std::min(us_RecieveSize, v_Payload.size() - us_Pos);
+            
+            v_Bytes.insert(v_Bytes.end(), v_Payload.begin() + us_Pos, v_Payload.begin() + us_Pos + us_Size);
+        }
+        
+        v_Bytes.insert(v_Bytes.begin(), us_PrefixSize, NetMessage::MSG_DATA_ID);
+        us_Held = v_Bytes.capacity();
+        v_Sent.swap(v_Bytes);
+    }
+    
+    //*************************************************************************************
+    // Measure
+    //*************************************************************************************
+    
+    /**
+     *  Measure both transfers for a payload size and check the sent bytes.
+     *
+     *  \param c_CustomSpool The spool to use.
+     *  \param us_Size The custom net message size.
+     */
+    
+    void Transfer(CustomSpool& c_CustomSpool, size_t us_Size)
+    {
+        std::vector<uint8_t> v_Payload(us_Size);
+        std::vector<uint8_t> v_Sent;
+        size_t us_Held = 0;
+        
+        v_Payload[NetMessage::us_IDPos] = NetMessage::MSG_CUSTOM;
+        
+        for (size_t i = NetMessage::us_DataPos; i < us_Size; ++i)
+        {
+            v_Payload[i] = static_cast<uint8_t>(i * 31 + (i >> 12));
+        }
+        
+        size_t us_Iterations = std::max(static_cast<size_t>(1), (static_cast<size_t>(64) * 1024 * 1024) / us_Size);
+        std::string s_Size = std::to_string(us_Size / 1024) + " KiB";
+        
+        auto Check = [&](const char* p_Name)
+        {
+            if (v_Sent.size() != us_PrefixSize + us_Size ||
+                memcmp(v_Sent.data() + us_PrefixSize, v_Payload.data(), us_Size) != 0)
+            {
+                fprintf(stderr, "%s %s: sent bytes differ!\n", p_Name, s_Size.c_str());
+                exit(-1);
+            }
+        };
+        
+        double f64_Spooled = Bench::Measure("Spooled " + s_Size, us_Iterations, [&]()
+        {
+            Spooled(c_CustomSpool, v_Payload, v_Sent, us_Held);
+        });
+        Check("Spooled");
+        Bench::Print("Spooled " + s_Size + " throughput", us_Size / f64_Spooled * 1000.0, "MB/s");
+        Bench::Print("Spooled " + s_Size + " held in memory", us_Held, "bytes");
+        
+        double f64_Buffered = Bench::Measure("Buffered " + s_Size, us_Iterations, [&]()
+        {
+            Buffered(v_Payload, v_Sent, us_Held);
+        });
+        Check("Buffered");
+        Bench::Print("Buffered " + s_Size + " throughput", us_Size / f64_Buffered * 1000.0, "MB/s");
+        Bench::Print("Buffered " + s_Size + " held in memory", us_Held, "bytes");
+    }
+}
+
+// @NOTE: The spool directory should be on the disk the server uses,
+//        set with MRH_BENCH_SPOOL_PATH. Defaults to /tmp.
+int main()
+{
+    const char* p_Base = getenv("MRH_BENCH_SPOOL_PATH");
+    std::string s_Directory = std::string(p_Base != NULL ? p_Base : "/tmp") + "/mrhnetserver_bench_spool_XXXXXX";
+    
+    if (mkdtemp(&(s_Directory[0])) == NULL)
+    {
+        fprintf(stderr, "Failed to create %s!\n", s_Directory.c_str());
+        return -1;
+    }
+    
+    try
+    {
+        CustomSpool c_CustomSpool(s_Directory, UINT64_MAX);
+        
+        // Smallest spooled size first, then multi MB transfers
+        for (size_t us_Size : { static_cast<size_t>(2) * 1024,
+                                static_cast<size_t>(1) * 1024 * 1024,
+                                static_cast<size_t>(8) * 1024 * 1024,
+                                static_cast<size_t>(32) * 1024 * 1024 })
+        {
+            Transfer(c_CustomSpool, us_Size);
+        }
+    }
+    catch (std::exception& e)
+    {
+        fprintf(stderr, "%s\n", e.what());
+        rmdir(s_Directory.c_str());
+        return -1;
+    }
+    
+    rmdir(s_Directory.c_str());
+    return 0;
+}
@@ -59,8 +59,31 @@ CREATE TABLE `message_data`
     `device_key` varchar(25) NOT NULL DEFAULT '' COMMENT 'User assigned device key',
     `actor_type` tinyint unsigned NOT NULL DEFAULT '0' COMMENT 'Actor origin',
     `message_type` tinyint unsigned NOT NULL DEFAULT '0' COMMENT 'Message type',
-    `message_data` varchar(2048) NOT NULL DEFAULT '' COMMENT 'Message data',
+    `message_data` varbinary(1024) NOT NULL DEFAULT '' COMMENT 'Message data',
+    `claim_expire` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'Unix time in seconds until retrieval claim ends',
+    `store_time` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'Unix time in seconds when the message was stored',
     PRIMARY KEY (`message_id`),
+    KEY `recipient` (`user_id`, `device_key`, `actor_type`, `message_id`),
     FOREIGN KEY (`user_id`) REFERENCES user_account(`user_id`)
 ) 
-DEFAULT CHARSET=utf8 ROW_FORMAT=COMPACT COMMENT='Recieved and store currently held messages';
\ No newline at end of file
+DEFAULT CHARSET=utf8 ROW_FORMAT=COMPACT COMMENT='Recieved and store currently held messages';
+
+
+--
+-- Message Cursors
+--
+
+DROP TABLE IF EXISTS `message_cursor`;
+
+CREATE TABLE `message_cursor` 
+(
+    `user_id` int unsigned NOT NULL COMMENT 'User identifier',
+    `device_key` varchar(25) NOT NULL DEFAULT '' COMMENT 'User assigned device key',
+    `actor_type` tinyint unsigned NOT NULL DEFAULT '0' COMMENT 'Actor origin',
+    `message_id` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'All messages up to this id were delivered',
+    `fan_out_id` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'All fan-out messages up to this id were delivered',
+    `fan_out_claim_expire` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'Unix time in seconds until fan-out retrieval claim ends',
+    PRIMARY KEY (`user_id`, `device_key`, `actor_type`),
+    FOREIGN KEY (`user_id`) REFERENCES user_account(`user_id`)
+) 
+DEFAULT CHARSET=utf8 ROW_FORMAT=COMPACT COMMENT='Delivered message cursor per recipient';
\ No newline at end of file
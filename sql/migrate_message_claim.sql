@@ -0,0 +1,22 @@
+-- ------------------------
+-- MRH Net Server Message Claim Migration
+--
+-- This SQL file adds the claim expiration
+-- column used for message retrieval claims
+-- and the recipient index used to find the
+-- next message for a recipient.
+--
+-- Existing rows are unclaimed after the
+-- migration.
+-- ------------------------
+
+USE `mrhnetserver`;
+
+
+--
+-- Claim Column & Recipient Index
+--
+
+ALTER TABLE `message_data`
+    ADD COLUMN `claim_expire` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'Unix time in seconds until retrieval claim ends' AFTER `message_data`,
+    ADD KEY `recipient` (`user_id`, `device_key`, `actor_type`, `message_id`);
@@ -0,0 +1,30 @@
+-- ------------------------
+-- MRH Net Server Message Cursor Migration
+--
+-- This SQL file adds the message cursor
+-- table. Delivered messages are marked
+-- and purged in batches instead of being
+-- deleted on read.
+--
+-- Apply after migrate_message_claim.sql.
+-- ------------------------
+
+USE `mrhnetserver`;
+
+
+--
+-- Message Cursors
+--
+
+DROP TABLE IF EXISTS `message_cursor`;
+
+CREATE TABLE `message_cursor` 
+(
+    `user_id` int unsigned NOT NULL COMMENT 'User identifier',
+    `device_key` varchar(25) NOT NULL DEFAULT '' COMMENT 'User assigned device key',
+    `actor_type` tinyint unsigned NOT NULL DEFAULT '0' COMMENT 'Actor origin',
+    `message_id` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'All messages up to this id were delivered',
+    PRIMARY KEY (`user_id`, `device_key`, `actor_type`),
+    FOREIGN KEY (`user_id`) REFERENCES user_account(`user_id`)
+) 
+DEFAULT CHARSET=utf8 ROW_FORMAT=COMPACT COMMENT='Delivered message cursor per recipient';
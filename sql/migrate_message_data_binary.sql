@@ -0,0 +1,78 @@
+-- ------------------------
+-- MRH Net Server Message Data Migration
+--
+-- This SQL file converts the base64 encoded
+-- message_data column of existing databases
+-- to raw binary data in place.
+--
+-- Rows are converted in batches by message
+-- id range to keep transactions and locks
+-- small. Stop all servers before running this
+-- file, servers using binary message data
+-- can not read base64 rows and vice versa.
+-- ------------------------
+
+USE `mrhnetserver`;
+
+
+--
+-- Binary Column
+--
+
+ALTER TABLE `message_data`
+    ADD COLUMN `message_data_bin` varbinary(1024) NULL DEFAULT NULL COMMENT 'Message data' AFTER `message_data`;
+
+
+--
+-- Batch Conversion
+--
+
+DROP PROCEDURE IF EXISTS `migrate_message_data_binary`;
+
+DELIMITER //
+
+CREATE PROCEDURE `migrate_message_data_binary`(IN batch_size INT UNSIGNED)
+BEGIN
+    DECLARE current_id BIGINT UNSIGNED DEFAULT 0;
+    DECLARE last_id BIGINT UNSIGNED DEFAULT 0;
+
+    SELECT IFNULL(MIN(`message_id`), 0), IFNULL(MAX(`message_id`), 0)
+        INTO current_id, last_id
+        FROM `message_data`;
+
+    WHILE current_id <= last_id AND last_id > 0 DO
+        START TRANSACTION;
+
+        UPDATE `message_data`
+            SET `message_data_bin` = FROM_BASE64(`message_data`)
+            WHERE `message_id` >= current_id AND `message_id` < current_id + batch_size;
+
+        COMMIT;
+
+        SET current_id = current_id + batch_size;
+    END WHILE;
+END //
+
+DELIMITER ;
+
+CALL `migrate_message_data_binary`(1000);
+
+DROP PROCEDURE `migrate_message_data_binary`;
+
+
+--
+-- Invalid Rows
+--
+
+-- @NOTE: Rows which failed to decode could never be retrieved
+--        and would block the message queue of the recipient.
+DELETE FROM `message_data` WHERE `message_data_bin` IS NULL OR LENGTH(`message_data_bin`) = 0;
+
+
+--
+-- Column Swap
+--
+
+ALTER TABLE `message_data`
+    DROP COLUMN `message_data`,
+    CHANGE COLUMN `message_data_bin` `message_data` varbinary(1024) NOT NULL DEFAULT '' COMMENT 'Message data';
@@ -0,0 +1,18 @@
+-- ------------------------
+-- MRH Net Server Message Delivered Migration
+--
+-- This SQL file removes messages marked as
+-- delivered. Delivered messages are now
+-- tracked by the recipient cursor only.
+--
+-- Apply after migrate_message_store_time.sql.
+-- ------------------------
+
+USE `mrhnetserver`;
+
+
+--
+-- Message Data
+--
+
+DELETE FROM `message_data` WHERE `claim_expire` = 18446744073709551615;
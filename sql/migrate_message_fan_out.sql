@@ -0,0 +1,21 @@
+-- ------------------------
+-- MRH Net Server Message Fan-Out Migration
+--
+-- This SQL file adds the fan-out cursor
+-- and claim to the message cursor table.
+-- Fan-out messages are stored once with
+-- a empty device key.
+--
+-- Apply after migrate_message_cursor.sql.
+-- ------------------------
+
+USE `mrhnetserver`;
+
+
+--
+-- Message Cursors
+--
+
+ALTER TABLE `message_cursor`
+    ADD COLUMN `fan_out_id` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'All fan-out messages up to this id were delivered' AFTER `message_id`,
+    ADD COLUMN `fan_out_claim_expire` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'Unix time in seconds until fan-out retrieval claim ends' AFTER `fan_out_id`;
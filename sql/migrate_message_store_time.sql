@@ -0,0 +1,20 @@
+-- ------------------------
+-- MRH Net Server Message Store Time Migration
+--
+-- This SQL file adds the store time to
+-- the message data table. Delivered message
+-- cursors only move past messages stored
+-- longer than the claim timeout ago.
+--
+-- Apply after migrate_message_fan_out.sql.
+-- ------------------------
+
+USE `mrhnetserver`;
+
+
+--
+-- Message Data
+--
+
+ALTER TABLE `message_data`
+    ADD COLUMN `store_time` bigint unsigned NOT NULL DEFAULT '0' COMMENT 'Unix time in seconds when the message was stored' AFTER `claim_expire`;
@@ -22,13 +22,11 @@
 #include <vector>
 
 // External
-#include <mysqlx/xdevapi.h>
 #include <sodium.h>
 
 // Project
 #include "./CLI.h"
 #include "./Logger.h"
-#include "./Database/DatabaseTable.h"
 
 // Pre-defined
 namespace
@@ -56,11 +54,8 @@ namespace
         "removedevice"
     };
     
-    std::string s_MySQLAddress("");
-    int i_MySQLPort(-1);
-    std::string s_MySQLUser("");
-    std::string s_MySQLPassword("");
-    std::string s_MySQLDatabase("");
+    std::shared_ptr<AccountStore> p_AccountStore(NULL);
+    std::shared_ptr<AccountCache> p_AccountCache(NULL);
 }
 
 //*************************************************************************************
@@ -131,23 +126,12 @@ static void CreateAccount(std::string const& s_Mail, std::string const& s_Passwo
     // Got base 64 password, now insert
     try
     {
-        mysqlx::Session c_Session(s_MySQLAddress,
-                                  i_MySQLPort,
-                                  s_MySQLUser,
-                                  s_MySQLPassword);
-        
-        mysqlx::Table c_Table = c_Session.getSchema(s_MySQLDatabase)
-                                         .getTable(DatabaseTable::p_UATableName);
-        
-        c_Table.insert(DatabaseTable::p_UAFieldName[DatabaseTable::UA_MAIL_ADDRESS],
-                       DatabaseTable::p_UAFieldName[DatabaseTable::UA_PASSWORD])
-               .values(s_Mail,
-                       p_B64)
-               .execute();
+        p_AccountStore->CreateAccount(s_Mail,
+                                      p_B64);
     }
     catch (std::exception& e)
     {
-        Logger::Singleton().Log(Logger::ERROR, "Account insertion to database failed: " +
+        Logger::Singleton().Log(Logger::ERROR, "Account insertion to store failed: " +
                                                std::string(e.what()),
                                 "CLI.cpp", __LINE__);
     }
@@ -159,25 +143,12 @@ static void RemoveAccount(std::string const& s_UserID) noexcept
     {
         uint32_t u32_UserID = std::stoull(s_UserID);
         
-        mysqlx::Session c_Session(s_MySQLAddress,
-                                  i_MySQLPort,
-                                  s_MySQLUser,
-                                  s_MySQLPassword);
-        
-        mysqlx::Table c_Table = c_Session.getSchema(s_MySQLDatabase)
-                                         .getTable(DatabaseTable::p_UATableName);
-        
-        
-        c_Table.remove()
-               .where(std::string(DatabaseTable::p_UAFieldName[DatabaseTable::UA_USER_ID]) +
-                      " == :value")
-               .bind("value",
-                     u32_UserID)
-               .execute();
+        p_AccountStore->RemoveAccount(u32_UserID);
+        p_AccountCache->Invalidate(u32_UserID);
     }
     catch (std::exception& e)
     {
-        Logger::Singleton().Log(Logger::ERROR, "Account removal from database failed: " +
+        Logger::Singleton().Log(Logger::ERROR, "Account removal from store failed: " +
                                                std::string(e.what()),
                                 "CLI.cpp", __LINE__);
     }
@@ -193,23 +164,13 @@ static void AddDevice(std::string const& s_UserID, std::string const& s_DeviceKe
     {
         uint32_t u32_UserID = std::stoull(s_UserID);
         
-        mysqlx::Session c_Session(s_MySQLAddress,
-                                  i_MySQLPort,
-                                  s_MySQLUser,
-                                  s_MySQLPassword);
-        
-        mysqlx::Table c_Table = c_Session.getSchema(s_MySQLDatabase)
-                                         .getTable(DatabaseTable::p_UDLTableName);
-        
-        c_Table.insert(DatabaseTable::p_UDLFieldName[DatabaseTable::UDL_USER_ID],
-                       DatabaseTable::p_UDLFieldName[DatabaseTable::UDL_DEVICE_KEY])
-               .values(u32_UserID,
-                       s_DeviceKey)
-               .execute();
+        p_AccountStore->AddDevice(u32_UserID,
+                                  s_DeviceKey);
+        p_AccountCache->Invalidate(u32_UserID);
     }
     catch (std::exception& e)
     {
-        Logger::Singleton().Log(Logger::ERROR, "Device insertion to database failed: " +
+        Logger::Singleton().Log(Logger::ERROR, "Device insertion to store failed: " +
                                                std::string(e.what()),
                                 "CLI.cpp", __LINE__);
     }
@@ -221,29 +182,13 @@ static void RemoveDevice(std::string const& s_UserID, std::string const& s_Devic
     {
         uint32_t u32_UserID = std::stoull(s_UserID);
         
-        mysqlx::Session c_Session(s_MySQLAddress,
-                                  i_MySQLPort,
-                                  s_MySQLUser,
-                                  s_MySQLPassword);
-        
-        mysqlx::Table c_Table = c_Session.getSchema(s_MySQLDatabase)
-                                         .getTable(DatabaseTable::p_UDLTableName);
-        
-        
-        c_Table.remove()
-               .where(std::string(DatabaseTable::p_UDLFieldName[DatabaseTable::UDL_USER_ID]) +
-                      " == :valueA AND " +
-                      std::string(DatabaseTable::p_UDLFieldName[DatabaseTable::UDL_DEVICE_KEY]) +
-                      " == :valueB")
-               .bind("valueA",
-                     u32_UserID)
-               .bind("valueB",
-                     s_DeviceKey)
-               .execute();
+        p_AccountStore->RemoveDevice(u32_UserID,
+                                     s_DeviceKey);
+        p_AccountCache->Invalidate(u32_UserID);
     }
     catch (std::exception& e)
     {
-        Logger::Singleton().Log(Logger::ERROR, "Device removal from database failed: " +
+        Logger::Singleton().Log(Logger::ERROR, "Device removal from store failed: " +
                                                std::string(e.what()),
                                 "CLI.cpp", __LINE__);
     }
@@ -321,18 +266,21 @@ static void UpdateCLI() noexcept
     }
 }
 
-void CLI::Start(Configuration& c_Configuration) noexcept
+void CLI::Start(std::shared_ptr<AccountStore> p_Store, std::shared_ptr<AccountCache> p_Cache) noexcept
 {
     if (b_Run == true)
     {
         return;
     }
+    else if (p_Store == NULL || p_Cache == NULL)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "No account store or cache for CLI given!",
+                                "CLI.cpp", __LINE__);
+        return;
+    }
     
-    s_MySQLAddress = c_Configuration.s_MySQLAddress;
-    i_MySQLPort = c_Configuration.i_MySQLPort;
-    s_MySQLUser = c_Configuration.s_MySQLUser;
-    s_MySQLPassword = c_Configuration.s_MySQLPassword;
-    s_MySQLDatabase = c_Configuration.s_MySQLDatabase;
+    p_AccountStore = p_Store;
+    p_AccountCache = p_Cache;
     
     try
     {
@@ -356,4 +304,7 @@ void CLI::Stop() noexcept
     
     b_Run = false;
     c_Thread.join();
+    
+    p_AccountStore.reset();
+    p_AccountCache.reset();
 }
@@ -19,11 +19,13 @@
 
 // C / C++
 #include <string>
+#include <memory>
 
 // External
 
 // Project
-#include "./Configuration.h"
+#include "./Database/AccountStore.h"
+#include "./Database/AccountCache.h"
 
 
 namespace CLI
@@ -35,10 +37,11 @@ namespace CLI
     /**
      *  Start a CLI loop, allowing for input.
      *
-     *  \param c_Configuration The server configuration to use.
+     *  \param p_Store The account store to manage from the CLI thread.
+     *  \param p_Cache The account cache to invalidate on changes.
      */
     
-    void Start(Configuration& c_Configuration) noexcept;
+    void Start(std::shared_ptr<AccountStore> p_Store, std::shared_ptr<AccountCache> p_Cache) noexcept;
     
     /**
      *  Stop a CLI loop.
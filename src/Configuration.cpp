@@ -35,16 +35,33 @@ namespace
         KEY_FILE_PATH = 2,
         MAX_CLIENT_COUNT = 3,
         CONNECTION_TIMEOUT_S = 4,
+        LONG_POLL_S = 5,
+        NOTIFICATION_WINDOW_MS = 6,
+        COMPRESSION_SIZE_MIN = 7,
         
         // MySQL
-        MYSQL_ADDRESS = 5,
-        MYSQL_PORT = 6,
-        MYSQL_USER = 7,
+        MYSQL_ADDRESS = 8,
+        MYSQL_PORT = 9,
+        MYSQL_USER = 10,
         MYSQL_PASSWORD,
         MYSQL_DATABASE,
+        MYSQL_CHANGE_FEED_INTERVAL_MS,
+        MYSQL_PURGE_INTERVAL_S,
+        
+        // Storage
+        STORAGE_BACKEND,
+        STORAGE_ACCOUNT_CACHE_TTL_S,
+        
+        // Log
+        LOG_DIRECTORY_PATH,
+        LOG_SYNC_INTERVAL_MS,
+        
+        // Custom
+        CUSTOM_DIRECTORY_PATH,
+        CUSTOM_SIZE_MAX_KB,
         
         // Bounds
-        IDENTIFIER_MAX = MYSQL_DATABASE,
+        IDENTIFIER_MAX = CUSTOM_SIZE_MAX_KB,
         
         IDENTIFIER_COUNT = IDENTIFIER_MAX + 1
     };
@@ -57,13 +74,30 @@ namespace
         "ServerKeyFilePath=",
         "ServerMaxClientCount=",
         "ServerConnectionTimeoutS=",
+        "ServerLongPollS=",
+        "ServerNotificationWindowMS=",
+        "ServerCompressionSizeMin=",
         
         // MySQL
         "MySQLAddress=",
         "MySQLPort=",
         "MySQLUser=",
         "MySQLPassword=",
-        "MySQLDatabase="
+        "MySQLDatabase=",
+        "MySQLChangeFeedIntervalMS=",
+        "MySQLPurgeIntervalS=",
+        
+        // Storage
+        "StorageBackend=",
+        "StorageAccountCacheTTLS=",
+        
+        // Log
+        "LogDirectoryPath=",
+        "LogSyncIntervalMS=",
+        
+        // Custom
+        "CustomDirectoryPath=",
+        "CustomSizeMaxKB="
     };
 }
 
@@ -77,11 +111,22 @@ Configuration::Configuration(std::string const& s_FilePath) : i_Port(-1),
                                                               s_KeyFilePath("/usr/share/mrhnetserver/key.key"),
                                                               i_MaxClientCount(1024),
                                                               i_ConnectionTimeoutS(60),
+                                                              i_LongPollS(0),
+                                                              i_NotificationWindowMS(0),
+                                                              i_CompressionSizeMin(0),
                                                               s_MySQLAddress("localhost"),
                                                               i_MySQLPort(33060),
                                                               s_MySQLUser("user"),
                                                               s_MySQLPassword(""),
-                                                              s_MySQLDatabase("mrhnetserver")
+                                                              s_MySQLDatabase("mrhnetserver"),
+                                                              i_MySQLChangeFeedIntervalMS(0),
+                                                              i_MySQLPurgeIntervalS(60),
+                                                              s_StorageBackend("MySQL"),
+                                                              i_StorageAccountCacheTTLS(300),
+                                                              s_LogDirectoryPath("/var/lib/mrhnetserver/log"),
+                                                              i_LogSyncIntervalMS(5),
+                                                              s_CustomDirectoryPath("/var/lib/mrhnetserver/custom"),
+                                                              i_CustomSizeMaxKB(65536)
 {
     std::ifstream f_File(s_FilePath);
     std::string s_Line;
@@ -139,6 +184,15 @@ Configuration::Configuration(std::string const& s_FilePath) : i_Port(-1),
                     case CONNECTION_TIMEOUT_S:
                         i_ConnectionTimeoutS = std::stoi(s_Line);
                         break;
+                    case LONG_POLL_S:
+                        i_LongPollS = std::stoi(s_Line);
+                        break;
+                    case NOTIFICATION_WINDOW_MS:
+                        i_NotificationWindowMS = std::stoi(s_Line);
+                        break;
+                    case COMPRESSION_SIZE_MIN:
+                        i_CompressionSizeMin = std::stoi(s_Line);
+                        break;
                         
                     // MySQL
                     case MYSQL_ADDRESS:
@@ -156,7 +210,37 @@ Configuration::Configuration(std::string const& s_FilePath) : i_Port(-1),
                     case MYSQL_DATABASE:
                         s_MySQLDatabase = s_Line;
                         break;
+                    case MYSQL_CHANGE_FEED_INTERVAL_MS:
+                        i_MySQLChangeFeedIntervalMS = std::stoi(s_Line);
+                        break;
+                    case MYSQL_PURGE_INTERVAL_S:
+                        i_MySQLPurgeIntervalS = std::stoi(s_Line);
+                        break;
                         
+                    // Storage
+                    case STORAGE_BACKEND:
+                        s_StorageBackend = s_Line;
+                        break;
+                    case STORAGE_ACCOUNT_CACHE_TTL_S:
+                        i_StorageAccountCacheTTLS = std::stoi(s_Line);
+                        break;
+                    
+                    // Log
+                    case LOG_DIRECTORY_PATH:
+                        s_LogDirectoryPath = s_Line;
+                        break;
+                    case LOG_SYNC_INTERVAL_MS:
+                        i_LogSyncIntervalMS = std::stoi(s_Line);
+                        break;
+                    
+                    // Custom
+                    case CUSTOM_DIRECTORY_PATH:
+                        s_CustomDirectoryPath = s_Line;
+                        break;
+                    case CUSTOM_SIZE_MAX_KB:
+                        i_CustomSizeMaxKB = std::stoi(s_Line);
+                        break;
+                    
                     // Unknown
                     default:
                         break;
@@ -59,6 +59,9 @@ public:
     std::string s_KeyFilePath;
     int i_MaxClientCount;
     int i_ConnectionTimeoutS;
+    int i_LongPollS;
+    int i_NotificationWindowMS;
+    int i_CompressionSizeMin;
     
     // MySQL
     std::string s_MySQLAddress;
@@ -66,6 +69,20 @@ public:
     std::string s_MySQLUser;
     std::string s_MySQLPassword;
     std::string s_MySQLDatabase;
+    int i_MySQLChangeFeedIntervalMS;
+    int i_MySQLPurgeIntervalS;
+    
+    // Storage
+    std::string s_StorageBackend;
+    int i_StorageAccountCacheTTLS;
+    
+    // Log
+    std::string s_LogDirectoryPath;
+    int i_LogSyncIntervalMS;
+    
+    // Custom
+    std::string s_CustomDirectoryPath;
+    int i_CustomSizeMaxKB;
     
 private:
     
@@ -0,0 +1,184 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+
+// External
+#include <sodium.h>
+
+// Project
+#include "./AccountCache.h"
+#include "../Server/Client/Base64.h"
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+AccountCache::AccountCache(int i_TTLS) noexcept : c_TTL(i_TTLS > 0 ? i_TTLS : 0)
+{
+    for (size_t i = 0; i < ACCOUNT_CACHE_SHARD_COUNT; ++i)
+    {
+        p_Shard[i].u64_Generation = 0;
+    }
+}
+
+AccountCache::~AccountCache() noexcept
+{}
+
+//*************************************************************************************
+// Cache
+//*************************************************************************************
+
+void AccountCache::Preload(AccountStore& c_AccountStore)
+{
+    std::vector<AccountStore::Account> v_Account;
+    
+    c_AccountStore.GetAccounts(v_Account);
+    
+    for (auto& Stored : v_Account)
+    {
+        std::shared_ptr<const Account> p_Account = CreateAccount(Stored.u32_UserID,
+                                                                 Stored.s_Password,
+                                                                 Stored.v_DeviceKey);
+        
+        if (p_Account == NULL)
+        {
+            continue;
+        }
+        
+        Shard& c_Shard = p_Shard[std::hash<std::string>()(Stored.s_Mail) % ACCOUNT_CACHE_SHARD_COUNT];
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        c_Shard.m_Account[Stored.s_Mail] = p_Account;
+    }
+}
+
+void AccountCache::Invalidate(uint32_t u32_UserID) noexcept
+{
+    // @NOTE: Cache is keyed by mail, invalidation is rare enough to check all
+    for (size_t i = 0; i < ACCOUNT_CACHE_SHARD_COUNT; ++i)
+    {
+        Shard& c_Shard = p_Shard[i];
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        c_Shard.u64_Generation += 1;
+        
+        for (auto It = c_Shard.m_Account.begin(); It != c_Shard.m_Account.end();)
+        {
+            if (It->second->u32_UserID == u32_UserID)
+            {
+                It = c_Shard.m_Account.erase(It);
+            }
+            else
+            {
+                ++It;
+            }
+        }
+    }
+}
+
+//*************************************************************************************
+// Account
+//*************************************************************************************
+
+std::shared_ptr<const AccountCache::Account> AccountCache::CreateAccount(uint32_t u32_UserID, std::string const& s_Password, std::vector<std::string> const& v_DeviceKey) const noexcept
+{
+    try
+    {
+        // Stored as base64 salt followed by key
+        std::string s_Bytes = Base64::ToBytes(s_Password);
+        
+        if (s_Bytes.size() < crypto_pwhash_SALTBYTES + crypto_box_SEEDBYTES)
+        {
+            return NULL;
+        }
+        
+        std::shared_ptr<Account> p_Account = std::make_shared<Account>();
+        
+        p_Account->u32_UserID = u32_UserID;
+        p_Account->s_Salt = s_Bytes.substr(0, crypto_pwhash_SALTBYTES);
+        p_Account->s_Key = s_Bytes.substr(crypto_pwhash_SALTBYTES, crypto_box_SEEDBYTES);
+        p_Account->us_DeviceKey.insert(v_DeviceKey.begin(),
+                                       v_DeviceKey.end());
+        p_Account->c_Expire = std::chrono::steady_clock::now() + c_TTL;
+        
+        return p_Account;
+    }
+    catch (...)
+    {
+        return NULL;
+    }
+}
+
+//*************************************************************************************
+// Getters
+//*************************************************************************************
+
+std::shared_ptr<const AccountCache::Account> AccountCache::GetAccount(AccountStore& c_AccountStore, std::string const& s_Mail)
+{
+    Shard& c_Shard = p_Shard[std::hash<std::string>()(s_Mail) % ACCOUNT_CACHE_SHARD_COUNT];
+    uint64_t u64_Generation;
+    
+    {
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        auto It = c_Shard.m_Account.find(s_Mail);
+        
+        if (It != c_Shard.m_Account.end())
+        {
+            if (It->second->c_Expire > std::chrono::steady_clock::now())
+            {
+                return It->second;
+            }
+            
+            c_Shard.m_Account.erase(It);
+        }
+        
+        u64_Generation = c_Shard.u64_Generation;
+    }
+    
+    // Not cached, read from the store without holding the shard
+    uint32_t u32_UserID;
+    std::string s_Password;
+    std::vector<std::string> v_DeviceKey;
+    
+    if (c_AccountStore.GetAccount(s_Mail,
+                                  u32_UserID,
+                                  s_Password) == false)
+    {
+        return NULL;
+    }
+    
+    c_AccountStore.GetDevices(u32_UserID,
+                              v_DeviceKey);
+    
+    std::shared_ptr<const Account> p_Account = CreateAccount(u32_UserID,
+                                                             s_Password,
+                                                             v_DeviceKey);
+    
+    if (p_Account != NULL)
+    {
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        if (c_Shard.u64_Generation == u64_Generation)
+        {
+            c_Shard.m_Account[s_Mail] = p_Account;
+        }
+    }
+    
+    return p_Account;
+}
@@ -0,0 +1,166 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef AccountCache_h
+#define AccountCache_h
+
+// C / C++
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+
+// External
+
+// Project
+#include "./AccountStore.h"
+
+// Pre-defined
+#ifndef ACCOUNT_CACHE_SHARD_COUNT
+    #define ACCOUNT_CACHE_SHARD_COUNT 64
+#endif
+
+
+class AccountCache
+{
+public:
+    
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    struct Account
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        uint32_t u32_UserID;
+        std::string s_Salt; // Decoded bytes
+        std::string s_Key; // Decoded bytes
+        std::unordered_set<std::string> us_DeviceKey;
+        
+        std::chrono::steady_clock::time_point c_Expire;
+    };
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     *
+     *  \param i_TTLS The time in seconds an account stays cached.
+     */
+    
+    AccountCache(int i_TTLS) noexcept;
+    
+    /**
+     *  Copy constructor. Disabled for this class.
+     *
+     *  \param c_AccountCache AccountCache class source.
+     */
+    
+    AccountCache(AccountCache const& c_AccountCache) = delete;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~AccountCache() noexcept;
+    
+    //*************************************************************************************
+    // Cache
+    //*************************************************************************************
+    
+    /**
+     *  Add all accounts of a account store to the cache. This function is thread safe.
+     *
+     *  \param c_AccountStore The account store to load from.
+     */
+    
+    void Preload(AccountStore& c_AccountStore);
+    
+    /**
+     *  Remove all cached accounts for a user id. This function is thread safe.
+     *
+     *  \param u32_UserID The user id to remove.
+     */
+    
+    void Invalidate(uint32_t u32_UserID) noexcept;
+    
+    //*************************************************************************************
+    // Getters
+    //*************************************************************************************
+    
+    /**
+     *  Get a account by mail address, loading it from the account store if not cached.
+     *  This function is thread safe.
+     *
+     *  \param c_AccountStore The account store to load from.
+     *  \param s_Mail The account mail address.
+     *
+     *  \return The account on success, NULL if not found or invalid.
+     */
+    
+    std::shared_ptr<const Account> GetAccount(AccountStore& c_AccountStore, std::string const& s_Mail);
+    
+private:
+    
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    // @NOTE: The generation changes on invalidation, so that a account loaded
+    //        while being invalidated is not added afterwards.
+    struct Shard
+    {
+        std::mutex c_Mutex;
+        std::unordered_map<std::string, std::shared_ptr<const Account>> m_Account;
+        uint64_t u64_Generation;
+    };
+    
+    //*************************************************************************************
+    // Account
+    //*************************************************************************************
+    
+    /**
+     *  Create a cached account.
+     *
+     *  \param u32_UserID The user id of the account.
+     *  \param s_Password The base64 password salt and key.
+     *  \param v_DeviceKey The devices registered for the account.
+     *
+     *  \return The account on success, NULL if invalid.
+     */
+    
+    std::shared_ptr<const Account> CreateAccount(uint32_t u32_UserID, std::string const& s_Password, std::vector<std::string> const& v_DeviceKey) const noexcept;
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    Shard p_Shard[ACCOUNT_CACHE_SHARD_COUNT];
+    std::chrono::seconds c_TTL;
+    
+protected:
+
+};
+
+#endif /* AccountCache_h */
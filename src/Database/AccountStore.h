@@ -0,0 +1,164 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef AccountStore_h
+#define AccountStore_h
+
+// C / C++
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// External
+
+// Project
+#include "../Exception.h"
+
+
+class AccountStore
+{
+public:
+    
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    struct Account
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        uint32_t u32_UserID;
+        std::string s_Mail;
+        std::string s_Password;
+        std::vector<std::string> v_DeviceKey;
+    };
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Copy constructor. Disabled for this class.
+     *
+     *  \param c_AccountStore AccountStore class source.
+     */
+    
+    AccountStore(AccountStore const& c_AccountStore) = delete;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    virtual ~AccountStore() noexcept
+    {}
+    
+    //*************************************************************************************
+    // Account
+    //*************************************************************************************
+    
+    /**
+     *  Get a user account by mail address.
+     *
+     *  \param s_Mail The account mail address.
+     *  \param u32_UserID The user id to write.
+     *  \param s_Password The base64 password salt and key to write.
+     *
+     *  \return true if the account was found, false if not.
+     */
+    
+    virtual bool GetAccount(std::string const& s_Mail, uint32_t& u32_UserID, std::string& s_Password) = 0;
+    
+    /**
+     *  Get all user accounts with their devices.
+     *
+     *  \param v_Account The accounts to write.
+     */
+    
+    virtual void GetAccounts(std::vector<Account>& v_Account) = 0;
+    
+    /**
+     *  Create a user account.
+     *
+     *  \param s_Mail The account mail address.
+     *  \param s_Password The base64 password salt and key.
+     */
+    
+    virtual void CreateAccount(std::string const& s_Mail, std::string const& s_Password) = 0;
+    
+    /**
+     *  Remove a user account.
+     *
+     *  \param u32_UserID The user id of the account.
+     */
+    
+    virtual void RemoveAccount(uint32_t u32_UserID) = 0;
+    
+    //*************************************************************************************
+    // Device
+    //*************************************************************************************
+    
+    /**
+     *  Get all devices registered for a user.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param v_DeviceKey The device keys to write.
+     */
+    
+    virtual void GetDevices(uint32_t u32_UserID, std::vector<std::string>& v_DeviceKey) = 0;
+    
+    /**
+     *  Add a device for a user.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param s_DeviceKey The device key to add.
+     */
+    
+    virtual void AddDevice(uint32_t u32_UserID, std::string const& s_DeviceKey) = 0;
+    
+    /**
+     *  Remove a device from a user.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param s_DeviceKey The device key to remove.
+     */
+    
+    virtual void RemoveDevice(uint32_t u32_UserID, std::string const& s_DeviceKey) = 0;
+    
+private:
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+protected:
+    
+    //*************************************************************************************
+    // Constructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     */
+    
+    AccountStore() noexcept
+    {}
+};
+
+#endif /* AccountStore_h */
@@ -18,13 +18,15 @@
 #define Database_h
 
 // C / C++
+#include <memory>
 
 // External
-#include <mysqlx/xdevapi.h>
 
 // Project
 #include "../Job/ThreadShared.h"
-#include "./DatabaseTable.h"
+#include "./MessageStore.h"
+#include "./AccountStore.h"
+#include "./AccountCache.h"
 
 
 class Database : public ThreadShared
@@ -38,24 +40,23 @@ public:
     /**
      *  Default constructor.
      *
-     *  \param s_Address The mysql server address.
-     *  \param i_Port The mysql server port.
-     *  \param s_User The name of the mysql user.
-     *  \param s_Password The password of the mysql user.
-     *  \param s_Database The database to use.
+     *  \param p_MessageStore The message store to use.
+     *  \param p_AccountStore The account store to use.
+     *  \param p_AccountCache The account cache shared by all threads.
      */
     
-    Database(std::string const& s_Address,
-             int i_Port,
-             std::string const& s_User,
-             std::string const& s_Password,
-             std::string const& s_Database) : ThreadShared(),
-                                              c_Session(s_Address,
-                                                        i_Port,
-                                                        s_User,
-                                                        s_Password),
-                                              s_Database(s_Database)
-    {}
+    Database(std::shared_ptr<MessageStore> p_MessageStore,
+             std::shared_ptr<AccountStore> p_AccountStore,
+             std::shared_ptr<AccountCache> p_AccountCache) : ThreadShared(),
+                                                             p_MessageStore(p_MessageStore),
+                                                             p_AccountStore(p_AccountStore),
+                                                             p_AccountCache(p_AccountCache)
+    {
+        if (p_MessageStore == NULL || p_AccountStore == NULL || p_AccountCache == NULL)
+        {
+            throw Exception("Invalid database stores!");
+        }
+    }
     
     /**
      *  Default destructor.
@@ -68,9 +69,11 @@ public:
     // Data
     //*************************************************************************************
     
-    mysqlx::Session c_Session;
-    
-    std::string s_Database;
+    // @NOTE: Stores might be shared with other threads, depending on
+    //        the backend in use.
+    std::shared_ptr<MessageStore> p_MessageStore;
+    std::shared_ptr<AccountStore> p_AccountStore;
+    std::shared_ptr<AccountCache> p_AccountCache;
     
 private:
     
@@ -20,6 +20,7 @@
 // C / C++
 #include <cstdint>
 #include <string>
+#include <vector>
 
 // External
 
@@ -149,8 +150,10 @@ namespace DatabaseTable
         MD_ACTOR_TYPE = 3,
         MD_MESSAGE_TYPE = 4,
         MD_MESSAGE_DATA = 5,
+        MD_CLAIM_EXPIRE = 6,
+        MD_STORE_TIME = 7,
         
-        MD_FIELDS_MAX = MD_MESSAGE_DATA,
+        MD_FIELDS_MAX = MD_STORE_TIME,
         MD_FIELDS_COUNT = MD_FIELDS_MAX + 1
     };
     
@@ -161,7 +164,9 @@ namespace DatabaseTable
         "device_key",
         "actor_type",
         "message_type",
-        "message_data"
+        "message_data",
+        "claim_expire",
+        "store_time"
     };
     
     /**
@@ -181,11 +186,73 @@ namespace DatabaseTable
         std::string s_DeviceKey;
         uint8_t u8_ActorType;
         uint8_t u8_MessageType;
-        std::string s_MessageData;
+        std::vector<uint8_t> v_MessageData;
+        uint64_t u64_ClaimExpire;
+        uint64_t u64_StoreTime;
     };
     
     constexpr size_t us_MDDeviceKeySize = 25;
-    constexpr size_t us_MDMessageDataSize = 2048;
+    constexpr size_t us_MDMessageDataSize = 1024; // Binary, no encoding
+    constexpr const char* p_MDFanOutDeviceKey = ""; // Stored once for all user devices
+    
+    //*************************************************************************************
+    // Message Cursor Table
+    //*************************************************************************************
+    
+    /**
+     *  Table Name
+     */
+    
+    constexpr const char* p_MCTableName = "message_cursor";
+    
+    /**
+     *  Field Names
+     */
+    
+    enum MCFields
+    {
+        MC_USER_ID = 0,
+        MC_DEVICE_KEY = 1,
+        MC_ACTOR_TYPE = 2,
+        MC_MESSAGE_ID = 3,
+        MC_FAN_OUT_ID = 4,
+        MC_FAN_OUT_CLAIM_EXPIRE = 5,
+        
+        MC_FIELDS_MAX = MC_FAN_OUT_CLAIM_EXPIRE,
+        MC_FIELDS_COUNT = MC_FIELDS_MAX + 1
+    };
+    
+    constexpr const char* p_MCFieldName[MC_FIELDS_COUNT] =
+    {
+        "user_id",
+        "device_key",
+        "actor_type",
+        "message_id",
+        "fan_out_id",
+        "fan_out_claim_expire"
+    };
+    
+    /**
+     *  Row Data
+     */
+    
+    struct MCRow
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        uint32_t u32_UserID;
+        std::string s_DeviceKey;
+        uint8_t u8_ActorType;
+        uint64_t u64_MessageID;
+        uint64_t u64_FanOutID;
+        uint64_t u64_FanOutClaimExpire;
+    };
+    
+    constexpr size_t us_MCDeviceKeySize = 25;
 }
 
 #endif /* DatabaseTable_h */
@@ -0,0 +1,113 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef InboxKey_h
+#define InboxKey_h
+
+// C / C++
+#include <cstdint>
+#include <string>
+#include <functional>
+
+// External
+
+// Project
+
+
+//*************************************************************************************
+// Inbox Key
+//*************************************************************************************
+
+struct InboxKey
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     */
+    
+    InboxKey(uint32_t u32_UserID,
+             std::string const& s_DeviceKey,
+             uint8_t u8_ActorType) : u32_UserID(u32_UserID),
+                                     s_DeviceKey(s_DeviceKey),
+                                     u8_ActorType(u8_ActorType)
+    {}
+    
+    //*************************************************************************************
+    // Operator
+    //*************************************************************************************
+    
+    /**
+     *  Compare with another inbox key.
+     *
+     *  \param c_Key The key to compare with.
+     *
+     *  \return true if equal, false if not.
+     */
+    
+    bool operator==(InboxKey const& c_Key) const noexcept
+    {
+        return u32_UserID == c_Key.u32_UserID &&
+               u8_ActorType == c_Key.u8_ActorType &&
+               s_DeviceKey.compare(c_Key.s_DeviceKey) == 0;
+    }
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    uint32_t u32_UserID;
+    std::string s_DeviceKey;
+    uint8_t u8_ActorType;
+};
+
+//*************************************************************************************
+// Inbox Key Hash
+//*************************************************************************************
+
+struct InboxKeyHash
+{
+public:
+    
+    //*************************************************************************************
+    // Operator
+    //*************************************************************************************
+    
+    /**
+     *  Hash a inbox key.
+     *
+     *  \param c_Key The key to hash.
+     *
+     *  \return The key hash.
+     */
+    
+    size_t operator()(InboxKey const& c_Key) const noexcept
+    {
+        return std::hash<std::string>()(c_Key.s_DeviceKey) ^
+               (static_cast<size_t>(c_Key.u32_UserID) << 1) ^
+               (static_cast<size_t>(c_Key.u8_ActorType) << 24);
+    }
+};
+
+#endif /* InboxKey_h */
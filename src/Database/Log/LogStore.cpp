@@ -0,0 +1,982 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+
+// External
+
+// Project
+#include "./LogStore.h"
+
+// Pre-defined
+namespace
+{
+    const char* p_SegmentExtension = ".seg";
+    const char* p_CursorFileName = "cursor";
+    
+    const char p_Hex[] = "0123456789abcdef";
+    
+    std::string GetErrorString() noexcept
+    {
+        return std::string(std::strerror(errno)) +
+               " (" +
+               std::to_string(errno) +
+               ")";
+    }
+    
+    void SyncDirectory(std::string const& s_DirectoryPath) noexcept
+    {
+        int i_DirectoryFD = open(s_DirectoryPath.c_str(), O_RDONLY | O_DIRECTORY);
+        
+        if (i_DirectoryFD >= 0)
+        {
+            fsync(i_DirectoryFD);
+            close(i_DirectoryFD);
+        }
+    }
+}
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+LogStore::LogStore(std::string const& s_DirectoryPath,
+                   int i_SyncIntervalMS) : MessageStore(),
+                                           s_DirectoryPath(s_DirectoryPath),
+                                           i_SyncIntervalMS(i_SyncIntervalMS),
+                                           u64_WriteTicket(0),
+                                           u64_SyncedTicket(0),
+                                           b_Run(true)
+{
+    if (mkdir(s_DirectoryPath.c_str(), 0700) < 0 && errno != EEXIST)
+    {
+        throw Exception("Failed to create log directory " +
+                        s_DirectoryPath +
+                        ": " +
+                        GetErrorString());
+    }
+    
+    LoadInboxes();
+    
+    try
+    {
+        c_Thread = std::thread(Update, this);
+    }
+    catch (std::exception& e)
+    {
+        throw Exception(e.what());
+    }
+}
+
+LogStore::~LogStore() noexcept
+{
+    {
+        std::lock_guard<std::mutex> c_Guard(c_SyncMutex);
+        b_Run = false;
+    }
+    
+    c_UpdateCondition.notify_all();
+    c_Thread.join();
+}
+
+LogStore::Inbox::Inbox(std::string const& s_DirectoryPath) noexcept : s_DirectoryPath(s_DirectoryPath),
+                                                                      i_WriteFD(-1),
+                                                                      u64_WriteSegment(0),
+                                                                      u64_WriteOffset(0),
+                                                                      i_CursorFD(-1),
+                                                                      u64_FirstSegment(0),
+                                                                      u64_ReadSegment(0),
+                                                                      u64_ReadOffset(0),
+                                                                      u64_ClaimSegment(0),
+                                                                      u64_ClaimOffset(0),
+                                                                      p_Map(NULL),
+                                                                      us_MapSize(0),
+                                                                      u64_MapEnd(0),
+                                                                      u64_MapSegment(0),
+                                                                      b_Dirty(false)
+{}
+
+LogStore::Inbox::~Inbox() noexcept
+{
+    UnmapSegment(*this);
+    
+    if (i_WriteFD >= 0)
+    {
+        close(i_WriteFD);
+    }
+    
+    if (i_CursorFD >= 0)
+    {
+        close(i_CursorFD);
+    }
+}
+
+//*************************************************************************************
+// Inbox
+//*************************************************************************************
+
+std::shared_ptr<LogStore::Inbox> LogStore::GetInbox(InboxKey const& c_Key, bool b_Create)
+{
+    InboxShard& c_Shard = p_InboxShard[InboxKeyHash()(c_Key) % LOG_STORE_SHARD_COUNT];
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    auto It = c_Shard.m_Inbox.find(c_Key);
+    
+    if (It != c_Shard.m_Inbox.end())
+    {
+        return It->second;
+    }
+    else if (b_Create == false)
+    {
+        return NULL;
+    }
+    
+    // Device keys are hex encoded to be usable as file names
+    std::string s_Path = s_DirectoryPath +
+                         "/" +
+                         std::to_string(c_Key.u32_UserID) +
+                         "_" +
+                         std::to_string(c_Key.u8_ActorType) +
+                         "_";
+    
+    for (unsigned char c : c_Key.s_DeviceKey)
+    {
+        s_Path += p_Hex[c >> 4];
+        s_Path += p_Hex[c & 0x0F];
+    }
+    
+    if (mkdir(s_Path.c_str(), 0700) < 0 && errno != EEXIST)
+    {
+        throw Exception("Failed to create inbox directory " +
+                        s_Path +
+                        ": " +
+                        GetErrorString());
+    }
+    
+    std::shared_ptr<Inbox> p_Inbox = std::make_shared<Inbox>(s_Path);
+    c_Shard.m_Inbox.emplace(c_Key, p_Inbox);
+    
+    return p_Inbox;
+}
+
+void LogStore::LoadInboxes()
+{
+    DIR* p_Directory = opendir(s_DirectoryPath.c_str());
+    
+    if (p_Directory == NULL)
+    {
+        throw Exception("Failed to open log directory " +
+                        s_DirectoryPath +
+                        ": " +
+                        GetErrorString());
+    }
+    
+    struct dirent* p_Entry;
+    
+    while ((p_Entry = readdir(p_Directory)) != NULL)
+    {
+        // Name is <user id>_<actor type>_<hex device key>
+        const char* p_Name = p_Entry->d_name;
+        char* p_End;
+        
+        if (p_Name[0] < '0' || p_Name[0] > '9')
+        {
+            continue;
+        }
+        
+        unsigned long ul_UserID = std::strtoul(p_Name, &p_End, 10);
+        
+        if (*p_End != '_')
+        {
+            continue;
+        }
+        
+        unsigned long ul_ActorType = std::strtoul(p_End + 1, &p_End, 10);
+        
+        if (*p_End != '_' || ul_ActorType > UINT8_MAX)
+        {
+            continue;
+        }
+        
+        std::string s_DeviceKey;
+        const char* p_Key = p_End + 1;
+        size_t us_KeyLength = std::strlen(p_Key);
+        
+        if (us_KeyLength % 2 != 0)
+        {
+            continue;
+        }
+        
+        for (size_t i = 0; i < us_KeyLength; i += 2)
+        {
+            const char* p_High = std::strchr(p_Hex, p_Key[i]);
+            const char* p_Low = std::strchr(p_Hex, p_Key[i + 1]);
+            
+            if (p_High == NULL || p_Low == NULL || *p_High == '\0' || *p_Low == '\0')
+            {
+                break;
+            }
+            
+            s_DeviceKey += static_cast<char>(((p_High - p_Hex) << 4) | (p_Low - p_Hex));
+        }
+        
+        if (s_DeviceKey.size() != us_KeyLength / 2)
+        {
+            continue;
+        }
+        
+        InboxKey c_Key(static_cast<uint32_t>(ul_UserID),
+                       s_DeviceKey,
+                       static_cast<uint8_t>(ul_ActorType));
+        std::shared_ptr<Inbox> p_Inbox = std::make_shared<Inbox>(s_DirectoryPath + "/" + p_Name);
+        
+        try
+        {
+            LoadInbox(*p_Inbox);
+        }
+        catch (...)
+        {
+            closedir(p_Directory);
+            throw;
+        }
+        
+        p_InboxShard[InboxKeyHash()(c_Key) % LOG_STORE_SHARD_COUNT].m_Inbox.emplace(c_Key, p_Inbox);
+    }
+    
+    closedir(p_Directory);
+}
+
+void LogStore::LoadInbox(Inbox& c_Inbox)
+{
+    // Collect segments first
+    std::vector<uint64_t> v_Segment;
+    DIR* p_Directory = opendir(c_Inbox.s_DirectoryPath.c_str());
+    
+    if (p_Directory == NULL)
+    {
+        throw Exception("Failed to open inbox directory " +
+                        c_Inbox.s_DirectoryPath +
+                        ": " +
+                        GetErrorString());
+    }
+    
+    struct dirent* p_Entry;
+    
+    while ((p_Entry = readdir(p_Directory)) != NULL)
+    {
+        char* p_End;
+        uint64_t u64_Segment = std::strtoull(p_Entry->d_name, &p_End, 16);
+        
+        if (p_End != p_Entry->d_name && std::strcmp(p_End, p_SegmentExtension) == 0)
+        {
+            v_Segment.emplace_back(u64_Segment);
+        }
+    }
+    
+    closedir(p_Directory);
+    
+    std::string s_CursorPath = c_Inbox.s_DirectoryPath + "/" + p_CursorFileName;
+    
+    if (v_Segment.size() == 0)
+    {
+        unlink(s_CursorPath.c_str());
+        return;
+    }
+    
+    std::sort(v_Segment.begin(), v_Segment.end());
+    
+    // Read cursor, start at the first segment if missing
+    uint64_t p_Cursor[2] = { v_Segment.front(), 0 };
+    
+    c_Inbox.i_CursorFD = open(s_CursorPath.c_str(), O_RDWR | O_CREAT, 0600);
+    
+    if (c_Inbox.i_CursorFD < 0)
+    {
+        throw Exception("Failed to open inbox cursor " +
+                        s_CursorPath +
+                        ": " +
+                        GetErrorString());
+    }
+    else if (pread(c_Inbox.i_CursorFD, p_Cursor, sizeof(p_Cursor), 0) != sizeof(p_Cursor) ||
+             p_Cursor[0] < v_Segment.front() ||
+             p_Cursor[0] > v_Segment.back())
+    {
+        p_Cursor[0] = v_Segment.front();
+        p_Cursor[1] = 0;
+    }
+    
+    c_Inbox.u64_ReadSegment = p_Cursor[0];
+    c_Inbox.u64_ReadOffset = p_Cursor[1];
+    c_Inbox.u64_FirstSegment = c_Inbox.u64_ReadSegment;
+    
+    // Consumed segments which were not yet compacted
+    for (uint64_t u64_Segment : v_Segment)
+    {
+        if (u64_Segment < c_Inbox.u64_ReadSegment)
+        {
+            unlink(GetSegmentPath(c_Inbox, u64_Segment).c_str());
+        }
+    }
+    
+    // Last segment continues to be written, cut incomplete messages
+    c_Inbox.u64_WriteSegment = v_Segment.back();
+    
+    std::string s_SegmentPath = GetSegmentPath(c_Inbox, c_Inbox.u64_WriteSegment);
+    struct stat c_Stat;
+    
+    c_Inbox.i_WriteFD = open(s_SegmentPath.c_str(), O_RDWR);
+    
+    if (c_Inbox.i_WriteFD < 0 || fstat(c_Inbox.i_WriteFD, &c_Stat) < 0)
+    {
+        throw Exception("Failed to open inbox segment " +
+                        s_SegmentPath +
+                        ": " +
+                        GetErrorString());
+    }
+    
+    uint64_t u64_Offset = 0;
+    uint32_t u32_Size;
+    
+    while (u64_Offset + sizeof(u32_Size) <= static_cast<uint64_t>(c_Stat.st_size))
+    {
+        if (pread(c_Inbox.i_WriteFD, &u32_Size, sizeof(u32_Size), u64_Offset) != sizeof(u32_Size) ||
+            u32_Size == 0 ||
+            u64_Offset + sizeof(u32_Size) + u32_Size > static_cast<uint64_t>(c_Stat.st_size))
+        {
+            break;
+        }
+        
+        u64_Offset += sizeof(u32_Size) + u32_Size;
+    }
+    
+    if (u64_Offset != static_cast<uint64_t>(c_Stat.st_size) && ftruncate(c_Inbox.i_WriteFD, u64_Offset) < 0)
+    {
+        throw Exception("Failed to truncate inbox segment " +
+                        s_SegmentPath +
+                        ": " +
+                        GetErrorString());
+    }
+    
+    c_Inbox.u64_WriteOffset = u64_Offset;
+    
+    if (c_Inbox.u64_ReadSegment == c_Inbox.u64_WriteSegment && c_Inbox.u64_ReadOffset > c_Inbox.u64_WriteOffset)
+    {
+        c_Inbox.u64_ReadOffset = c_Inbox.u64_WriteOffset;
+    }
+    
+    c_Inbox.u64_ClaimSegment = c_Inbox.u64_ReadSegment;
+    c_Inbox.u64_ClaimOffset = c_Inbox.u64_ReadOffset;
+}
+
+//*************************************************************************************
+// Segment
+//*************************************************************************************
+
+std::string LogStore::GetSegmentPath(Inbox const& c_Inbox, uint64_t u64_Segment) noexcept
+{
+    std::string s_Name(16, '0');
+    
+    for (size_t i = s_Name.size(); i > 0; --i, u64_Segment >>= 4)
+    {
+        s_Name[i - 1] = p_Hex[u64_Segment & 0x0F];
+    }
+    
+    return c_Inbox.s_DirectoryPath + "/" + s_Name + p_SegmentExtension;
+}
+
+void LogStore::OpenSegment(Inbox& c_Inbox)
+{
+    // Full segment, sync before moving on
+    if (c_Inbox.i_WriteFD >= 0)
+    {
+        fdatasync(c_Inbox.i_WriteFD);
+        close(c_Inbox.i_WriteFD);
+        
+        c_Inbox.i_WriteFD = -1;
+        c_Inbox.u64_WriteSegment += 1;
+    }
+    
+    std::string s_SegmentPath = GetSegmentPath(c_Inbox, c_Inbox.u64_WriteSegment);
+    
+    c_Inbox.i_WriteFD = open(s_SegmentPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    c_Inbox.u64_WriteOffset = 0;
+    
+    if (c_Inbox.i_WriteFD < 0)
+    {
+        throw Exception("Failed to create inbox segment " +
+                        s_SegmentPath +
+                        ": " +
+                        GetErrorString());
+    }
+    
+    // Make the new file itself durable
+    SyncDirectory(c_Inbox.s_DirectoryPath);
+}
+
+void LogStore::MapSegment(Inbox& c_Inbox, uint64_t u64_Segment) noexcept
+{
+    UnmapSegment(c_Inbox);
+    
+    int i_FD = open(GetSegmentPath(c_Inbox, u64_Segment).c_str(), O_RDONLY);
+    struct stat c_Stat;
+    
+    if (i_FD < 0)
+    {
+        return;
+    }
+    else if (fstat(i_FD, &c_Stat) == 0 && c_Stat.st_size > 0)
+    {
+        // @NOTE: Mapped at full segment capacity, appends to the write
+        //        segment become visible without remapping. Only the
+        //        written part of the file is ever read.
+        size_t us_MapSize = std::max(static_cast<size_t>(c_Stat.st_size),
+                                     static_cast<size_t>(LOG_STORE_SEGMENT_SIZE));
+        void* p_Map = mmap(NULL, us_MapSize, PROT_READ, MAP_SHARED, i_FD, 0);
+        
+        if (p_Map != MAP_FAILED)
+        {
+            c_Inbox.p_Map = static_cast<uint8_t*>(p_Map);
+            c_Inbox.us_MapSize = us_MapSize;
+            c_Inbox.u64_MapEnd = c_Stat.st_size;
+            c_Inbox.u64_MapSegment = u64_Segment;
+        }
+    }
+    
+    // Mapping stays valid without the descriptor
+    close(i_FD);
+}
+
+void LogStore::UnmapSegment(Inbox& c_Inbox) noexcept
+{
+    if (c_Inbox.p_Map != NULL)
+    {
+        munmap(c_Inbox.p_Map, c_Inbox.us_MapSize);
+        
+        c_Inbox.p_Map = NULL;
+        c_Inbox.us_MapSize = 0;
+        c_Inbox.u64_MapEnd = 0;
+    }
+}
+
+bool LogStore::ReadMessage(Inbox& c_Inbox, uint64_t u64_Segment, uint64_t u64_Offset, std::vector<uint8_t>& v_Message)
+{
+    uint32_t u32_Size;
+    
+    // Remap if segment changed or a finished segment grew after mapping,
+    // the write segment is read up to the write offset
+    if (c_Inbox.p_Map == NULL ||
+        c_Inbox.u64_MapSegment != u64_Segment ||
+        (u64_Segment != c_Inbox.u64_WriteSegment && u64_Offset + sizeof(u32_Size) > c_Inbox.u64_MapEnd))
+    {
+        MapSegment(c_Inbox, u64_Segment);
+    }
+    
+    uint64_t u64_End = u64_Segment == c_Inbox.u64_WriteSegment ? c_Inbox.u64_WriteOffset : c_Inbox.u64_MapEnd;
+    
+    if (c_Inbox.p_Map == NULL || u64_End > c_Inbox.us_MapSize)
+    {
+        u64_End = c_Inbox.us_MapSize;
+    }
+    
+    if (u64_Offset + sizeof(u32_Size) > u64_End)
+    {
+        return false;
+    }
+    
+    // @NOTE: Messages are written whole, a mapping containing the
+    //        size also contains the message
+    std::memcpy(&u32_Size, c_Inbox.p_Map + u64_Offset, sizeof(u32_Size));
+    
+    if (u32_Size == 0 || u64_Offset + sizeof(u32_Size) + u32_Size > u64_End)
+    {
+        return false;
+    }
+    
+    const uint8_t* p_Message = c_Inbox.p_Map + u64_Offset + sizeof(u32_Size);
+    v_Message.assign(p_Message, p_Message + u32_Size);
+    
+    return true;
+}
+
+void LogStore::WriteCursor(Inbox& c_Inbox)
+{
+    if (c_Inbox.i_CursorFD < 0)
+    {
+        std::string s_CursorPath = c_Inbox.s_DirectoryPath + "/" + p_CursorFileName;
+        
+        if ((c_Inbox.i_CursorFD = open(s_CursorPath.c_str(), O_RDWR | O_CREAT, 0600)) < 0)
+        {
+            throw Exception("Failed to open inbox cursor " +
+                            s_CursorPath +
+                            ": " +
+                            GetErrorString());
+        }
+    }
+    
+    uint64_t p_Cursor[2] = { c_Inbox.u64_ReadSegment, c_Inbox.u64_ReadOffset };
+    
+    if (pwrite(c_Inbox.i_CursorFD, p_Cursor, sizeof(p_Cursor), 0) != sizeof(p_Cursor))
+    {
+        throw Exception("Failed to write inbox cursor: " + GetErrorString());
+    }
+}
+
+//*************************************************************************************
+// Message
+//*************************************************************************************
+
+bool LogStore::RetrieveMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID)
+{
+    std::shared_ptr<Inbox> p_Inbox = GetInbox(InboxKey(u32_UserID, s_DeviceKey, u8_ActorType), false);
+    
+    if (p_Inbox == NULL)
+    {
+        return false;
+    }
+    
+    Inbox& c_Inbox = *p_Inbox;
+    std::lock_guard<std::mutex> c_Guard(c_Inbox.c_Mutex);
+    
+    auto c_Time = std::chrono::steady_clock::now();
+    auto c_Expire = c_Time + std::chrono::seconds(MESSAGE_STORE_CLAIM_TIMEOUT_S);
+    
+    // Timed out claims come first, they are older
+    for (auto& Claimed : c_Inbox.m_Claim)
+    {
+        if (Claimed.second.b_Acknowledged == true || Claimed.second.c_Expire > c_Time)
+        {
+            continue;
+        }
+        
+        uint64_t u64_Position = Claimed.first - 1;
+        
+        if (ReadMessage(c_Inbox, u64_Position >> 32, u64_Position & 0xFFFFFFFF, v_Message) == true)
+        {
+            Claimed.second.c_Expire = c_Expire;
+            u64_MessageID = Claimed.first;
+            
+            return true;
+        }
+    }
+    
+    // Claim the next unclaimed message
+    while (true)
+    {
+        if (c_Inbox.u64_ClaimSegment == c_Inbox.u64_WriteSegment && c_Inbox.u64_ClaimOffset >= c_Inbox.u64_WriteOffset)
+        {
+            return false;
+        }
+        else if (ReadMessage(c_Inbox, c_Inbox.u64_ClaimSegment, c_Inbox.u64_ClaimOffset, v_Message) == true)
+        {
+            uint64_t u64_Position = ((c_Inbox.u64_ClaimSegment << 32) | c_Inbox.u64_ClaimOffset) + 1;
+            auto Latest = KeepLatest(v_Message) == true ? c_Inbox.m_Latest.find(v_Message[NetMessage::us_IDPos]) : c_Inbox.m_Latest.end();
+            
+            if (Latest == c_Inbox.m_Latest.end() || Latest->second == u64_Position)
+            {
+                break;
+            }
+            
+            // Replaced, consumed without delivery
+            // @NOTE: The cursor is synced with the next write or acknowledgement,
+            //        replaced messages are delivered again after a crash.
+            c_Inbox.u64_ClaimOffset += sizeof(uint32_t) + v_Message.size();
+            
+            if (c_Inbox.m_Claim.size() > 0)
+            {
+                Claim& c_Claim = c_Inbox.m_Claim[u64_Position];
+                c_Claim.u64_EndSegment = c_Inbox.u64_ClaimSegment;
+                c_Claim.u64_EndOffset = c_Inbox.u64_ClaimOffset;
+                c_Claim.b_Acknowledged = true;
+            }
+            else
+            {
+                c_Inbox.u64_ReadSegment = c_Inbox.u64_ClaimSegment;
+                c_Inbox.u64_ReadOffset = c_Inbox.u64_ClaimOffset;
+                
+                WriteCursor(c_Inbox);
+            }
+            
+            continue;
+        }
+        
+        // Written segment must be readable, older ones are skipped
+        if (c_Inbox.u64_ClaimSegment >= c_Inbox.u64_WriteSegment)
+        {
+            throw Exception("Failed to read inbox segment " +
+                            GetSegmentPath(c_Inbox, c_Inbox.u64_ClaimSegment));
+        }
+        
+        c_Inbox.u64_ClaimSegment += 1;
+        c_Inbox.u64_ClaimOffset = 0;
+    }
+    
+    // Id 0 is invalid, offset by 1
+    u64_MessageID = ((c_Inbox.u64_ClaimSegment << 32) | c_Inbox.u64_ClaimOffset) + 1;
+    c_Inbox.u64_ClaimOffset += sizeof(uint32_t) + v_Message.size();
+    
+    Claim& c_Claim = c_Inbox.m_Claim[u64_MessageID];
+    c_Claim.u64_EndSegment = c_Inbox.u64_ClaimSegment;
+    c_Claim.u64_EndOffset = c_Inbox.u64_ClaimOffset;
+    c_Claim.c_Expire = c_Expire;
+    c_Claim.b_Acknowledged = false;
+    
+    return true;
+}
+
+void LogStore::AcknowledgeMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, uint64_t u64_MessageID)
+{
+    std::shared_ptr<Inbox> p_Inbox = GetInbox(InboxKey(u32_UserID, s_DeviceKey, u8_ActorType), false);
+    
+    if (p_Inbox == NULL)
+    {
+        return;
+    }
+    
+    {
+        Inbox& c_Inbox = *p_Inbox;
+        std::lock_guard<std::mutex> c_Guard(c_Inbox.c_Mutex);
+        
+        auto Claimed = c_Inbox.m_Claim.find(u64_MessageID);
+        
+        if (Claimed == c_Inbox.m_Claim.end())
+        {
+            return;
+        }
+        
+        Claimed->second.b_Acknowledged = true;
+        
+        // Cursor moves to the first unacknowledged message
+        if (Claimed != c_Inbox.m_Claim.begin())
+        {
+            return;
+        }
+        
+        while (c_Inbox.m_Claim.size() > 0 && c_Inbox.m_Claim.begin()->second.b_Acknowledged == true)
+        {
+            c_Inbox.m_Claim.erase(c_Inbox.m_Claim.begin());
+        }
+        
+        if (c_Inbox.m_Claim.size() > 0)
+        {
+            uint64_t u64_Position = c_Inbox.m_Claim.begin()->first - 1;
+            
+            c_Inbox.u64_ReadSegment = u64_Position >> 32;
+            c_Inbox.u64_ReadOffset = u64_Position & 0xFFFFFFFF;
+        }
+        else
+        {
+            // Includes skipped unreadable segments
+            c_Inbox.u64_ReadSegment = c_Inbox.u64_ClaimSegment;
+            c_Inbox.u64_ReadOffset = c_Inbox.u64_ClaimOffset;
+        }
+        
+        // Consumed by moving the cursor, segments are removed on compaction
+        WriteCursor(c_Inbox);
+        
+        if (i_SyncIntervalMS <= 0)
+        {
+            fdatasync(c_Inbox.i_CursorFD);
+            return;
+        }
+    }
+    
+    // Cursor is synced with the next group commit
+    std::lock_guard<std::mutex> c_Guard(c_SyncMutex);
+    
+    if (p_Inbox->b_Dirty == false)
+    {
+        p_Inbox->b_Dirty = true;
+        l_Dirty.emplace_back(p_Inbox);
+    }
+}
+
+void LogStore::StoreMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message)
+{
+    WaitSync(AppendMessage(InboxKey(u32_UserID, s_DeviceKey, u8_ActorType), v_Message));
+}
+
+void LogStore::StoreFanOutMessage(uint32_t u32_UserID, std::vector<std::string> const& v_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message)
+{
+    uint64_t u64_Ticket = 0;
+    
+    // @NOTE: Inboxes are separate logs, but all appends share the
+    //        same group commit.
+    for (auto& DeviceKey : v_DeviceKey)
+    {
+        u64_Ticket = AppendMessage(InboxKey(u32_UserID, DeviceKey, u8_ActorType), v_Message);
+    }
+    
+    WaitSync(u64_Ticket);
+}
+
+//*************************************************************************************
+// Append
+//*************************************************************************************
+
+uint64_t LogStore::AppendMessage(InboxKey const& c_Key, std::vector<uint8_t> const& v_Message)
+{
+    if (v_Message.size() <= 1)
+    {
+        throw Exception("Message has no data!");
+    }
+    else if (v_Message.size() > LOG_STORE_SEGMENT_SIZE - sizeof(uint32_t))
+    {
+        throw Exception("Message data too large to store!");
+    }
+    
+    std::shared_ptr<Inbox> p_Inbox = GetInbox(c_Key, true);
+    
+    {
+        Inbox& c_Inbox = *p_Inbox;
+        std::lock_guard<std::mutex> c_Guard(c_Inbox.c_Mutex);
+        
+        // Size prefixed message, written as a single append
+        uint32_t u32_Size = static_cast<uint32_t>(v_Message.size());
+        std::vector<uint8_t> v_Record(sizeof(u32_Size) + v_Message.size());
+        
+        std::memcpy(&(v_Record[0]), &u32_Size, sizeof(u32_Size));
+        std::memcpy(&(v_Record[sizeof(u32_Size)]), v_Message.data(), v_Message.size());
+        
+        if (c_Inbox.i_WriteFD < 0 || c_Inbox.u64_WriteOffset + v_Record.size() > LOG_STORE_SEGMENT_SIZE)
+        {
+            OpenSegment(c_Inbox);
+        }
+        
+        uint64_t u64_Position = ((c_Inbox.u64_WriteSegment << 32) | c_Inbox.u64_WriteOffset) + 1;
+        
+        for (size_t us_Written = 0; us_Written < v_Record.size();)
+        {
+            ssize_t ss_Result = pwrite(c_Inbox.i_WriteFD,
+                                       &(v_Record[us_Written]),
+                                       v_Record.size() - us_Written,
+                                       c_Inbox.u64_WriteOffset + us_Written);
+            
+            if (ss_Result < 0 && errno != EINTR)
+            {
+                std::string s_Error = GetErrorString();
+                
+                // Drop the partial message
+                ftruncate(c_Inbox.i_WriteFD, c_Inbox.u64_WriteOffset);
+                
+                throw Exception("Failed to write inbox segment: " + s_Error);
+            }
+            else if (ss_Result > 0)
+            {
+                us_Written += ss_Result;
+            }
+        }
+        
+        c_Inbox.u64_WriteOffset += v_Record.size();
+        
+        if (KeepLatest(v_Message) == true)
+        {
+            c_Inbox.m_Latest[v_Message[NetMessage::us_IDPos]] = u64_Position;
+        }
+        
+        if (i_SyncIntervalMS <= 0)
+        {
+            fdatasync(c_Inbox.i_WriteFD);
+            return 0;
+        }
+    }
+    
+    // Group commit, the next sync includes our write
+    std::lock_guard<std::mutex> c_Guard(c_SyncMutex);
+    
+    if (p_Inbox->b_Dirty == false)
+    {
+        p_Inbox->b_Dirty = true;
+        l_Dirty.emplace_back(p_Inbox);
+    }
+    
+    return ++u64_WriteTicket;
+}
+
+void LogStore::WaitSync(uint64_t u64_Ticket)
+{
+    if (u64_Ticket == 0)
+    {
+        return;
+    }
+    
+    std::unique_lock<std::mutex> c_Lock(c_SyncMutex);
+    
+    c_SyncCondition.wait(c_Lock, [this, u64_Ticket]
+    {
+        return u64_SyncedTicket >= u64_Ticket || b_Run == false;
+    });
+}
+
+//*************************************************************************************
+// Update
+//*************************************************************************************
+
+void LogStore::Update(LogStore* p_Instance) noexcept
+{
+    auto CompactTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(LOG_STORE_COMPACT_INTERVAL_MS);
+    int i_WaitMS = p_Instance->i_SyncIntervalMS > 0 ? p_Instance->i_SyncIntervalMS : LOG_STORE_COMPACT_INTERVAL_MS;
+    bool b_Run = true;
+    
+    while (b_Run == true)
+    {
+        std::list<std::shared_ptr<Inbox>> l_Sync;
+        uint64_t u64_Ticket;
+        
+        // Grab everything written since the last sync
+        {
+            std::unique_lock<std::mutex> c_Lock(p_Instance->c_SyncMutex);
+            
+            p_Instance->c_UpdateCondition.wait_for(c_Lock, std::chrono::milliseconds(i_WaitMS), [p_Instance]
+            {
+                return p_Instance->b_Run == false;
+            });
+            
+            b_Run = p_Instance->b_Run;
+            u64_Ticket = p_Instance->u64_WriteTicket;
+            l_Sync.swap(p_Instance->l_Dirty);
+            
+            for (auto& Entry : l_Sync)
+            {
+                Entry->b_Dirty = false;
+            }
+        }
+        
+        // One sync for all writes in the interval
+        for (auto& Entry : l_Sync)
+        {
+            SyncInbox(*Entry);
+        }
+        
+        {
+            std::lock_guard<std::mutex> c_Guard(p_Instance->c_SyncMutex);
+            p_Instance->u64_SyncedTicket = u64_Ticket;
+        }
+        
+        p_Instance->c_SyncCondition.notify_all();
+        
+        // Compact every once in a while
+        if (b_Run == false || std::chrono::steady_clock::now() < CompactTime)
+        {
+            continue;
+        }
+        
+        for (size_t i = 0; i < LOG_STORE_SHARD_COUNT; ++i)
+        {
+            std::list<std::shared_ptr<Inbox>> l_Inbox;
+            
+            {
+                InboxShard& c_Shard = p_Instance->p_InboxShard[i];
+                std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+                
+                for (auto& Entry : c_Shard.m_Inbox)
+                {
+                    l_Inbox.emplace_back(Entry.second);
+                }
+            }
+            
+            for (auto& Entry : l_Inbox)
+            {
+                CompactInbox(*Entry);
+            }
+        }
+        
+        CompactTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(LOG_STORE_COMPACT_INTERVAL_MS);
+    }
+}
+
+void LogStore::SyncInbox(Inbox& c_Inbox) noexcept
+{
+    std::lock_guard<std::mutex> c_Guard(c_Inbox.c_Mutex);
+    
+    if (c_Inbox.i_WriteFD >= 0)
+    {
+        fdatasync(c_Inbox.i_WriteFD);
+    }
+    
+    if (c_Inbox.i_CursorFD >= 0)
+    {
+        fdatasync(c_Inbox.i_CursorFD);
+    }
+}
+
+void LogStore::CompactInbox(Inbox& c_Inbox) noexcept
+{
+    std::lock_guard<std::mutex> c_Guard(c_Inbox.c_Mutex);
+    
+    // Segments before the cursor are fully consumed
+    for (; c_Inbox.u64_FirstSegment < c_Inbox.u64_ReadSegment; ++(c_Inbox.u64_FirstSegment))
+    {
+        unlink(GetSegmentPath(c_Inbox, c_Inbox.u64_FirstSegment).c_str());
+    }
+    
+    // Empty segments are already compacted
+    if (c_Inbox.i_WriteFD < 0 ||
+        c_Inbox.u64_WriteOffset == 0 ||
+        c_Inbox.u64_ReadSegment != c_Inbox.u64_WriteSegment ||
+        c_Inbox.u64_ReadOffset < c_Inbox.u64_WriteOffset)
+    {
+        return;
+    }
+    
+    // Nothing left to read, release the files until the next message
+    // @NOTE: The next segment is kept as a empty marker, message ids contain
+    //        the segment number and never repeat after a restart. The marker
+    //        is written first, a cursor without segments is ignored on load.
+    std::string s_MarkerPath = GetSegmentPath(c_Inbox, c_Inbox.u64_WriteSegment + 1);
+    int i_MarkerFD = open(s_MarkerPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    
+    if (i_MarkerFD < 0)
+    {
+        // Retried with the next compaction
+        return;
+    }
+    
+    close(i_MarkerFD);
+    SyncDirectory(c_Inbox.s_DirectoryPath);
+    UnmapSegment(c_Inbox);
+    
+    close(c_Inbox.i_WriteFD);
+    unlink(GetSegmentPath(c_Inbox, c_Inbox.u64_WriteSegment).c_str());
+    
+    if (c_Inbox.i_CursorFD >= 0)
+    {
+        close(c_Inbox.i_CursorFD);
+    }
+    
+    unlink((c_Inbox.s_DirectoryPath + "/" + p_CursorFileName).c_str());
+    
+    c_Inbox.i_WriteFD = -1;
+    c_Inbox.i_CursorFD = -1;
+    c_Inbox.u64_WriteSegment += 1;
+    c_Inbox.u64_WriteOffset = 0;
+    c_Inbox.u64_FirstSegment = c_Inbox.u64_WriteSegment;
+    c_Inbox.u64_ReadSegment = c_Inbox.u64_WriteSegment;
+    c_Inbox.u64_ReadOffset = 0;
+    c_Inbox.u64_ClaimSegment = c_Inbox.u64_WriteSegment;
+    c_Inbox.u64_ClaimOffset = 0;
+}
@@ -0,0 +1,386 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef LogStore_h
+#define LogStore_h
+
+// C / C++
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <list>
+#include <map>
+#include <unordered_map>
+
+// External
+
+// Project
+#include "../MessageStore.h"
+#include "../InboxKey.h"
+
+// Pre-defined
+#ifndef LOG_STORE_SHARD_COUNT
+    #define LOG_STORE_SHARD_COUNT 64
+#endif
+#ifndef LOG_STORE_SEGMENT_SIZE
+    #define LOG_STORE_SEGMENT_SIZE (4 * 1024 * 1024)
+#endif
+#ifndef LOG_STORE_COMPACT_INTERVAL_MS
+    #define LOG_STORE_COMPACT_INTERVAL_MS 10000
+#endif
+
+
+class LogStore : public MessageStore
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     *
+     *  \param s_DirectoryPath The full path to the log directory.
+     *  \param i_SyncIntervalMS The group commit interval. Every write is synced on its
+     *                          own if 0 or less.
+     */
+    
+    LogStore(std::string const& s_DirectoryPath,
+             int i_SyncIntervalMS);
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~LogStore() noexcept;
+    
+    //*************************************************************************************
+    // Message
+    //*************************************************************************************
+    
+    /**
+     *  Claim the next stored message for a recipient. This function is
+     *  thread safe.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to write.
+     *  \param u64_MessageID The id of the claimed message to write.
+     *
+     *  \return true if a message was retrieved, false if not.
+     */
+    
+    bool RetrieveMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID) override;
+    
+    /**
+     *  Remove a claimed message after it was delivered. This function is thread
+     *  safe.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param u64_MessageID The id of the claimed message.
+     */
+    
+    void AcknowledgeMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, uint64_t u64_MessageID) override;
+    
+    /**
+     *  Append a message for a recipient. This function is thread safe and returns once
+     *  the message was synced to disk.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to store.
+     */
+    
+    void StoreMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message) override;
+    
+    /**
+     *  Store a message once for all devices of a recipient. Appended to every
+     *  device inbox with a single sync wait. This function is thread safe.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param v_DeviceKey The device keys of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to store.
+     */
+    
+    void StoreFanOutMessage(uint32_t u32_UserID, std::vector<std::string> const& v_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message) override;
+    
+private:
+    
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    struct Claim
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        uint64_t u64_EndSegment;
+        uint64_t u64_EndOffset;
+        std::chrono::steady_clock::time_point c_Expire;
+        bool b_Acknowledged;
+    };
+    
+    // @NOTE: Every inbox is a directory of numbered, append-only segment files
+    //        containing size prefixed messages. The cursor file stores the
+    //        segment and offset of the first unacknowledged message, claims
+    //        only exist in memory and are retrieved again after a restart.
+    //        Compacted inboxes keep a empty segment, so that message ids
+    //        (segment and offset) stay unique across restarts.
+    //        Replaced messages are only known since the start and skipped
+    //        on retrieval.
+    struct Inbox
+    {
+    public:
+        
+        //*************************************************************************************
+        // Constructor / Destructor
+        //*************************************************************************************
+        
+        /**
+         *  Default constructor.
+         *
+         *  \param s_DirectoryPath The full path to the inbox directory.
+         */
+        
+        Inbox(std::string const& s_DirectoryPath) noexcept;
+        
+        /**
+         *  Default destructor.
+         */
+        
+        ~Inbox() noexcept;
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        std::mutex c_Mutex;
+        std::string s_DirectoryPath;
+        
+        // Write
+        int i_WriteFD;
+        uint64_t u64_WriteSegment;
+        uint64_t u64_WriteOffset;
+        
+        // Read
+        int i_CursorFD;
+        uint64_t u64_FirstSegment;
+        uint64_t u64_ReadSegment;
+        uint64_t u64_ReadOffset;
+        
+        // Claim, message ids are the claimed position
+        uint64_t u64_ClaimSegment;
+        uint64_t u64_ClaimOffset;
+        std::map<uint64_t, Claim> m_Claim;
+        
+        // Newest message id per replacing message type, older ones are skipped
+        std::unordered_map<uint8_t, uint64_t> m_Latest;
+        
+        // Mapping at segment capacity, end is the file size when mapped
+        uint8_t* p_Map;
+        size_t us_MapSize;
+        uint64_t u64_MapEnd;
+        uint64_t u64_MapSegment;
+        
+        // Sync, guarded by the store sync mutex
+        bool b_Dirty;
+    };
+    
+    struct InboxShard
+    {
+        std::mutex c_Mutex;
+        std::unordered_map<InboxKey, std::shared_ptr<Inbox>, InboxKeyHash> m_Inbox;
+    };
+    
+    //*************************************************************************************
+    // Inbox
+    //*************************************************************************************
+    
+    /**
+     *  Get a inbox.
+     *
+     *  \param c_Key The inbox key.
+     *  \param b_Create If the inbox should be created if missing.
+     *
+     *  \return The inbox on success, NULL if not found.
+     */
+    
+    std::shared_ptr<Inbox> GetInbox(InboxKey const& c_Key, bool b_Create);
+    
+    /**
+     *  Load all existing inboxes from the log directory.
+     */
+    
+    void LoadInboxes();
+    
+    /**
+     *  Load the segments and cursor of a inbox, removing incomplete writes.
+     *
+     *  \param c_Inbox The inbox to load.
+     */
+    
+    static void LoadInbox(Inbox& c_Inbox);
+    
+    //*************************************************************************************
+    // Segment
+    //*************************************************************************************
+    
+    /**
+     *  Get the full path of a inbox segment file.
+     *
+     *  \param c_Inbox The inbox of the segment.
+     *  \param u64_Segment The segment number.
+     *
+     *  \return The full segment file path.
+     */
+    
+    static std::string GetSegmentPath(Inbox const& c_Inbox, uint64_t u64_Segment) noexcept;
+    
+    /**
+     *  Open the write segment of a inbox. A full segment is synced and closed before
+     *  the next one is created.
+     *
+     *  \param c_Inbox The inbox to open the segment for.
+     */
+    
+    static void OpenSegment(Inbox& c_Inbox);
+    
+    /**
+     *  Map a segment of a inbox.
+     *
+     *  \param c_Inbox The inbox to map for.
+     *  \param u64_Segment The segment number.
+     */
+    
+    static void MapSegment(Inbox& c_Inbox, uint64_t u64_Segment) noexcept;
+    
+    /**
+     *  Unmap the mapped segment of a inbox.
+     *
+     *  \param c_Inbox The inbox to unmap for.
+     */
+    
+    static void UnmapSegment(Inbox& c_Inbox) noexcept;
+    
+    /**
+     *  Read a message from a inbox segment.
+     *
+     *  \param c_Inbox The inbox to read from.
+     *  \param u64_Segment The segment number.
+     *  \param u64_Offset The message offset in the segment.
+     *  \param v_Message The full net message buffer to write.
+     *
+     *  \return true if a message was read, false if the segment ended.
+     */
+    
+    static bool ReadMessage(Inbox& c_Inbox, uint64_t u64_Segment, uint64_t u64_Offset, std::vector<uint8_t>& v_Message);
+    
+    /**
+     *  Write the read cursor of a inbox.
+     *
+     *  \param c_Inbox The inbox to write the cursor for.
+     */
+    
+    static void WriteCursor(Inbox& c_Inbox);
+    
+    //*************************************************************************************
+    // Append
+    //*************************************************************************************
+    
+    /**
+     *  Append a message to a inbox.
+     *
+     *  \param c_Key The inbox key.
+     *  \param v_Message The full net message buffer to append.
+     *
+     *  \return The sync ticket to wait for, 0 if already synced.
+     */
+    
+    uint64_t AppendMessage(InboxKey const& c_Key, std::vector<uint8_t> const& v_Message);
+    
+    /**
+     *  Wait until a append was synced to disk.
+     *
+     *  \param u64_Ticket The sync ticket of the append.
+     */
+    
+    void WaitSync(uint64_t u64_Ticket);
+    
+    //*************************************************************************************
+    // Update
+    //*************************************************************************************
+    
+    /**
+     *  Run the sync and compaction update.
+     *
+     *  \param p_Instance The log store instance to update with.
+     */
+    
+    static void Update(LogStore* p_Instance) noexcept;
+    
+    /**
+     *  Sync the segment and cursor of a inbox to disk.
+     *
+     *  \param c_Inbox The inbox to sync.
+     */
+    
+    static void SyncInbox(Inbox& c_Inbox) noexcept;
+    
+    /**
+     *  Remove consumed segments of a inbox. Fully consumed inboxes are reset.
+     *
+     *  \param c_Inbox The inbox to compact.
+     */
+    
+    static void CompactInbox(Inbox& c_Inbox) noexcept;
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    InboxShard p_InboxShard[LOG_STORE_SHARD_COUNT];
+    std::string s_DirectoryPath;
+    
+    // Sync
+    int i_SyncIntervalMS;
+    std::mutex c_SyncMutex;
+    std::condition_variable c_SyncCondition;
+    std::condition_variable c_UpdateCondition;
+    std::list<std::shared_ptr<Inbox>> l_Dirty;
+    uint64_t u64_WriteTicket;
+    uint64_t u64_SyncedTicket;
+    
+    std::atomic<bool> b_Run;
+    std::thread c_Thread;
+    
+protected:
+
+};
+
+#endif /* LogStore_h */
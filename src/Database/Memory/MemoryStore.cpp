@@ -0,0 +1,359 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <algorithm>
+
+// External
+
+// Project
+#include "./MemoryStore.h"
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+MemoryStore::MemoryStore() noexcept : MessageStore(),
+                                      AccountStore(),
+                                      u32_NextUserID(1), // Same as auto increment
+                                      u64_NextMessageID(1)
+{}
+
+MemoryStore::~MemoryStore() noexcept
+{}
+
+//*************************************************************************************
+// Shard
+//*************************************************************************************
+
+MemoryStore::InboxShard& MemoryStore::GetShard(InboxKey const& c_Key) noexcept
+{
+    return p_InboxShard[InboxKeyHash()(c_Key) % MEMORY_STORE_SHARD_COUNT];
+}
+
+MemoryStore::MailShard& MemoryStore::GetShard(std::string const& s_Mail) noexcept
+{
+    return p_MailShard[std::hash<std::string>()(s_Mail) % MEMORY_STORE_SHARD_COUNT];
+}
+
+MemoryStore::UserShard& MemoryStore::GetShard(uint32_t u32_UserID) noexcept
+{
+    return p_UserShard[u32_UserID % MEMORY_STORE_SHARD_COUNT];
+}
+
+//*************************************************************************************
+// Message
+//*************************************************************************************
+
+bool MemoryStore::RetrieveMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID)
+{
+    InboxKey c_Key(u32_UserID, s_DeviceKey, u8_ActorType);
+    InboxShard& c_Shard = GetShard(c_Key);
+    
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    auto Inbox = c_Shard.m_Inbox.find(c_Key);
+    
+    if (Inbox == c_Shard.m_Inbox.end())
+    {
+        return false;
+    }
+    
+    // Oldest message without a active claim
+    auto c_Time = std::chrono::steady_clock::now();
+    
+    for (auto& Message : Inbox->second)
+    {
+        if (Message.c_ClaimExpire > c_Time)
+        {
+            continue;
+        }
+        
+        Message.c_ClaimExpire = c_Time + std::chrono::seconds(MESSAGE_STORE_CLAIM_TIMEOUT_S);
+        
+        v_Message = *(Message.p_Data);
+        u64_MessageID = Message.u64_MessageID;
+        
+        return true;
+    }
+    
+    return false;
+}
+
+void MemoryStore::AcknowledgeMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, uint64_t u64_MessageID)
+{
+    InboxKey c_Key(u32_UserID, s_DeviceKey, u8_ActorType);
+    InboxShard& c_Shard = GetShard(c_Key);
+    
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    auto Inbox = c_Shard.m_Inbox.find(c_Key);
+    
+    if (Inbox == c_Shard.m_Inbox.end())
+    {
+        return;
+    }
+    
+    for (auto It = Inbox->second.begin(); It != Inbox->second.end(); ++It)
+    {
+        if (It->u64_MessageID == u64_MessageID)
+        {
+            Inbox->second.erase(It);
+            break;
+        }
+    }
+    
+    // Remove empty inboxes, keeps the map small
+    if (Inbox->second.size() == 0)
+    {
+        c_Shard.m_Inbox.erase(Inbox);
+    }
+}
+
+void MemoryStore::StoreMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message)
+{
+    if (v_Message.size() <= 1)
+    {
+        throw Exception("Message has no data!");
+    }
+    
+    InboxKey c_Key(u32_UserID, s_DeviceKey, u8_ActorType);
+    InboxShard& c_Shard = GetShard(c_Key);
+    
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    std::deque<Message>& dq_Message = c_Shard.m_Inbox[c_Key];
+    
+    RemoveReplaced(dq_Message, v_Message);
+    dq_Message.emplace_back();
+    
+    Message& c_Message = dq_Message.back();
+    c_Message.u64_MessageID = u64_NextMessageID++;
+    c_Message.p_Data = std::make_shared<const std::vector<uint8_t>>(v_Message);
+}
+
+void MemoryStore::StoreFanOutMessage(uint32_t u32_UserID, std::vector<std::string> const& v_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message)
+{
+    if (v_Message.size() <= 1)
+    {
+        throw Exception("Message has no data!");
+    }
+    
+    // One copy and id, every device acknowledges its own entry
+    std::shared_ptr<const std::vector<uint8_t>> p_Data = std::make_shared<const std::vector<uint8_t>>(v_Message);
+    uint64_t u64_MessageID = u64_NextMessageID++;
+    
+    for (auto& DeviceKey : v_DeviceKey)
+    {
+        InboxKey c_Key(u32_UserID, DeviceKey, u8_ActorType);
+        InboxShard& c_Shard = GetShard(c_Key);
+        
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        std::deque<Message>& dq_Message = c_Shard.m_Inbox[c_Key];
+        
+        RemoveReplaced(dq_Message, v_Message);
+        dq_Message.emplace_back();
+        
+        Message& c_Message = dq_Message.back();
+        c_Message.u64_MessageID = u64_MessageID;
+        c_Message.p_Data = p_Data;
+    }
+}
+
+//*************************************************************************************
+// Retention
+//*************************************************************************************
+
+void MemoryStore::RemoveReplaced(std::deque<Message>& dq_Message, std::vector<uint8_t> const& v_Message) noexcept
+{
+    if (KeepLatest(v_Message) == false)
+    {
+        return;
+    }
+    
+    // @NOTE: Claimed messages might be in delivery, they stay
+    auto c_Time = std::chrono::steady_clock::now();
+    uint8_t u8_Type = v_Message[NetMessage::us_IDPos];
+    
+    dq_Message.erase(std::remove_if(dq_Message.begin(), dq_Message.end(), [c_Time, u8_Type](Message const& c_Message)
+    {
+        return c_Message.c_ClaimExpire <= c_Time && (*(c_Message.p_Data))[NetMessage::us_IDPos] == u8_Type;
+    }), dq_Message.end());
+}
+
+//*************************************************************************************
+// Account
+//*************************************************************************************
+
+bool MemoryStore::GetAccount(std::string const& s_Mail, uint32_t& u32_UserID, std::string& s_Password)
+{
+    uint32_t u32_ID;
+    
+    // Mail to user id first
+    {
+        MailShard& c_Shard = GetShard(s_Mail);
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        auto Mail = c_Shard.m_UserID.find(s_Mail);
+        
+        if (Mail == c_Shard.m_UserID.end())
+        {
+            return false;
+        }
+        
+        u32_ID = Mail->second;
+    }
+    
+    // Now the account info
+    UserShard& c_Shard = GetShard(u32_ID);
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    auto User = c_Shard.m_User.find(u32_ID);
+    
+    if (User == c_Shard.m_User.end())
+    {
+        // Removed in between
+        return false;
+    }
+    
+    u32_UserID = u32_ID;
+    s_Password = User->second.s_Password;
+    
+    return true;
+}
+
+void MemoryStore::GetAccounts(std::vector<Account>& v_Account)
+{
+    v_Account.clear();
+    
+    for (size_t i = 0; i < MEMORY_STORE_SHARD_COUNT; ++i)
+    {
+        UserShard& c_Shard = p_UserShard[i];
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        for (auto& User : c_Shard.m_User)
+        {
+            v_Account.emplace_back();
+            
+            Account& c_Account = v_Account.back();
+            c_Account.u32_UserID = User.first;
+            c_Account.s_Mail = User.second.s_Mail;
+            c_Account.s_Password = User.second.s_Password;
+            c_Account.v_DeviceKey.assign(User.second.us_DeviceKey.begin(),
+                                         User.second.us_DeviceKey.end());
+        }
+    }
+}
+
+void MemoryStore::CreateAccount(std::string const& s_Mail, std::string const& s_Password)
+{
+    uint32_t u32_UserID = u32_NextUserID++;
+    
+    // Reserve the mail address first
+    {
+        MailShard& c_Shard = GetShard(s_Mail);
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        if (c_Shard.m_UserID.find(s_Mail) != c_Shard.m_UserID.end())
+        {
+            throw Exception("Account mail address already in use!");
+        }
+        
+        c_Shard.m_UserID.emplace(s_Mail, u32_UserID);
+    }
+    
+    UserShard& c_Shard = GetShard(u32_UserID);
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    User& c_User = c_Shard.m_User[u32_UserID];
+    c_User.s_Mail = s_Mail;
+    c_User.s_Password = s_Password;
+}
+
+void MemoryStore::RemoveAccount(uint32_t u32_UserID)
+{
+    std::string s_Mail;
+    
+    {
+        UserShard& c_Shard = GetShard(u32_UserID);
+        std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+        
+        auto User = c_Shard.m_User.find(u32_UserID);
+        
+        if (User == c_Shard.m_User.end())
+        {
+            return;
+        }
+        
+        s_Mail = User->second.s_Mail;
+        c_Shard.m_User.erase(User);
+    }
+    
+    MailShard& c_Shard = GetShard(s_Mail);
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    c_Shard.m_UserID.erase(s_Mail);
+}
+
+//*************************************************************************************
+// Device
+//*************************************************************************************
+
+void MemoryStore::GetDevices(uint32_t u32_UserID, std::vector<std::string>& v_DeviceKey)
+{
+    UserShard& c_Shard = GetShard(u32_UserID);
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    auto User = c_Shard.m_User.find(u32_UserID);
+    
+    v_DeviceKey.clear();
+    
+    if (User != c_Shard.m_User.end())
+    {
+        v_DeviceKey.assign(User->second.us_DeviceKey.begin(),
+                           User->second.us_DeviceKey.end());
+    }
+}
+
+void MemoryStore::AddDevice(uint32_t u32_UserID, std::string const& s_DeviceKey)
+{
+    UserShard& c_Shard = GetShard(u32_UserID);
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    auto User = c_Shard.m_User.find(u32_UserID);
+    
+    if (User == c_Shard.m_User.end())
+    {
+        throw Exception("Unknown user id!");
+    }
+    
+    User->second.us_DeviceKey.insert(s_DeviceKey);
+}
+
+void MemoryStore::RemoveDevice(uint32_t u32_UserID, std::string const& s_DeviceKey)
+{
+    UserShard& c_Shard = GetShard(u32_UserID);
+    std::lock_guard<std::mutex> c_Guard(c_Shard.c_Mutex);
+    
+    auto User = c_Shard.m_User.find(u32_UserID);
+    
+    if (User != c_Shard.m_User.end())
+    {
+        User->second.us_DeviceKey.erase(s_DeviceKey);
+    }
+}
@@ -0,0 +1,303 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef MemoryStore_h
+#define MemoryStore_h
+
+// C / C++
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
+// External
+
+// Project
+#include "../MessageStore.h"
+#include "../AccountStore.h"
+#include "../InboxKey.h"
+
+// Pre-defined
+#ifndef MEMORY_STORE_SHARD_COUNT
+    #define MEMORY_STORE_SHARD_COUNT 64
+#endif
+
+
+class MemoryStore : public MessageStore,
+                    public AccountStore
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     */
+    
+    MemoryStore() noexcept;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~MemoryStore() noexcept;
+    
+    //*************************************************************************************
+    // Message
+    //*************************************************************************************
+    
+    /**
+     *  Claim the next stored message for a recipient. This function is
+     *  thread safe.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to write.
+     *  \param u64_MessageID The id of the claimed message to write.
+     *
+     *  \return true if a message was retrieved, false if not.
+     */
+    
+    bool RetrieveMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID) override;
+    
+    /**
+     *  Remove a claimed message after it was delivered. This function is thread
+     *  safe.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param u64_MessageID The id of the claimed message.
+     */
+    
+    void AcknowledgeMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, uint64_t u64_MessageID) override;
+    
+    /**
+     *  Store a message for a recipient. This function is thread safe.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to store.
+     */
+    
+    void StoreMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message) override;
+    
+    /**
+     *  Store a message once for all devices of a recipient. The message data
+     *  is shared by all device inboxes. This function is thread safe.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param v_DeviceKey The device keys of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to store.
+     */
+    
+    void StoreFanOutMessage(uint32_t u32_UserID, std::vector<std::string> const& v_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message) override;
+    
+    //*************************************************************************************
+    // Account
+    //*************************************************************************************
+    
+    /**
+     *  Get a user account by mail address. This function is thread safe.
+     *
+     *  \param s_Mail The account mail address.
+     *  \param u32_UserID The user id to write.
+     *  \param s_Password The base64 password salt and key to write.
+     *
+     *  \return true if the account was found, false if not.
+     */
+    
+    bool GetAccount(std::string const& s_Mail, uint32_t& u32_UserID, std::string& s_Password) override;
+    
+    /**
+     *  Get all user accounts with their devices. This function is thread safe.
+     *
+     *  \param v_Account The accounts to write.
+     */
+    
+    void GetAccounts(std::vector<Account>& v_Account) override;
+    
+    /**
+     *  Create a user account. This function is thread safe.
+     *
+     *  \param s_Mail The account mail address.
+     *  \param s_Password The base64 password salt and key.
+     */
+    
+    void CreateAccount(std::string const& s_Mail, std::string const& s_Password) override;
+    
+    /**
+     *  Remove a user account. This function is thread safe.
+     *
+     *  \param u32_UserID The user id of the account.
+     */
+    
+    void RemoveAccount(uint32_t u32_UserID) override;
+    
+    //*************************************************************************************
+    // Device
+    //*************************************************************************************
+    
+    /**
+     *  Get all devices registered for a user. This function is thread safe.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param v_DeviceKey The device keys to write.
+     */
+    
+    void GetDevices(uint32_t u32_UserID, std::vector<std::string>& v_DeviceKey) override;
+    
+    /**
+     *  Add a device for a user. This function is thread safe.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param s_DeviceKey The device key to add.
+     */
+    
+    void AddDevice(uint32_t u32_UserID, std::string const& s_DeviceKey) override;
+    
+    /**
+     *  Remove a device from a user. This function is thread safe.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param s_DeviceKey The device key to remove.
+     */
+    
+    void RemoveDevice(uint32_t u32_UserID, std::string const& s_DeviceKey) override;
+    
+private:
+    
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    struct Message
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        uint64_t u64_MessageID;
+        std::shared_ptr<const std::vector<uint8_t>> p_Data; // Shared by fan-out inboxes
+        std::chrono::steady_clock::time_point c_ClaimExpire; // Unclaimed if passed
+    };
+    
+    struct User
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        std::string s_Mail;
+        std::string s_Password;
+        std::unordered_set<std::string> us_DeviceKey;
+    };
+    
+    // @NOTE: Every shard has its own lock, so that threads only wait for
+    //        others working on keys in the same shard.
+    struct InboxShard
+    {
+        std::mutex c_Mutex;
+        std::unordered_map<InboxKey, std::deque<Message>, InboxKeyHash> m_Inbox;
+    };
+    
+    struct MailShard
+    {
+        std::mutex c_Mutex;
+        std::unordered_map<std::string, uint32_t> m_UserID;
+    };
+    
+    struct UserShard
+    {
+        std::mutex c_Mutex;
+        std::unordered_map<uint32_t, User> m_User;
+    };
+    
+    //*************************************************************************************
+    // Shard
+    //*************************************************************************************
+    
+    /**
+     *  Get the inbox shard for a key.
+     *
+     *  \param c_Key The inbox key.
+     *
+     *  \return The inbox shard.
+     */
+    
+    InboxShard& GetShard(InboxKey const& c_Key) noexcept;
+    
+    /**
+     *  Get the mail shard for a mail address.
+     *
+     *  \param s_Mail The account mail address.
+     *
+     *  \return The mail shard.
+     */
+    
+    MailShard& GetShard(std::string const& s_Mail) noexcept;
+    
+    /**
+     *  Get the user shard for a user id.
+     *
+     *  \param u32_UserID The user id.
+     *
+     *  \return The user shard.
+     */
+    
+    UserShard& GetShard(uint32_t u32_UserID) noexcept;
+    
+    //*************************************************************************************
+    // Retention
+    //*************************************************************************************
+    
+    /**
+     *  Remove unclaimed messages replaced by a newer message.
+     *
+     *  \param dq_Message The inbox messages.
+     *  \param v_Message The full net message buffer of the newer message.
+     */
+    
+    static void RemoveReplaced(std::deque<Message>& dq_Message, std::vector<uint8_t> const& v_Message) noexcept;
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    InboxShard p_InboxShard[MEMORY_STORE_SHARD_COUNT];
+    MailShard p_MailShard[MEMORY_STORE_SHARD_COUNT];
+    UserShard p_UserShard[MEMORY_STORE_SHARD_COUNT];
+    
+    std::atomic<uint32_t> u32_NextUserID;
+    std::atomic<uint64_t> u64_NextMessageID;
+    
+protected:
+
+};
+
+#endif /* MemoryStore_h */
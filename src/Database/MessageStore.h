@@ -0,0 +1,185 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef MessageStore_h
+#define MessageStore_h
+
+// C / C++
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// External
+
+// Project
+#include "../NetMessage/NetMessage.h"
+#include "../Exception.h"
+
+// Pre-defined
+#ifndef MESSAGE_STORE_CLAIM_TIMEOUT_S
+    #define MESSAGE_STORE_CLAIM_TIMEOUT_S 30
+#endif
+
+class MessageStore
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Copy constructor. Disabled for this class.
+     *
+     *  \param c_MessageStore MessageStore class source.
+     */
+    
+    MessageStore(MessageStore const& c_MessageStore) = delete;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    virtual ~MessageStore() noexcept
+    {}
+    
+    //*************************************************************************************
+    // Retrieve
+    //*************************************************************************************
+    
+    /**
+     *  Claim the next stored message for a recipient. A claimed message is skipped by
+     *  other retrievals until it is acknowledged or the claim timed out.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to write.
+     *  \param u64_MessageID The id of the claimed message to write.
+     *
+     *  \return true if a message was retrieved, false if not.
+     */
+    
+    virtual bool RetrieveMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID) = 0;
+    
+    /**
+     *  Remove a claimed message after it was delivered.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param u64_MessageID The id of the claimed message.
+     */
+    
+    virtual void AcknowledgeMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, uint64_t u64_MessageID) = 0;
+    
+    /**
+     *  Remove claimed messages after they were delivered. Stores able to remove
+     *  multiple messages at once override this function.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the messages.
+     *  \param v_MessageID The ids of the claimed messages.
+     */
+    
+    virtual void AcknowledgeMessages(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint64_t> const& v_MessageID)
+    {
+        for (auto& MessageID : v_MessageID)
+        {
+            AcknowledgeMessage(u32_UserID, s_DeviceKey, u8_ActorType, MessageID);
+        }
+    }
+    
+    //*************************************************************************************
+    // Store
+    //*************************************************************************************
+    
+    /**
+     *  Store a message for a recipient.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to store.
+     */
+    
+    virtual void StoreMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message) = 0;
+    
+    /**
+     *  Store a message once for all devices of a recipient. Every device retrieves
+     *  and acknowledges the message on its own.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param v_DeviceKey The device keys of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to store.
+     */
+    
+    virtual void StoreFanOutMessage(uint32_t u32_UserID, std::vector<std::string> const& v_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message) = 0;
+    
+    //*************************************************************************************
+    // Retention
+    //*************************************************************************************
+    
+    /**
+     *  Check if a message replaces older unclaimed messages of the same type for
+     *  the same recipient.
+     *
+     *  \param v_Message The full net message buffer.
+     *
+     *  \return true if only the newest message is kept, false if all are kept.
+     */
+    
+    static bool KeepLatest(std::vector<uint8_t> const& v_Message) noexcept
+    {
+        if (v_Message.size() <= NetMessage::us_IDPos)
+        {
+            return false;
+        }
+        
+        switch (v_Message[NetMessage::us_IDPos])
+        {
+            // Only the current value is of interest
+            case NetMessage::MSG_LOCATION:
+                return true;
+            
+            default:
+                return false;
+        }
+    }
+    
+private:
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+protected:
+    
+    //*************************************************************************************
+    // Constructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     */
+    
+    MessageStore() noexcept
+    {}
+};
+
+#endif /* MessageStore_h */
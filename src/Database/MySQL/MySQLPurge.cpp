@@ -0,0 +1,93 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+
+// External
+
+// Project
+#include "./MySQLPurge.h"
+#include "./MySQLStore.h"
+#include "../Database.h"
+#include "../../Logger.h"
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+MySQLPurge::MySQLPurge(JobTimer& c_JobTimer,
+                       int i_IntervalS) noexcept : c_JobTimer(c_JobTimer),
+                                                   i_IntervalS(i_IntervalS)
+{}
+
+MySQLPurge::~MySQLPurge() noexcept
+{}
+
+//*************************************************************************************
+// Schedule
+//*************************************************************************************
+
+void MySQLPurge::Schedule() noexcept
+{
+    try
+    {
+        c_JobTimer.AddJob(IntrusivePointer<Job>(this),
+                          std::chrono::steady_clock::now() + std::chrono::seconds(i_IntervalS));
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "Failed to schedule message purge: " +
+                                               std::string(e.what()),
+                                "MySQLPurge.cpp", __LINE__);
+    }
+}
+
+//*************************************************************************************
+// Perform
+//*************************************************************************************
+
+bool MySQLPurge::Perform(std::shared_ptr<ThreadShared>& p_Shared) noexcept
+{
+    MySQLStore* p_MySQLStore = dynamic_cast<MySQLStore*>(dynamic_cast<Database*>(p_Shared.get())->p_MessageStore.get());
+    
+    if (p_MySQLStore == NULL)
+    {
+        return true;
+    }
+    
+    // @NOTE: Small batches keep the locks short, leftovers are
+    //        purged on the next run.
+    try
+    {
+        for (size_t i = 0; i < MYSQL_PURGE_BATCH_COUNT; ++i)
+        {
+            if (p_MySQLStore->PurgeMessages(MYSQL_PURGE_BATCH_SIZE) < MYSQL_PURGE_BATCH_SIZE)
+            {
+                break;
+            }
+        }
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, e.what(),
+                                "MySQLPurge.cpp", __LINE__);
+    }
+    
+    Schedule();
+    
+    return true;
+}
@@ -0,0 +1,98 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef MySQLPurge_h
+#define MySQLPurge_h
+
+// C / C++
+
+// External
+
+// Project
+#include "../../Job/Job.h"
+#include "../../Job/JobTimer.h"
+
+// Pre-defined
+#ifndef MYSQL_PURGE_BATCH_SIZE
+    #define MYSQL_PURGE_BATCH_SIZE 10000
+#endif
+#ifndef MYSQL_PURGE_BATCH_COUNT
+    #define MYSQL_PURGE_BATCH_COUNT 10
+#endif
+
+
+class MySQLPurge : public Job
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     *
+     *  \param c_JobTimer The job timer to schedule the next purge with.
+     *  \param i_IntervalS The time between purges in seconds.
+     */
+    
+    MySQLPurge(JobTimer& c_JobTimer,
+               int i_IntervalS) noexcept;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~MySQLPurge() noexcept;
+    
+    //*************************************************************************************
+    // Schedule
+    //*************************************************************************************
+    
+    /**
+     *  Schedule the next purge.
+     */
+    
+    void Schedule() noexcept;
+    
+    //*************************************************************************************
+    // Perform
+    //*************************************************************************************
+    
+    /**
+     *  Remove delivered messages in batches.
+     *
+     *  \param p_Shared Thread shared data.
+     *
+     *  \return Always true.
+     */
+    
+    bool Perform(std::shared_ptr<ThreadShared>& p_Shared) noexcept override;
+    
+private:
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    JobTimer& c_JobTimer;
+    int i_IntervalS;
+    
+protected:
+
+};
+
+#endif /* MySQLPurge_h */
@@ -0,0 +1,992 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+
+// External
+
+// Project
+#include "./MySQLStore.h"
+
+// Pre-defined
+using namespace DatabaseTable;
+using namespace mysqlx;
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+MySQLStore::MySQLStore(std::string const& s_Address,
+                       int i_Port,
+                       std::string const& s_User,
+                       std::string const& s_Password,
+                       std::string const& s_Database) : MessageStore(),
+                                                        AccountStore(),
+                                                        c_Session(s_Address,
+                                                                  i_Port,
+                                                                  s_User,
+                                                                  s_Password),
+                                                        s_Database(s_Database)
+{}
+
+MySQLStore::~MySQLStore() noexcept
+{}
+
+//*************************************************************************************
+// Table
+//*************************************************************************************
+
+Table MySQLStore::GetTable(const char* p_Name)
+{
+    return c_Session.getSchema(s_Database).getTable(p_Name);
+}
+
+//*************************************************************************************
+// Message
+//*************************************************************************************
+
+bool MySQLStore::RetrieveMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID)
+{
+    uint64_t u64_Time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    uint64_t u64_Cursor = GetCursor(u32_UserID, s_DeviceKey, u8_ActorType);
+    Table c_Table = GetTable(p_MDTableName);
+    
+    Row c_Row;
+    
+    // @NOTE: Rows locked by other claims are skipped instead of waited on,
+    //        the claim itself only needs a short transaction.
+    //        Delivered rows are behind the cursor or removed.
+    c_Session.startTransaction();
+    
+    try
+    {
+        RowResult c_Result = c_Table
+                                .select(p_MDFieldName[MD_MESSAGE_ID],      /* 0 */
+                                        p_MDFieldName[MD_MESSAGE_TYPE],    /* 1 */
+                                        p_MDFieldName[MD_MESSAGE_DATA])    /* 2 */
+                                .where(std::string(p_MDFieldName[MD_USER_ID]) +
+                                       " == :valueA AND " +
+                                       p_MDFieldName[MD_DEVICE_KEY] +
+                                       " == :valueB AND " +
+                                       p_MDFieldName[MD_ACTOR_TYPE] +
+                                       " == :valueC AND " +
+                                       p_MDFieldName[MD_MESSAGE_ID] +
+                                       " > :valueD AND " +
+                                       p_MDFieldName[MD_CLAIM_EXPIRE] +
+                                       " < :valueE")
+                                .orderBy(p_MDFieldName[MD_MESSAGE_ID])
+                                .limit(1)
+                                .lockExclusive(LockContention::SKIP_LOCKED)
+                                .bind("valueA",
+                                      u32_UserID)
+                                .bind("valueB",
+                                      s_DeviceKey)
+                                .bind("valueC",
+                                      u8_ActorType)
+                                .bind("valueD",
+                                      u64_Cursor)
+                                .bind("valueE",
+                                      u64_Time)
+                                .execute();
+        
+        if (c_Result.count() == 0)
+        {
+            c_Session.commit();
+            
+            // Direct messages first, then messages for all devices
+            return RetrieveFanOutMessage(u32_UserID, s_DeviceKey, u8_ActorType, v_Message, u64_MessageID);
+        }
+        
+        c_Row = c_Result.fetchOne();
+        u64_MessageID = c_Row[0].get<uint64_t>();
+        
+        // Claim message, the cursor passes it on acknowledgement
+        // @NOTE: Invalid messages are removed directly
+        if (c_Row[2].get<bytes>().size() == 0)
+        {
+            c_Table.remove()
+                .where(std::string(p_MDFieldName[MD_MESSAGE_ID]) +
+                       " == :value")
+                .bind("value",
+                      u64_MessageID)
+                .execute();
+        }
+        else
+        {
+            c_Table.update()
+                .set(p_MDFieldName[MD_CLAIM_EXPIRE],
+                     u64_Time + MESSAGE_STORE_CLAIM_TIMEOUT_S)
+                .where(std::string(p_MDFieldName[MD_MESSAGE_ID]) +
+                       " == :value")
+                .bind("value",
+                      u64_MessageID)
+                .execute();
+        }
+        
+        c_Session.commit();
+    }
+    catch (...)
+    {
+        c_Session.rollback();
+        throw;
+    }
+    
+    GetMessage(c_Row, v_Message);
+    
+    return true;
+}
+
+bool MySQLStore::RetrieveFanOutMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID)
+{
+    uint64_t u64_Time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    Row c_Row;
+    
+    // @NOTE: The fan-out message row is shared, each device claims
+    //        with its cursor row. Only one fan-out message is claimed
+    //        per device at a time.
+    c_Session.startTransaction();
+    
+    try
+    {
+        Row c_CursorRow = LockCursor(u32_UserID, s_DeviceKey, u8_ActorType);
+        
+        if (c_CursorRow[2].get<uint64_t>() >= u64_Time)
+        {
+            c_Session.commit();
+            return false;
+        }
+        
+        RowResult c_Result = GetTable(p_MDTableName)
+                                .select(p_MDFieldName[MD_MESSAGE_ID],      /* 0 */
+                                        p_MDFieldName[MD_MESSAGE_TYPE],    /* 1 */
+                                        p_MDFieldName[MD_MESSAGE_DATA])    /* 2 */
+                                .where(std::string(p_MDFieldName[MD_USER_ID]) +
+                                       " == :valueA AND " +
+                                       p_MDFieldName[MD_DEVICE_KEY] +
+                                       " == :valueB AND " +
+                                       p_MDFieldName[MD_ACTOR_TYPE] +
+                                       " == :valueC AND " +
+                                       p_MDFieldName[MD_MESSAGE_ID] +
+                                       " > :valueD")
+                                .orderBy(p_MDFieldName[MD_MESSAGE_ID])
+                                .limit(1)
+                                .bind("valueA",
+                                      u32_UserID)
+                                .bind("valueB",
+                                      p_MDFanOutDeviceKey)
+                                .bind("valueC",
+                                      u8_ActorType)
+                                .bind("valueD",
+                                      c_CursorRow[1].get<uint64_t>())
+                                .execute();
+        
+        if (c_Result.count() == 0)
+        {
+            c_Session.commit();
+            return false;
+        }
+        
+        c_Row = c_Result.fetchOne();
+        u64_MessageID = c_Row[0].get<uint64_t>();
+        
+        GetTable(p_MCTableName)
+            .update()
+            .set(p_MCFieldName[MC_FAN_OUT_CLAIM_EXPIRE],
+                 u64_Time + MESSAGE_STORE_CLAIM_TIMEOUT_S)
+            .where(std::string(p_MCFieldName[MC_USER_ID]) +
+                   " == :valueA AND " +
+                   p_MCFieldName[MC_DEVICE_KEY] +
+                   " == :valueB AND " +
+                   p_MCFieldName[MC_ACTOR_TYPE] +
+                   " == :valueC")
+            .bind("valueA",
+                  u32_UserID)
+            .bind("valueB",
+                  s_DeviceKey)
+            .bind("valueC",
+                  u8_ActorType)
+            .execute();
+        
+        c_Session.commit();
+    }
+    catch (...)
+    {
+        c_Session.rollback();
+        throw;
+    }
+    
+    GetMessage(c_Row, v_Message);
+    
+    return true;
+}
+
+void MySQLStore::GetMessage(Row& c_Row, std::vector<uint8_t>& v_Message)
+{
+    // Message data is stored as raw bytes
+    bytes c_Bytes = c_Row[2].get<bytes>();
+    
+    if (c_Bytes.size() == 0)
+    {
+        throw Exception("Retrieved message without data!");
+    }
+    
+    v_Message.clear();
+    v_Message.reserve(c_Bytes.size() + 1);
+    v_Message.emplace_back(c_Row[1].get<uint32_t>());
+    v_Message.insert(v_Message.end(),
+                     c_Bytes.begin(),
+                     c_Bytes.end());
+}
+
+void MySQLStore::AcknowledgeMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, uint64_t u64_MessageID)
+{
+    AcknowledgeMessages(u32_UserID, s_DeviceKey, u8_ActorType, std::vector<uint64_t>(1, u64_MessageID));
+}
+
+void MySQLStore::AcknowledgeMessages(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint64_t> const& v_MessageID)
+{
+    if (v_MessageID.size() == 0)
+    {
+        return;
+    }
+    
+    std::vector<uint64_t> v_Acknowledged(v_MessageID);
+    std::sort(v_Acknowledged.begin(), v_Acknowledged.end());
+    v_Acknowledged.erase(std::unique(v_Acknowledged.begin(), v_Acknowledged.end()),
+                         v_Acknowledged.end());
+    
+    // @NOTE: The cursor row lock orders acknowledgements of a recipient.
+    //        The message range is a locking read, messages committed
+    //        into the range meanwhile are waited on instead of skipped.
+    c_Session.startTransaction();
+    
+    try
+    {
+        uint64_t u64_Cursor = LockCursor(u32_UserID, s_DeviceKey, u8_ActorType)[0].get<uint64_t>();
+        uint64_t u64_Delivered = u64_Cursor;
+        
+        // Messages directly after the cursor which were all acknowledged
+        // move the cursor, no message row is written
+        RowResult c_Result = GetTable(p_MDTableName)
+                                .select(p_MDFieldName[MD_MESSAGE_ID])      /* 0 */
+                                .where(std::string(p_MDFieldName[MD_USER_ID]) +
+                                       " == :valueA AND " +
+                                       p_MDFieldName[MD_DEVICE_KEY] +
+                                       " == :valueB AND " +
+                                       p_MDFieldName[MD_ACTOR_TYPE] +
+                                       " == :valueC AND " +
+                                       p_MDFieldName[MD_MESSAGE_ID] +
+                                       " > :valueD AND " +
+                                       p_MDFieldName[MD_MESSAGE_ID] +
+                                       " <= :valueE")
+                                .orderBy(p_MDFieldName[MD_MESSAGE_ID])
+                                .limit(v_Acknowledged.size() + 1)
+                                .lockShared()
+                                .bind("valueA",
+                                      u32_UserID)
+                                .bind("valueB",
+                                      s_DeviceKey)
+                                .bind("valueC",
+                                      u8_ActorType)
+                                .bind("valueD",
+                                      u64_Cursor)
+                                .bind("valueE",
+                                      v_Acknowledged.back())
+                                .execute();
+        
+        for (size_t us_Count = c_Result.count(); us_Count > 0; --us_Count)
+        {
+            uint64_t u64_MessageID = c_Result.fetchOne()[0].get<uint64_t>();
+            
+            if (std::binary_search(v_Acknowledged.begin(), v_Acknowledged.end(), u64_MessageID) == false)
+            {
+                break;
+            }
+            
+            u64_Delivered = u64_MessageID;
+        }
+        
+        if (u64_Delivered > u64_Cursor)
+        {
+            GetTable(p_MCTableName)
+                .update()
+                .set(p_MCFieldName[MC_MESSAGE_ID],
+                     u64_Delivered)
+                .where(std::string(p_MCFieldName[MC_USER_ID]) +
+                       " == :valueA AND " +
+                       p_MCFieldName[MC_DEVICE_KEY] +
+                       " == :valueB AND " +
+                       p_MCFieldName[MC_ACTOR_TYPE] +
+                       " == :valueC")
+                .bind("valueA",
+                      u32_UserID)
+                .bind("valueB",
+                      s_DeviceKey)
+                .bind("valueC",
+                      u8_ActorType)
+                .execute();
+        }
+        
+        // Messages acknowledged before older ones are removed directly,
+        // ids which are not messages of the recipient are fan-out messages
+        std::vector<uint64_t> v_Other;
+        
+        for (auto& MessageID : v_Acknowledged)
+        {
+            if (MessageID <= u64_Cursor || MessageID > u64_Delivered)
+            {
+                v_Other.emplace_back(MessageID);
+            }
+        }
+        
+        if (v_Other.size() > 0 && RemoveMessages(u32_UserID, s_DeviceKey, u8_ActorType, v_Other) < v_Other.size())
+        {
+            AcknowledgeFanOutMessages(u32_UserID, s_DeviceKey, u8_ActorType, v_Other);
+        }
+        
+        c_Session.commit();
+    }
+    catch (...)
+    {
+        c_Session.rollback();
+        throw;
+    }
+}
+
+size_t MySQLStore::RemoveMessages(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint64_t> const& v_MessageID)
+{
+    SqlStatement c_Statement = c_Session.sql(std::string("DELETE FROM `") +
+                                             s_Database +
+                                             "`.`" +
+                                             p_MDTableName +
+                                             "` WHERE " +
+                                             p_MDFieldName[MD_USER_ID] +
+                                             " = ? AND " +
+                                             p_MDFieldName[MD_DEVICE_KEY] +
+                                             " = ? AND " +
+                                             p_MDFieldName[MD_ACTOR_TYPE] +
+                                             " = ? AND " +
+                                             p_MDFieldName[MD_MESSAGE_ID] +
+                                             " IN (" +
+                                             GetPlaceholder(v_MessageID.size()) +
+                                             ")");
+    
+    c_Statement.bind(u32_UserID);
+    c_Statement.bind(s_DeviceKey);
+    c_Statement.bind(u8_ActorType);
+    
+    for (auto& MessageID : v_MessageID)
+    {
+        c_Statement.bind(MessageID);
+    }
+    
+    return c_Statement.execute().getAffectedItemsCount();
+}
+
+void MySQLStore::AcknowledgeFanOutMessages(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint64_t> const& v_MessageID)
+{
+    // One query finds the newest fan-out message of the user among the ids,
+    // fan-out messages are claimed in order
+    SqlStatement c_Statement = c_Session.sql(std::string("SELECT MAX(") +
+                                             p_MDFieldName[MD_MESSAGE_ID] +
+                                             ") FROM `" +
+                                             s_Database +
+                                             "`.`" +
+                                             p_MDTableName +
+                                             "` WHERE " +
+                                             p_MDFieldName[MD_USER_ID] +
+                                             " = ? AND " +
+                                             p_MDFieldName[MD_DEVICE_KEY] +
+                                             " = ? AND " +
+                                             p_MDFieldName[MD_ACTOR_TYPE] +
+                                             " = ? AND " +
+                                             p_MDFieldName[MD_MESSAGE_ID] +
+                                             " IN (" +
+                                             GetPlaceholder(v_MessageID.size()) +
+                                             ")");
+    
+    c_Statement.bind(u32_UserID);
+    c_Statement.bind(p_MDFanOutDeviceKey);
+    c_Statement.bind(u8_ActorType);
+    
+    for (auto& MessageID : v_MessageID)
+    {
+        c_Statement.bind(MessageID);
+    }
+    
+    Row c_Row = c_Statement.execute().fetchOne();
+    
+    if (c_Row[0].isNull() == true)
+    {
+        return;
+    }
+    
+    uint64_t u64_MessageID = c_Row[0].get<uint64_t>();
+    
+    // Move the fan-out cursor and end the claim, the cursor row is locked
+    GetTable(p_MCTableName)
+        .update()
+        .set(p_MCFieldName[MC_FAN_OUT_ID],
+             u64_MessageID)
+        .set(p_MCFieldName[MC_FAN_OUT_CLAIM_EXPIRE],
+             0)
+        .where(std::string(p_MCFieldName[MC_USER_ID]) +
+               " == :valueA AND " +
+               p_MCFieldName[MC_DEVICE_KEY] +
+               " == :valueB AND " +
+               p_MCFieldName[MC_ACTOR_TYPE] +
+               " == :valueC AND " +
+               p_MCFieldName[MC_FAN_OUT_ID] +
+               " < :valueD")
+        .bind("valueA",
+              u32_UserID)
+        .bind("valueB",
+              s_DeviceKey)
+        .bind("valueC",
+              u8_ActorType)
+        .bind("valueD",
+              u64_MessageID)
+        .execute();
+}
+
+std::string MySQLStore::GetPlaceholder(size_t us_Count)
+{
+    std::string s_Placeholder = "?";
+    
+    for (size_t i = 1; i < us_Count; ++i)
+    {
+        s_Placeholder += ", ?";
+    }
+    
+    return s_Placeholder;
+}
+
+void MySQLStore::StoreFanOutMessage(uint32_t u32_UserID, std::vector<std::string> const& /* v_DeviceKey */, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message)
+{
+    // Stored once, the devices are resolved by their cursors
+    // @NOTE: Devices added later start after the last stored message,
+    //        see AddDevice().
+    StoreMessage(u32_UserID, p_MDFanOutDeviceKey, u8_ActorType, v_Message);
+}
+
+void MySQLStore::StoreMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message)
+{
+    // Message type is stored seperately
+    if (v_Message.size() <= 1)
+    {
+        throw Exception("Message has no data!");
+    }
+    else if ((v_Message.size() - 1) > us_MDMessageDataSize)
+    {
+        throw Exception("Message data too large to store!");
+    }
+    
+    uint64_t u64_Time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    Table c_Table = GetTable(p_MDTableName);
+    
+    // Replaced unclaimed messages are removed first
+    // @NOTE: Fan-out messages are shared by devices with their own
+    //        claims and are always kept.
+    if (KeepLatest(v_Message) == true && s_DeviceKey.compare(p_MDFanOutDeviceKey) != 0)
+    {
+        c_Table.remove()
+            .where(std::string(p_MDFieldName[MD_USER_ID]) +
+                   " == :valueA AND " +
+                   p_MDFieldName[MD_DEVICE_KEY] +
+                   " == :valueB AND " +
+                   p_MDFieldName[MD_ACTOR_TYPE] +
+                   " == :valueC AND " +
+                   p_MDFieldName[MD_MESSAGE_TYPE] +
+                   " == :valueD AND " +
+                   p_MDFieldName[MD_CLAIM_EXPIRE] +
+                   " < :valueE")
+            .bind("valueA",
+                  u32_UserID)
+            .bind("valueB",
+                  s_DeviceKey)
+            .bind("valueC",
+                  u8_ActorType)
+            .bind("valueD",
+                  v_Message[0])
+            .bind("valueE",
+                  u64_Time)
+            .execute();
+    }
+    
+    auto Insert = [&]()
+    {
+        return c_Table
+                .insert(p_MDFieldName[MD_USER_ID],
+                        p_MDFieldName[MD_DEVICE_KEY],
+                        p_MDFieldName[MD_ACTOR_TYPE],
+                        p_MDFieldName[MD_MESSAGE_TYPE],
+                        p_MDFieldName[MD_MESSAGE_DATA],
+                        p_MDFieldName[MD_STORE_TIME])
+                .values(u32_UserID,
+                        s_DeviceKey,
+                        u8_ActorType,
+                        v_Message[0],
+                        bytes(&(v_Message[1]), v_Message.size() - 1),
+                        u64_Time)
+                .execute()
+                .getAutoIncrementValue();
+    };
+    
+    uint64_t u64_MessageID = Insert();
+    
+    // @NOTE: Ids are assigned before the insert waits on an acknowledgement
+    //        of the same recipient. A message committed behind the moved
+    //        cursor is never read, it is stored again with a new id.
+    if (s_DeviceKey.compare(p_MDFanOutDeviceKey) != 0 && u64_MessageID <= GetCursor(u32_UserID, s_DeviceKey, u8_ActorType))
+    {
+        c_Table.remove()
+            .where(std::string(p_MDFieldName[MD_MESSAGE_ID]) +
+                   " == :value")
+            .bind("value",
+                  u64_MessageID)
+            .execute();
+        
+        Insert();
+    }
+}
+
+//*************************************************************************************
+// Cursor
+//*************************************************************************************
+
+uint64_t MySQLStore::GetCursor(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType)
+{
+    RowResult c_Result = GetTable(p_MCTableName)
+                            .select(p_MCFieldName[MC_MESSAGE_ID])      /* 0 */
+                            .where(std::string(p_MCFieldName[MC_USER_ID]) +
+                                   " == :valueA AND " +
+                                   p_MCFieldName[MC_DEVICE_KEY] +
+                                   " == :valueB AND " +
+                                   p_MCFieldName[MC_ACTOR_TYPE] +
+                                   " == :valueC")
+                            .bind("valueA",
+                                  u32_UserID)
+                            .bind("valueB",
+                                  s_DeviceKey)
+                            .bind("valueC",
+                                  u8_ActorType)
+                            .execute();
+    
+    // No cursor, nothing delivered yet
+    if (c_Result.count() == 0)
+    {
+        return 0;
+    }
+    
+    return c_Result.fetchOne()[0].get<uint64_t>();
+}
+
+Row MySQLStore::LockCursor(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType)
+{
+    Table c_Table = GetTable(p_MCTableName);
+    
+    auto SelectCursor = [&]()
+    {
+        return c_Table
+                .select(p_MCFieldName[MC_MESSAGE_ID],              /* 0 */
+                        p_MCFieldName[MC_FAN_OUT_ID],              /* 1 */
+                        p_MCFieldName[MC_FAN_OUT_CLAIM_EXPIRE])    /* 2 */
+                .where(std::string(p_MCFieldName[MC_USER_ID]) +
+                       " == :valueA AND " +
+                       p_MCFieldName[MC_DEVICE_KEY] +
+                       " == :valueB AND " +
+                       p_MCFieldName[MC_ACTOR_TYPE] +
+                       " == :valueC")
+                .lockExclusive()
+                .bind("valueA",
+                      u32_UserID)
+                .bind("valueB",
+                      s_DeviceKey)
+                .bind("valueC",
+                      u8_ActorType)
+                .execute();
+    };
+    
+    RowResult c_Result = SelectCursor();
+    
+    if (c_Result.count() == 0)
+    {
+        // First use, create the cursor to lock on
+        c_Session.sql(std::string("INSERT IGNORE INTO `") +
+                      s_Database +
+                      "`.`" +
+                      p_MCTableName +
+                      "` (" +
+                      p_MCFieldName[MC_USER_ID] +
+                      ", " +
+                      p_MCFieldName[MC_DEVICE_KEY] +
+                      ", " +
+                      p_MCFieldName[MC_ACTOR_TYPE] +
+                      ") VALUES (?, ?, ?)")
+            .bind(u32_UserID,
+                  s_DeviceKey,
+                  u8_ActorType)
+            .execute();
+        
+        c_Result = SelectCursor();
+    }
+    
+    return c_Result.fetchOne();
+}
+
+//*************************************************************************************
+// Purge
+//*************************************************************************************
+
+size_t MySQLStore::PurgeMessages(size_t us_Limit)
+{
+    // Messages up to the cursor of their recipient were delivered
+    // @NOTE: The limit is applied in a derived table, the join walks
+    //        the recipient index from each cursor downwards.
+    SqlResult c_Result = c_Session.sql(std::string("DELETE FROM `") +
+                                       s_Database +
+                                       "`.`" +
+                                       p_MDTableName +
+                                       "` WHERE " +
+                                       p_MDFieldName[MD_MESSAGE_ID] +
+                                       " IN (SELECT " +
+                                       p_MDFieldName[MD_MESSAGE_ID] +
+                                       " FROM (SELECT STRAIGHT_JOIN d." +
+                                       p_MDFieldName[MD_MESSAGE_ID] +
+                                       " FROM `" +
+                                       s_Database +
+                                       "`.`" +
+                                       p_MCTableName +
+                                       "` c JOIN `" +
+                                       s_Database +
+                                       "`.`" +
+                                       p_MDTableName +
+                                       "` d ON d." +
+                                       p_MDFieldName[MD_USER_ID] +
+                                       " = c." +
+                                       p_MCFieldName[MC_USER_ID] +
+                                       " AND d." +
+                                       p_MDFieldName[MD_DEVICE_KEY] +
+                                       " = c." +
+                                       p_MCFieldName[MC_DEVICE_KEY] +
+                                       " AND d." +
+                                       p_MDFieldName[MD_ACTOR_TYPE] +
+                                       " = c." +
+                                       p_MCFieldName[MC_ACTOR_TYPE] +
+                                       " AND d." +
+                                       p_MDFieldName[MD_MESSAGE_ID] +
+                                       " <= c." +
+                                       p_MCFieldName[MC_MESSAGE_ID] +
+                                       " LIMIT ?) AS p)")
+                            .bind(us_Limit)
+                            .execute();
+    
+    size_t us_Purged = c_Result.getAffectedItemsCount();
+    
+    if (us_Purged >= us_Limit)
+    {
+        return us_Purged;
+    }
+    
+    // Fan-out messages are purged once every registered device passed them
+    SqlResult c_FanOutResult = c_Session.sql(std::string("DELETE FROM `") +
+                                             s_Database +
+                                             "`.`" +
+                                             p_MDTableName +
+                                             "` WHERE " +
+                                             p_MDFieldName[MD_DEVICE_KEY] +
+                                             " = ? AND " +
+                                             p_MDFieldName[MD_MESSAGE_ID] +
+                                             " <= (SELECT COALESCE(MIN(COALESCE(c." +
+                                             p_MCFieldName[MC_FAN_OUT_ID] +
+                                             ", 0)), ?) FROM `" +
+                                             s_Database +
+                                             "`.`" +
+                                             p_UDLTableName +
+                                             "` d LEFT JOIN `" +
+                                             s_Database +
+                                             "`.`" +
+                                             p_MCTableName +
+                                             "` c ON c." +
+                                             p_MCFieldName[MC_USER_ID] +
+                                             " = d." +
+                                             p_UDLFieldName[UDL_USER_ID] +
+                                             " AND c." +
+                                             p_MCFieldName[MC_DEVICE_KEY] +
+                                             " = d." +
+                                             p_UDLFieldName[UDL_DEVICE_KEY] +
+                                             " AND c." +
+                                             p_MCFieldName[MC_ACTOR_TYPE] +
+                                             " = " +
+                                             p_MDTableName +
+                                             "." +
+                                             p_MDFieldName[MD_ACTOR_TYPE] +
+                                             " WHERE d." +
+                                             p_UDLFieldName[UDL_USER_ID] +
+                                             " = " +
+                                             p_MDTableName +
+                                             "." +
+                                             p_MDFieldName[MD_USER_ID] +
+                                             ") ORDER BY " +
+                                             p_MDFieldName[MD_MESSAGE_ID] +
+                                             " LIMIT ?")
+                                .bind(p_MDFanOutDeviceKey,
+                                      UINT64_MAX,
+                                      us_Limit - us_Purged)
+                                .execute();
+    
+    return us_Purged + c_FanOutResult.getAffectedItemsCount();
+}
+
+//*************************************************************************************
+// Change
+//*************************************************************************************
+
+uint64_t MySQLStore::GetLastMessageID()
+{
+    RowResult c_Result = GetTable(p_MDTableName)
+                            .select(p_MDFieldName[MD_MESSAGE_ID])      /* 0 */
+                            .orderBy(std::string(p_MDFieldName[MD_MESSAGE_ID]) + " DESC")
+                            .limit(1)
+                            .execute();
+    
+    if (c_Result.count() == 0)
+    {
+        return 0;
+    }
+    
+    return c_Result.fetchOne()[0].get<uint64_t>();
+}
+
+void MySQLStore::GetRecipients(uint64_t& u64_MessageID, size_t us_Limit, std::vector<InboxKey>& v_Recipient)
+{
+    // @NOTE: Primary key range, no message data is read
+    RowResult c_Result = GetTable(p_MDTableName)
+                            .select(p_MDFieldName[MD_MESSAGE_ID],      /* 0 */
+                                    p_MDFieldName[MD_USER_ID],         /* 1 */
+                                    p_MDFieldName[MD_DEVICE_KEY],      /* 2 */
+                                    p_MDFieldName[MD_ACTOR_TYPE])      /* 3 */
+                            .where(std::string(p_MDFieldName[MD_MESSAGE_ID]) +
+                                   " > :value")
+                            .orderBy(p_MDFieldName[MD_MESSAGE_ID])
+                            .limit(us_Limit)
+                            .bind("value",
+                                  u64_MessageID)
+                            .execute();
+    
+    v_Recipient.clear();
+    v_Recipient.reserve(c_Result.count());
+    
+    for (size_t us_Count = c_Result.count(); us_Count > 0; --us_Count)
+    {
+        Row c_Row = c_Result.fetchOne();
+        
+        u64_MessageID = c_Row[0].get<uint64_t>();
+        v_Recipient.emplace_back(c_Row[1].get<uint32_t>(),
+                                 c_Row[2].get<std::string>(),
+                                 c_Row[3].get<uint32_t>());
+    }
+}
+
+//*************************************************************************************
+// Account
+//*************************************************************************************
+
+bool MySQLStore::GetAccount(std::string const& s_Mail, uint32_t& u32_UserID, std::string& s_Password)
+{
+    RowResult c_Result = GetTable(p_UATableName)
+                            .select(p_UAFieldName[UA_USER_ID],         /* 0 */
+                                    p_UAFieldName[UA_PASSWORD])        /* 1 */
+                            .where(std::string(p_UAFieldName[UA_MAIL_ADDRESS]) +
+                                   " == :value")
+                            .bind("value",
+                                  s_Mail)
+                            .execute();
+    
+    // Unique account rows
+    if (c_Result.count() != 1)
+    {
+        return false;
+    }
+    
+    Row c_Row = c_Result.fetchOne();
+    
+    u32_UserID = c_Row[0].get<uint32_t>();
+    s_Password = c_Row[1].get<std::string>();
+    
+    return true;
+}
+
+void MySQLStore::GetAccounts(std::vector<Account>& v_Account)
+{
+    std::unordered_map<uint32_t, size_t> m_Index;
+    RowResult c_Result = GetTable(p_UATableName)
+                            .select(p_UAFieldName[UA_USER_ID],         /* 0 */
+                                    p_UAFieldName[UA_MAIL_ADDRESS],    /* 1 */
+                                    p_UAFieldName[UA_PASSWORD])        /* 2 */
+                            .execute();
+    
+    v_Account.clear();
+    v_Account.reserve(c_Result.count());
+    
+    for (size_t us_Count = c_Result.count(); us_Count > 0; --us_Count)
+    {
+        Row c_Row = c_Result.fetchOne();
+        
+        v_Account.emplace_back();
+        Account& c_Account = v_Account.back();
+        c_Account.u32_UserID = c_Row[0].get<uint32_t>();
+        c_Account.s_Mail = c_Row[1].get<std::string>();
+        c_Account.s_Password = c_Row[2].get<std::string>();
+        
+        m_Index.emplace(c_Account.u32_UserID, v_Account.size() - 1);
+    }
+    
+    // Devices for all accounts in one go
+    RowResult c_DeviceResult = GetTable(p_UDLTableName)
+                                  .select(p_UDLFieldName[UDL_USER_ID],       /* 0 */
+                                          p_UDLFieldName[UDL_DEVICE_KEY])    /* 1 */
+                                  .execute();
+    
+    for (size_t us_Count = c_DeviceResult.count(); us_Count > 0; --us_Count)
+    {
+        Row c_Row = c_DeviceResult.fetchOne();
+        auto Index = m_Index.find(c_Row[0].get<uint32_t>());
+        
+        if (Index != m_Index.end())
+        {
+            v_Account[Index->second].v_DeviceKey.emplace_back(c_Row[1].get<std::string>());
+        }
+    }
+}
+
+void MySQLStore::CreateAccount(std::string const& s_Mail, std::string const& s_Password)
+{
+    GetTable(p_UATableName)
+        .insert(p_UAFieldName[UA_MAIL_ADDRESS],
+                p_UAFieldName[UA_PASSWORD])
+        .values(s_Mail,
+                s_Password)
+        .execute();
+}
+
+void MySQLStore::RemoveAccount(uint32_t u32_UserID)
+{
+    GetTable(p_UATableName)
+        .remove()
+        .where(std::string(p_UAFieldName[UA_USER_ID]) +
+               " == :value")
+        .bind("value",
+              u32_UserID)
+        .execute();
+}
+
+//*************************************************************************************
+// Device
+//*************************************************************************************
+
+void MySQLStore::GetDevices(uint32_t u32_UserID, std::vector<std::string>& v_DeviceKey)
+{
+    RowResult c_Result = GetTable(p_UDLTableName)
+                            .select(p_UDLFieldName[UDL_DEVICE_KEY])    /* 0 */
+                            .where(std::string(p_UDLFieldName[UDL_USER_ID]) +
+                                   " == :value")
+                            .bind("value",
+                                  u32_UserID)
+                            .execute();
+    
+    v_DeviceKey.clear();
+    v_DeviceKey.reserve(c_Result.count());
+    
+    for (size_t us_Count = c_Result.count(); us_Count > 0; --us_Count)
+    {
+        v_DeviceKey.emplace_back(c_Result.fetchOne()[0].get<std::string>());
+    }
+}
+
+void MySQLStore::AddDevice(uint32_t u32_UserID, std::string const& s_DeviceKey)
+{
+    GetTable(p_UDLTableName)
+        .insert(p_UDLFieldName[UDL_USER_ID],
+                p_UDLFieldName[UDL_DEVICE_KEY])
+        .values(u32_UserID,
+                s_DeviceKey)
+        .execute();
+    
+    // New devices start after the fan-out messages stored before them,
+    // a removed and added again device does not move back
+    c_Session.sql(std::string("INSERT INTO `") +
+                  s_Database +
+                  "`.`" +
+                  p_MCTableName +
+                  "` (" +
+                  p_MCFieldName[MC_USER_ID] +
+                  ", " +
+                  p_MCFieldName[MC_DEVICE_KEY] +
+                  ", " +
+                  p_MCFieldName[MC_ACTOR_TYPE] +
+                  ", " +
+                  p_MCFieldName[MC_FAN_OUT_ID] +
+                  ") SELECT " +
+                  p_MDFieldName[MD_USER_ID] +
+                  ", ?, " +
+                  p_MDFieldName[MD_ACTOR_TYPE] +
+                  ", MAX(" +
+                  p_MDFieldName[MD_MESSAGE_ID] +
+                  ") FROM `" +
+                  s_Database +
+                  "`.`" +
+                  p_MDTableName +
+                  "` WHERE " +
+                  p_MDFieldName[MD_USER_ID] +
+                  " = ? AND " +
+                  p_MDFieldName[MD_DEVICE_KEY] +
+                  " = ? GROUP BY " +
+                  p_MDFieldName[MD_USER_ID] +
+                  ", " +
+                  p_MDFieldName[MD_ACTOR_TYPE] +
+                  " ON DUPLICATE KEY UPDATE " +
+                  p_MCFieldName[MC_FAN_OUT_ID] +
+                  " = GREATEST(" +
+                  p_MCFieldName[MC_FAN_OUT_ID] +
+                  ", VALUES(" +
+                  p_MCFieldName[MC_FAN_OUT_ID] +
+                  "))")
+        .bind(s_DeviceKey,
+              u32_UserID,
+              p_MDFanOutDeviceKey)
+        .execute();
+}
+
+void MySQLStore::RemoveDevice(uint32_t u32_UserID, std::string const& s_DeviceKey)
+{
+    GetTable(p_UDLTableName)
+        .remove()
+        .where(std::string(p_UDLFieldName[UDL_USER_ID]) +
+               " == :valueA AND " +
+               p_UDLFieldName[UDL_DEVICE_KEY] +
+               " == :valueB")
+        .bind("valueA",
+              u32_UserID)
+        .bind("valueB",
+              s_DeviceKey)
+        .execute();
+}
@@ -0,0 +1,355 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef MySQLStore_h
+#define MySQLStore_h
+
+// C / C++
+
+// External
+#include <mysqlx/xdevapi.h>
+
+// Project
+#include "../MessageStore.h"
+#include "../AccountStore.h"
+#include "../DatabaseTable.h"
+#include "../InboxKey.h"
+
+
+class MySQLStore : public MessageStore,
+                   public AccountStore
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     *
+     *  \param s_Address The mysql server address.
+     *  \param i_Port The mysql server port.
+     *  \param s_User The name of the mysql user.
+     *  \param s_Password The password of the mysql user.
+     *  \param s_Database The database to use.
+     */
+    
+    MySQLStore(std::string const& s_Address,
+               int i_Port,
+               std::string const& s_User,
+               std::string const& s_Password,
+               std::string const& s_Database);
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~MySQLStore() noexcept;
+    
+    //*************************************************************************************
+    // Message
+    //*************************************************************************************
+    
+    /**
+     *  Claim the next stored message for a recipient.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to write.
+     *  \param u64_MessageID The id of the claimed message to write.
+     *
+     *  \return true if a message was retrieved, false if not.
+     */
+    
+    bool RetrieveMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID) override;
+    
+    /**
+     *  Mark a claimed message as delivered by moving the recipient cursor.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param u64_MessageID The id of the claimed message.
+     */
+    
+    void AcknowledgeMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, uint64_t u64_MessageID) override;
+    
+    /**
+     *  Mark claimed messages as delivered. The recipient cursor moves past all
+     *  messages acknowledged in order, messages acknowledged before older ones
+     *  are removed.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the messages.
+     *  \param v_MessageID The ids of the claimed messages.
+     */
+    
+    void AcknowledgeMessages(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint64_t> const& v_MessageID) override;
+    
+    /**
+     *  Store a message for a recipient.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to store.
+     */
+    
+    void StoreMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message) override;
+    
+    /**
+     *  Store a message once for all devices of a recipient. Devices read the
+     *  message with their own fan-out cursor, the device keys are not needed.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param v_DeviceKey The device keys of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to store.
+     */
+    
+    void StoreFanOutMessage(uint32_t u32_UserID, std::vector<std::string> const& v_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t> const& v_Message) override;
+    
+    //*************************************************************************************
+    // Purge
+    //*************************************************************************************
+    
+    /**
+     *  Remove messages up to the cursor of their recipient and fan-out
+     *  messages passed by all devices.
+     *
+     *  \param us_Limit The max amount of messages to remove.
+     *
+     *  \return The amount of removed messages.
+     */
+    
+    size_t PurgeMessages(size_t us_Limit);
+    
+    //*************************************************************************************
+    // Change
+    //*************************************************************************************
+    
+    /**
+     *  Get the id of the newest stored message.
+     *
+     *  \return The newest message id, 0 if none.
+     */
+    
+    uint64_t GetLastMessageID();
+    
+    /**
+     *  Get the recipients of messages stored after a message id.
+     *
+     *  \param u64_MessageID The message id to read after, updated to the last read id.
+     *  \param us_Limit The max amount of messages to read.
+     *  \param v_Recipient The recipient inbox keys to write.
+     */
+    
+    void GetRecipients(uint64_t& u64_MessageID, size_t us_Limit, std::vector<InboxKey>& v_Recipient);
+    
+    //*************************************************************************************
+    // Account
+    //*************************************************************************************
+    
+    /**
+     *  Get a user account by mail address.
+     *
+     *  \param s_Mail The account mail address.
+     *  \param u32_UserID The user id to write.
+     *  \param s_Password The base64 password salt and key to write.
+     *
+     *  \return true if the account was found, false if not.
+     */
+    
+    bool GetAccount(std::string const& s_Mail, uint32_t& u32_UserID, std::string& s_Password) override;
+    
+    /**
+     *  Get all user accounts with their devices.
+     *
+     *  \param v_Account The accounts to write.
+     */
+    
+    void GetAccounts(std::vector<Account>& v_Account) override;
+    
+    /**
+     *  Create a user account.
+     *
+     *  \param s_Mail The account mail address.
+     *  \param s_Password The base64 password salt and key.
+     */
+    
+    void CreateAccount(std::string const& s_Mail, std::string const& s_Password) override;
+    
+    /**
+     *  Remove a user account.
+     *
+     *  \param u32_UserID The user id of the account.
+     */
+    
+    void RemoveAccount(uint32_t u32_UserID) override;
+    
+    //*************************************************************************************
+    // Device
+    //*************************************************************************************
+    
+    /**
+     *  Get all devices registered for a user.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param v_DeviceKey The device keys to write.
+     */
+    
+    void GetDevices(uint32_t u32_UserID, std::vector<std::string>& v_DeviceKey) override;
+    
+    /**
+     *  Add a device for a user.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param s_DeviceKey The device key to add.
+     */
+    
+    void AddDevice(uint32_t u32_UserID, std::string const& s_DeviceKey) override;
+    
+    /**
+     *  Remove a device from a user.
+     *
+     *  \param u32_UserID The user id of the device owner.
+     *  \param s_DeviceKey The device key to remove.
+     */
+    
+    void RemoveDevice(uint32_t u32_UserID, std::string const& s_DeviceKey) override;
+    
+private:
+    
+    //*************************************************************************************
+    // Table
+    //*************************************************************************************
+    
+    /**
+     *  Get a database table.
+     *
+     *  \param p_Name The name of the table.
+     *
+     *  \return The database table.
+     */
+    
+    mysqlx::Table GetTable(const char* p_Name);
+    
+    //*************************************************************************************
+    // Message
+    //*************************************************************************************
+    
+    /**
+     *  Claim the next fan-out message for a recipient device.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the message.
+     *  \param v_Message The full net message buffer to write.
+     *  \param u64_MessageID The id of the claimed message to write.
+     *
+     *  \return true if a message was retrieved, false if not.
+     */
+    
+    bool RetrieveFanOutMessage(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID);
+    
+    /**
+     *  Remove messages of a recipient.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the messages.
+     *  \param v_MessageID The ids of the messages to remove.
+     *
+     *  \return The amount of removed messages.
+     */
+    
+    size_t RemoveMessages(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint64_t> const& v_MessageID);
+    
+    /**
+     *  Move the fan-out cursor of a recipient device past the newest claimed
+     *  fan-out message in a list of message ids.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the messages.
+     *  \param v_MessageID The ids of the claimed messages.
+     */
+    
+    void AcknowledgeFanOutMessages(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType, std::vector<uint64_t> const& v_MessageID);
+    
+    /**
+     *  Get a comma seperated list of statement placeholders.
+     *
+     *  \param us_Count The amount of placeholders.
+     *
+     *  \return The placeholder list.
+     */
+    
+    static std::string GetPlaceholder(size_t us_Count);
+    
+    /**
+     *  Get the full net message buffer of a message row.
+     *
+     *  \param c_Row The message row with id, type and data.
+     *  \param v_Message The full net message buffer to write.
+     */
+    
+    static void GetMessage(mysqlx::Row& c_Row, std::vector<uint8_t>& v_Message);
+    
+    //*************************************************************************************
+    // Cursor
+    //*************************************************************************************
+    
+    /**
+     *  Get the delivered message cursor of a recipient.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the messages.
+     *
+     *  \return The id up to which all messages were delivered.
+     */
+    
+    uint64_t GetCursor(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType);
+    
+    /**
+     *  Lock the cursor row of a recipient for the current transaction. The
+     *  cursor row is created if missing.
+     *
+     *  \param u32_UserID The user id of the recipient.
+     *  \param s_DeviceKey The device key of the recipient.
+     *  \param u8_ActorType The client type which sent the messages.
+     *
+     *  \return The cursor row with message id, fan-out id and fan-out claim expire.
+     */
+    
+    mysqlx::Row LockCursor(uint32_t u32_UserID, std::string const& s_DeviceKey, uint8_t u8_ActorType);
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    mysqlx::Session c_Session;
+    std::string s_Database;
+    
+protected:
+
+};
+
+#endif /* MySQLStore_h */
@@ -0,0 +1,234 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef IntrusivePointer_h
+#define IntrusivePointer_h
+
+// C / C++
+#include <cstddef>
+#include <utility>
+
+// External
+
+// Project
+
+
+template<typename T> class IntrusivePointer
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     */
+    
+    IntrusivePointer() noexcept : p_Object(nullptr)
+    {}
+    
+    /**
+     *  Null constructor.
+     */
+    
+    IntrusivePointer(std::nullptr_t) noexcept : p_Object(nullptr)
+    {}
+    
+    /**
+     *  Object constructor. The object reference count is increased.
+     *
+     *  \param p_Object The object to reference.
+     */
+    
+    explicit IntrusivePointer(T* p_Object) noexcept : p_Object(p_Object)
+    {
+        if (p_Object != nullptr)
+        {
+            p_Object->AddReference();
+        }
+    }
+    
+    /**
+     *  Copy constructor.
+     *
+     *  \param c_Pointer Pointer class source.
+     */
+    
+    IntrusivePointer(IntrusivePointer const& c_Pointer) noexcept : IntrusivePointer(c_Pointer.p_Object)
+    {}
+    
+    /**
+     *  Move constructor. The reference is taken without changing the count.
+     *
+     *  \param c_Pointer Pointer class source.
+     */
+    
+    IntrusivePointer(IntrusivePointer&& c_Pointer) noexcept : p_Object(c_Pointer.p_Object)
+    {
+        c_Pointer.p_Object = nullptr;
+    }
+    
+    /**
+     *  Converting copy constructor, for pointers to derived objects.
+     *
+     *  \param c_Pointer Pointer class source.
+     */
+    
+    template<typename U> IntrusivePointer(IntrusivePointer<U> const& c_Pointer) noexcept : IntrusivePointer(c_Pointer.get())
+    {}
+    
+    /**
+     *  Converting move constructor, for pointers to derived objects. The
+     *  reference is taken without changing the count.
+     *
+     *  \param c_Pointer Pointer class source.
+     */
+    
+    template<typename U> IntrusivePointer(IntrusivePointer<U>&& c_Pointer) noexcept : p_Object(c_Pointer.p_Object)
+    {
+        c_Pointer.p_Object = nullptr;
+    }
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~IntrusivePointer() noexcept
+    {
+        reset();
+    }
+    
+    //*************************************************************************************
+    // Operator
+    //*************************************************************************************
+    
+    /**
+     *  Copy operator.
+     *
+     *  \param c_Pointer Pointer class source.
+     *
+     *  \return The assigned pointer.
+     */
+    
+    IntrusivePointer& operator=(IntrusivePointer const& c_Pointer) noexcept
+    {
+        IntrusivePointer(c_Pointer).swap(*this);
+        return *this;
+    }
+    
+    /**
+     *  Move operator.
+     *
+     *  \param c_Pointer Pointer class source.
+     *
+     *  \return The assigned pointer.
+     */
+    
+    IntrusivePointer& operator=(IntrusivePointer&& c_Pointer) noexcept
+    {
+        IntrusivePointer(std::move(c_Pointer)).swap(*this);
+        return *this;
+    }
+    
+    T& operator*() const noexcept
+    {
+        return *p_Object;
+    }
+    
+    T* operator->() const noexcept
+    {
+        return p_Object;
+    }
+    
+    bool operator==(std::nullptr_t) const noexcept
+    {
+        return p_Object == nullptr;
+    }
+    
+    bool operator!=(std::nullptr_t) const noexcept
+    {
+        return p_Object != nullptr;
+    }
+    
+    //*************************************************************************************
+    // Pointer
+    //*************************************************************************************
+    
+    /**
+     *  Get the referenced object.
+     *
+     *  \return The referenced object, nullptr if none.
+     */
+    
+    T* get() const noexcept
+    {
+        return p_Object;
+    }
+    
+    /**
+     *  Swap the referenced objects of two pointers.
+     *
+     *  \param c_Pointer The pointer to swap with.
+     */
+    
+    void swap(IntrusivePointer& c_Pointer) noexcept
+    {
+        std::swap(p_Object, c_Pointer.p_Object);
+    }
+    
+    /**
+     *  Release the referenced object. The object is released by itself
+     *  once the last reference is gone.
+     */
+    
+    void reset() noexcept
+    {
+        if (p_Object != nullptr)
+        {
+            p_Object->Release();
+            p_Object = nullptr;
+        }
+    }
+    
+private:
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    T* p_Object;
+    
+    template<typename U> friend class IntrusivePointer;
+    
+protected:
+
+};
+
+/**
+ *  Create a object referenced by a intrusive pointer.
+ *
+ *  \param Args The object constructor arguments.
+ *
+ *  \return The pointer to the created object.
+ */
+
+template<typename T, typename... Args> inline IntrusivePointer<T> MakeIntrusive(Args&&... args)
+{
+    return IntrusivePointer<T>(new T(std::forward<Args>(args)...));
+}
+
+#endif /* IntrusivePointer_h */
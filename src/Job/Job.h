@@ -18,6 +18,8 @@
 #define Job_h
 
 // C / C++
+#include <atomic>
+#include <memory>
 
 // External
 
@@ -65,12 +67,41 @@ public:
         return true;
     }
     
+    //*************************************************************************************
+    // Reference
+    //*************************************************************************************
+    
+    /**
+     *  Add a reference to a job created with MakeIntrusive().
+     */
+    
+    void AddReference() noexcept
+    {
+        u32_ReferenceCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    /**
+     *  Remove a reference. The job is deleted with the last reference.
+     */
+    
+    void Release() noexcept
+    {
+        if (u32_ReferenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+    
 private:
     
     //*************************************************************************************
     // Data
     //*************************************************************************************
     
+    // @NOTE: Counted in the job, the job list and client pool move
+    //        the pointer without a separate control block.
+    std::atomic<uint32_t> u32_ReferenceCount;
+    
 protected:
     
     //*************************************************************************************
@@ -81,7 +112,7 @@ protected:
      *  Default constructor.
      */
     
-    Job() noexcept
+    Job() noexcept : u32_ReferenceCount(0)
     {}
 };
 
@@ -53,11 +53,11 @@ void JobList::Unlock() noexcept
 // Add
 //*************************************************************************************
 
-void JobList::AddJob(std::shared_ptr<Job> p_Job)
+void JobList::AddJob(IntrusivePointer<Job> p_Job)
 {
     try
     {
-        c_JobList.Add(p_Job);
+        c_JobList.Add(std::move(p_Job));
         c_Condition.notify_one();
     }
     catch (...)
@@ -70,12 +70,12 @@ void JobList::AddJob(std::shared_ptr<Job> p_Job)
 // Getters
 //*************************************************************************************
 
-std::shared_ptr<Job> JobList::GetJob()
+IntrusivePointer<Job> JobList::GetJob()
 {
     while (b_Locked == false)
     {
         // Get a job
-        std::shared_ptr<Job> p_Job = c_JobList.GetElement();
+        IntrusivePointer<Job> p_Job = c_JobList.GetElement();
         
         // No job available, wait for one
         if (p_Job == NULL)
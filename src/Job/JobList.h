@@ -29,6 +29,7 @@
 // Project
 #include "./Job.h"
 #include "../SharedList.h"
+#include "../IntrusivePointer.h"
 
 
 class JobList
@@ -77,7 +78,7 @@ public:
      *  \param p_Job The job to add.
      */
     
-    void AddJob(std::shared_ptr<Job> p_Job);
+    void AddJob(IntrusivePointer<Job> p_Job);
     
     //*************************************************************************************
     // Getters
@@ -89,7 +90,7 @@ public:
      *  \return The job to perform.
      */
     
-    std::shared_ptr<Job> GetJob();
+    IntrusivePointer<Job> GetJob();
     
 private:
     
@@ -100,7 +101,7 @@ private:
     std::condition_variable c_Condition;
     std::mutex c_Mutex;
     
-    SharedList<Job> c_JobList;
+    SharedList<Job, IntrusivePointer<Job>> c_JobList;
     std::atomic<bool> b_Locked;
     
 protected:
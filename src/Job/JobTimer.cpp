@@ -0,0 +1,154 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+
+// External
+
+// Project
+#include "./JobTimer.h"
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+JobTimer::JobTimer(JobList& c_JobList) : c_JobList(c_JobList),
+                                         b_Run(true)
+{
+    try
+    {
+        c_Thread = std::thread(Update, this);
+    }
+    catch (std::exception& e)
+    {
+        throw Exception("Failed to start job timer thread: " + std::string(e.what()));
+    }
+}
+
+JobTimer::~JobTimer() noexcept
+{
+    c_Mutex.lock();
+    b_Run = false;
+    c_Mutex.unlock();
+    
+    c_Condition.notify_one();
+    c_Thread.join();
+}
+
+//*************************************************************************************
+// Add
+//*************************************************************************************
+
+void JobTimer::AddJob(IntrusivePointer<Job> p_Job, std::chrono::steady_clock::time_point c_Time)
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    
+    // Wake only if the next due time changed
+    bool b_First = m_Job.size() == 0 || c_Time < m_Job.begin()->first;
+    
+    m_Job.emplace(c_Time, Timed{ std::move(p_Job), NULL, 0 });
+    
+    if (b_First == true)
+    {
+        c_Condition.notify_one();
+    }
+}
+
+void JobTimer::AddJob(Source& c_Source, size_t us_ID, std::chrono::steady_clock::time_point c_Time)
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    
+    bool b_First = m_Job.size() == 0 || c_Time < m_Job.begin()->first;
+    
+    m_Job.emplace(c_Time, Timed{ IntrusivePointer<Job>(), &c_Source, us_ID });
+    
+    if (b_First == true)
+    {
+        c_Condition.notify_one();
+    }
+}
+
+//*************************************************************************************
+// Remove
+//*************************************************************************************
+
+void JobTimer::RemoveSource(Source& c_Source) noexcept
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    
+    for (auto It = m_Job.begin(); It != m_Job.end();)
+    {
+        if (It->second.p_Source == &c_Source)
+        {
+            It = m_Job.erase(It);
+        }
+        else
+        {
+            ++It;
+        }
+    }
+}
+
+//*************************************************************************************
+// Update
+//*************************************************************************************
+
+void JobTimer::Update(JobTimer* p_Instance) noexcept
+{
+    std::unique_lock<std::mutex> c_Lock(p_Instance->c_Mutex);
+    
+    while (p_Instance->b_Run == true)
+    {
+        if (p_Instance->m_Job.size() == 0)
+        {
+            p_Instance->c_Condition.wait(c_Lock);
+            continue;
+        }
+        
+        auto Due = p_Instance->m_Job.begin();
+        
+        if (Due->first > std::chrono::steady_clock::now())
+        {
+            p_Instance->c_Condition.wait_until(c_Lock, Due->first);
+            continue;
+        }
+        
+        // Resolved while locked, the source can not be removed meanwhile
+        if (Due->second.p_Source != NULL)
+        {
+            Due->second.p_Source->AddDueJob(Due->second.us_ID);
+            p_Instance->m_Job.erase(Due);
+            continue;
+        }
+        
+        IntrusivePointer<Job> p_Job = std::move(Due->second.p_Job);
+        p_Instance->m_Job.erase(Due);
+        
+        // Job list has its own lock
+        c_Lock.unlock();
+        
+        try
+        {
+            p_Instance->c_JobList.AddJob(std::move(p_Job));
+        }
+        catch (...)
+        {}
+        
+        p_Job.reset();
+        c_Lock.lock();
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef JobTimer_h
+#define JobTimer_h
+
+// C / C++
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <map>
+
+// External
+
+// Project
+#include "./JobList.h"
+
+
+class JobTimer
+{
+public:
+    
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    // @NOTE: Jobs which can be destroyed before they are due are added
+    //        by id, the source resolves the id once the time is reached.
+    //        No reference is held while waiting.
+    class Source
+    {
+    public:
+        
+        /**
+         *  Default destructor.
+         */
+        
+        virtual ~Source() noexcept
+        {}
+        
+        /**
+         *  Add the job for a id to the job list if it still exists. Called
+         *  with the timer locked, no timed jobs can be added.
+         *
+         *  \param us_ID The id of the due job.
+         */
+        
+        virtual void AddDueJob(size_t us_ID) noexcept = 0;
+    };
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     *
+     *  \param c_JobList The job list to add due jobs to.
+     */
+    
+    JobTimer(JobList& c_JobList);
+    
+    /**
+     *  Copy constructor. Disabled for this class.
+     *
+     *  \param c_JobTimer JobTimer class source.
+     */
+    
+    JobTimer(JobTimer const& c_JobTimer) = delete;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~JobTimer() noexcept;
+    
+    //*************************************************************************************
+    // Add
+    //*************************************************************************************
+    
+    /**
+     *  Add a job to the job list at a given time. The job is kept until due.
+     *
+     *  \param p_Job The job to add.
+     *  \param c_Time The time to add the job at.
+     */
+    
+    void AddJob(IntrusivePointer<Job> p_Job, std::chrono::steady_clock::time_point c_Time);
+    
+    /**
+     *  Add a job by id to the job list at a given time. The id is resolved
+     *  by the source when due.
+     *
+     *  \param c_Source The source to resolve the id with.
+     *  \param us_ID The id of the job.
+     *  \param c_Time The time to add the job at.
+     */
+    
+    void AddJob(Source& c_Source, size_t us_ID, std::chrono::steady_clock::time_point c_Time);
+    
+    //*************************************************************************************
+    // Remove
+    //*************************************************************************************
+    
+    /**
+     *  Remove all jobs of a source. Has to be called before the source is
+     *  destroyed.
+     *
+     *  \param c_Source The source to remove.
+     */
+    
+    void RemoveSource(Source& c_Source) noexcept;
+    
+private:
+    
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    struct Timed
+    {
+        IntrusivePointer<Job> p_Job; // Kept until due
+        Source* p_Source; // Resolves the id if no job is kept
+        size_t us_ID;
+    };
+    
+    //*************************************************************************************
+    // Update
+    //*************************************************************************************
+    
+    /**
+     *  Run the timer update.
+     *
+     *  \param p_Instance The job timer instance to update with.
+     */
+    
+    static void Update(JobTimer* p_Instance) noexcept;
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    JobList& c_JobList;
+    
+    std::mutex c_Mutex;
+    std::condition_variable c_Condition;
+    std::multimap<std::chrono::steady_clock::time_point, Timed> m_Job;
+    
+    std::thread c_Thread;
+    bool b_Run; // Guarded by mutex
+    
+protected:
+
+};
+
+#endif /* JobTimer_h */
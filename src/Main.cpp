@@ -26,9 +26,17 @@
 
 // Project
 #include "./Server/Server.h"
+#include "./Server/ChangeFeed.h"
+#include "./Server/CustomSpool.h"
 #include "./Database/Database.h"
+#include "./Database/MySQL/MySQLStore.h"
+#include "./Database/MySQL/MySQLPurge.h"
+#include "./Database/Memory/MemoryStore.h"
+#include "./Database/Log/LogStore.h"
 #include "./Job/ThreadPool.h"
+#include "./Job/JobTimer.h"
 #include "./CLI.h"
+#include "./Configuration.h"
 #include "./Logger.h"
 #include "./Revision.h"
 
@@ -155,6 +163,37 @@ static void Daemonize() noexcept
     stderr = fopen("/dev/null", "w+");
 }
 
+//*************************************************************************************
+// Database
+//*************************************************************************************
+
+static Database* CreateDatabase(Configuration const& c_Config, std::shared_ptr<MessageStore> p_MessageStore, std::shared_ptr<AccountStore> p_AccountStore, std::shared_ptr<AccountCache> p_AccountCache)
+{
+    // Given stores are shared by all threads, MySQL needs a session per thread
+    if (p_MessageStore == NULL || p_AccountStore == NULL)
+    {
+        std::shared_ptr<MySQLStore> p_MySQLStore = std::make_shared<MySQLStore>(c_Config.s_MySQLAddress,
+                                                                                c_Config.i_MySQLPort,
+                                                                                c_Config.s_MySQLUser,
+                                                                                c_Config.s_MySQLPassword,
+                                                                                c_Config.s_MySQLDatabase);
+        
+        if (p_MessageStore == NULL)
+        {
+            p_MessageStore = p_MySQLStore;
+        }
+        
+        if (p_AccountStore == NULL)
+        {
+            p_AccountStore = p_MySQLStore;
+        }
+    }
+    
+    return new Database(p_MessageStore,
+                        p_AccountStore,
+                        p_AccountCache);
+}
+
 //*************************************************************************************
 // Help
 //*************************************************************************************
@@ -261,14 +300,57 @@ int main(int argc, const char* argv[])
          *  Mode
          */
         
-        // Run as daemon or start cli thread
+        // Run as daemon before any storage threads exist
         if (b_Daemon == true)
         {
             Daemonize();
         }
-        else
+        
+        /**
+         *  Storage
+         */
+        
+        std::shared_ptr<MessageStore> p_MessageStore(NULL);
+        std::shared_ptr<AccountStore> p_AccountStore(NULL);
+        
+        if (c_Config.s_StorageBackend.compare("Memory") == 0)
+        {
+            std::shared_ptr<MemoryStore> p_MemoryStore = std::make_shared<MemoryStore>();
+            
+            p_MessageStore = p_MemoryStore;
+            p_AccountStore = p_MemoryStore;
+        }
+        else if (c_Config.s_StorageBackend.compare("Log") == 0)
+        {
+            p_MessageStore = std::make_shared<LogStore>(c_Config.s_LogDirectoryPath,
+                                                        c_Config.i_LogSyncIntervalMS);
+        }
+        else if (c_Config.s_StorageBackend.compare("MySQL") != 0)
+        {
+            throw Exception("Unknown storage backend: " + c_Config.s_StorageBackend);
+        }
+        
+        // Accounts for authentication are cached by all threads
+        std::shared_ptr<AccountCache> p_AccountCache = std::make_shared<AccountCache>(c_Config.i_StorageAccountCacheTTLS);
+        
+        try
+        {
+            std::unique_ptr<Database> p_PreloadDatabase(CreateDatabase(c_Config, p_MessageStore, p_AccountStore, p_AccountCache));
+            p_AccountCache->Preload(*(p_PreloadDatabase->p_AccountStore));
+        }
+        catch (std::exception& e)
+        {
+            c_Logger.Log(Logger::WARNING, "Failed to preload account cache: " +
+                                          std::string(e.what()),
+                         "Main.cpp", __LINE__);
+        }
+        
+        // Start cli thread if not a daemon
+        if (b_Daemon == false)
         {
-            CLI::Start(c_Config);
+            std::unique_ptr<Database> p_CLIDatabase(CreateDatabase(c_Config, p_MessageStore, p_AccountStore, p_AccountCache));
+            CLI::Start(p_CLIDatabase->p_AccountStore,
+                       p_CLIDatabase->p_AccountCache);
         }
         
         /**
@@ -276,13 +358,47 @@ int main(int argc, const char* argv[])
          */
         
         JobList c_JobList;
+        JobTimer c_JobTimer(c_JobList);
         
         /**
          *  Server
          */
         
+        // Custom messages are kept on disk while transferred
+        CustomSpool c_CustomSpool(c_Config.s_CustomDirectoryPath,
+                                  static_cast<uint64_t>(c_Config.i_CustomSizeMaxKB) * 1024);
+        
         // We need a client pool for the server
-        ClientPool c_ClientPool(c_JobList);
+        ClientPool c_ClientPool(c_JobList,
+                                c_JobTimer,
+                                c_Config.i_LongPollS,
+                                c_Config.i_NotificationWindowMS,
+                                c_Config.i_CompressionSizeMin,
+                                c_CustomSpool);
+        
+        // Messages of other instances sharing the database
+        std::unique_ptr<ChangeFeed> p_ChangeFeed;
+        
+        if (c_Config.s_StorageBackend.compare("MySQL") == 0 && c_Config.i_MySQLChangeFeedIntervalMS > 0)
+        {
+            p_ChangeFeed.reset(new ChangeFeed(c_ClientPool,
+                                              std::unique_ptr<MySQLStore>(new MySQLStore(c_Config.s_MySQLAddress,
+                                                                                         c_Config.i_MySQLPort,
+                                                                                         c_Config.s_MySQLUser,
+                                                                                         c_Config.s_MySQLPassword,
+                                                                                         c_Config.s_MySQLDatabase)),
+                                              c_Config.i_MySQLChangeFeedIntervalMS));
+        }
+        
+        // Delivered messages are only marked, remove them periodically
+        IntrusivePointer<MySQLPurge> p_MySQLPurge;
+        
+        if (c_Config.s_StorageBackend.compare("MySQL") == 0 && c_Config.i_MySQLPurgeIntervalS > 0)
+        {
+            p_MySQLPurge = MakeIntrusive<MySQLPurge>(c_JobTimer,
+                                                     c_Config.i_MySQLPurgeIntervalS);
+            p_MySQLPurge->Schedule();
+        }
         
         // Create net server and start
         Server c_Server(c_ClientPool);
@@ -318,11 +434,7 @@ int main(int argc, const char* argv[])
         
         for (size_t i = 0; i < us_ThreadCount; ++i)
         {
-            l_ThreadInfo.emplace_back(new Database(c_Config.s_MySQLAddress,
-                                                   c_Config.i_MySQLPort,
-                                                   c_Config.s_MySQLUser,
-                                                   c_Config.s_MySQLPassword,
-                                                   c_Config.s_MySQLDatabase));
+            l_ThreadInfo.emplace_back(CreateDatabase(c_Config, p_MessageStore, p_AccountStore, p_AccountCache));
         }
         
         // Got thread info, create pool
@@ -333,22 +445,18 @@ int main(int argc, const char* argv[])
          *  Update
          */
         
-        std::shared_ptr<ThreadShared> p_Database = std::make_shared<Database>(c_Config.s_MySQLAddress,
-                                                                              c_Config.i_MySQLPort,
-                                                                              c_Config.s_MySQLUser,
-                                                                              c_Config.s_MySQLPassword,
-                                                                              c_Config.s_MySQLDatabase);
+        std::shared_ptr<ThreadShared> p_Database(CreateDatabase(c_Config, p_MessageStore, p_AccountStore, p_AccountCache));
         
         while (b_Run == true)
         {
             try
             {
                 // Get job
-                std::shared_ptr<Job> p_Job = c_JobList.GetJob();
+                IntrusivePointer<Job> p_Job = c_JobList.GetJob();
                 
                 if (p_Job->Perform(p_Database) == false)
                 {
-                    c_JobList.AddJob(p_Job);
+                    c_JobList.AddJob(std::move(p_Job));
                 }
                 
                 // Reset job to no longer be owner
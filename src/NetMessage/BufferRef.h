@@ -0,0 +1,142 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef BufferRef_h
+#define BufferRef_h
+
+// C / C++
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// External
+
+// Project
+#include "../Exception.h"
+
+
+class BufferRef
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     */
+    
+    BufferRef() noexcept : p_Data(NULL),
+                           us_Size(0)
+    {}
+    
+    /**
+     *  Buffer constructor. The buffer has to outlive the reference.
+     *
+     *  \param v_Buffer The buffer to reference.
+     *  \param us_Pos The position of the referenced bytes.
+     *  \param us_Size The size of the referenced bytes.
+     */
+    
+    BufferRef(std::vector<uint8_t> const& v_Buffer,
+              size_t us_Pos,
+              size_t us_Size) : p_Data(NULL),
+                                us_Size(us_Size)
+    {
+        if (us_Pos > v_Buffer.size() || us_Size > v_Buffer.size() - us_Pos)
+        {
+            throw Exception("Buffer reference out of range!");
+        }
+        
+        p_Data = v_Buffer.data() + us_Pos;
+    }
+    
+    /**
+     *  Pointer constructor. The bytes have to outlive the reference.
+     *
+     *  \param p_Data The bytes to reference.
+     *  \param us_Size The size of the referenced bytes.
+     */
+    
+    BufferRef(const uint8_t* p_Data,
+              size_t us_Size) noexcept : p_Data(p_Data),
+                                         us_Size(us_Size)
+    {}
+    
+    //*************************************************************************************
+    // Getters
+    //*************************************************************************************
+    
+    /**
+     *  Get the referenced bytes.
+     *
+     *  \return The referenced bytes.
+     */
+    
+    const uint8_t* GetData() const noexcept
+    {
+        return p_Data;
+    }
+    
+    /**
+     *  Get the size of the referenced bytes.
+     *
+     *  \return The size in bytes.
+     */
+    
+    size_t GetSize() const noexcept
+    {
+        return us_Size;
+    }
+    
+    /**
+     *  Get the length of a zero padded string field.
+     *
+     *  \return The string length without padding.
+     */
+    
+    size_t GetStringLength() const noexcept
+    {
+        return strnlen((const char*)p_Data, us_Size);
+    }
+    
+    /**
+     *  Copy a zero padded string field.
+     *
+     *  \return The string without padding.
+     */
+    
+    std::string ToString() const
+    {
+        return std::string((const char*)p_Data, GetStringLength());
+    }
+    
+private:
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    const uint8_t* p_Data;
+    size_t us_Size;
+    
+protected:
+
+};
+
+#endif /* BufferRef_h */
@@ -0,0 +1,264 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <cstring>
+#include <algorithm>
+
+// External
+
+// Project
+#include "./NetCompression.h"
+#include "./NetMessageLayout.h"
+
+using namespace NetCompression;
+
+namespace
+{
+    // @NOTE: Sequences are a token (literal length << 4 | match length - 4),
+    //        extended lengths as 255 byte runs, the literals and a 2 byte
+    //        little endian match offset. The last sequence has no match.
+    constexpr size_t us_MatchMin = 4;
+    constexpr size_t us_OffsetMax = 65535;
+    constexpr size_t us_LengthMask = 15;
+    constexpr size_t us_HashBits = 12;
+    
+    inline uint32_t Hash(const uint8_t* p_Data) noexcept
+    {
+        return (NetMessageLayout::Load<uint32_t>(p_Data) * 2654435761U) >> (32 - us_HashBits);
+    }
+    
+    inline void WriteLength(std::vector<uint8_t>& v_Out, size_t us_Length)
+    {
+        for (; us_Length >= 255; us_Length -= 255)
+        {
+            v_Out.emplace_back(255);
+        }
+        
+        v_Out.emplace_back(static_cast<uint8_t>(us_Length));
+    }
+    
+    inline bool ReadLength(const uint8_t*& p_Data, const uint8_t* p_End, size_t& us_Length) noexcept
+    {
+        uint8_t u8_Byte;
+        
+        do
+        {
+            if (p_Data == p_End)
+            {
+                return false;
+            }
+            
+            u8_Byte = *(p_Data++);
+            us_Length += u8_Byte;
+        }
+        while (u8_Byte == 255);
+        
+        return true;
+    }
+    
+    void WriteSequence(std::vector<uint8_t>& v_Out, const uint8_t* p_Literal, size_t us_LiteralSize, size_t us_Offset, size_t us_MatchSize)
+    {
+        size_t us_Match = (us_MatchSize > 0 ? us_MatchSize - us_MatchMin : 0);
+        
+        v_Out.emplace_back(static_cast<uint8_t>((std::min(us_LiteralSize, us_LengthMask) << 4) | std::min(us_Match, us_LengthMask)));
+        
+        if (us_LiteralSize >= us_LengthMask)
+        {
+            WriteLength(v_Out, us_LiteralSize - us_LengthMask);
+        }
+        
+        v_Out.insert(v_Out.end(), p_Literal, p_Literal + us_LiteralSize);
+        
+        if (us_MatchSize == 0)
+        {
+            return;
+        }
+        
+        v_Out.emplace_back(static_cast<uint8_t>(us_Offset));
+        v_Out.emplace_back(static_cast<uint8_t>(us_Offset >> 8));
+        
+        if (us_Match >= us_LengthMask)
+        {
+            WriteLength(v_Out, us_Match - us_LengthMask);
+        }
+    }
+    
+    void CompressBlock(const uint8_t* p_Data, size_t us_Size, std::vector<uint8_t>& v_Out)
+    {
+        uint32_t p_Table[1 << us_HashBits] = { 0 }; // Position + 1, 0 if empty
+        size_t us_Anchor = 0;
+        size_t us_Pos = 0;
+        
+        while (us_Pos + us_MatchMin <= us_Size)
+        {
+            uint32_t u32_Hash = Hash(p_Data + us_Pos);
+            size_t us_Candidate = p_Table[u32_Hash];
+            
+            p_Table[u32_Hash] = static_cast<uint32_t>(us_Pos + 1);
+            
+            if (us_Candidate == 0 ||
+                us_Pos - (--us_Candidate) > us_OffsetMax ||
+                std::memcmp(p_Data + us_Candidate, p_Data + us_Pos, us_MatchMin) != 0)
+            {
+                ++us_Pos;
+                continue;
+            }
+            
+            size_t us_MatchSize = us_MatchMin;
+            
+            while (us_Pos + us_MatchSize < us_Size && p_Data[us_Candidate + us_MatchSize] == p_Data[us_Pos + us_MatchSize])
+            {
+                ++us_MatchSize;
+            }
+            
+            WriteSequence(v_Out, p_Data + us_Anchor, us_Pos - us_Anchor, us_Pos - us_Candidate, us_MatchSize);
+            
+            us_Pos += us_MatchSize;
+            us_Anchor = us_Pos;
+        }
+        
+        WriteSequence(v_Out, p_Data + us_Anchor, us_Size - us_Anchor, 0, 0);
+    }
+    
+    bool DecompressBlock(const uint8_t* p_Data, size_t us_Size, uint8_t* p_Out, size_t us_OutSize) noexcept
+    {
+        const uint8_t* p_End = p_Data + us_Size;
+        size_t us_Out = 0;
+        
+        while (p_Data != p_End)
+        {
+            uint8_t u8_Token = *(p_Data++);
+            size_t us_Literal = u8_Token >> 4;
+            
+            if (us_Literal == us_LengthMask && ReadLength(p_Data, p_End, us_Literal) == false)
+            {
+                return false;
+            }
+            else if (us_Literal > static_cast<size_t>(p_End - p_Data) || us_Literal > us_OutSize - us_Out)
+            {
+                return false;
+            }
+            
+            std::memcpy(p_Out + us_Out, p_Data, us_Literal);
+            us_Out += us_Literal;
+            p_Data += us_Literal;
+            
+            // Last sequence has no match
+            if (p_Data == p_End)
+            {
+                break;
+            }
+            else if (p_End - p_Data < 2)
+            {
+                return false;
+            }
+            
+            size_t us_Offset = p_Data[0] | (static_cast<size_t>(p_Data[1]) << 8);
+            size_t us_Match = u8_Token & us_LengthMask;
+            
+            p_Data += 2;
+            
+            if (us_Match == us_LengthMask && ReadLength(p_Data, p_End, us_Match) == false)
+            {
+                return false;
+            }
+            
+            us_Match += us_MatchMin;
+            
+            if (us_Offset == 0 || us_Offset > us_Out || us_Match > us_OutSize - us_Out)
+            {
+                return false;
+            }
+            
+            // Byte wise, matches may overlap the output
+            for (size_t i = 0; i < us_Match; ++i, ++us_Out)
+            {
+                p_Out[us_Out] = p_Out[us_Out - us_Offset];
+            }
+        }
+        
+        return us_Out == us_OutSize;
+    }
+}
+
+
+//*************************************************************************************
+// Compress
+//*************************************************************************************
+
+bool NetCompression::Compress(std::vector<uint8_t> const& v_Message, std::vector<uint8_t>& v_Compressed)
+{
+    if (v_Message.size() <= NetMessage::us_DataPos || v_Message.size() - NetMessage::us_DataPos > NET_COMPRESSION_SIZE_MAX)
+    {
+        return false;
+    }
+    
+    size_t us_Size = v_Message.size() - NetMessage::us_DataPos;
+    
+    v_Compressed.assign(us_HeaderSize, 0);
+    v_Compressed.reserve(v_Message.size());
+    
+    v_Compressed[NetMessage::us_IDPos] = NetMessage::MSG_COMPRESSED;
+    v_Compressed[us_OriginalIDPos] = v_Message[NetMessage::us_IDPos];
+    NetMessageLayout::Store<uint32_t>(&(v_Compressed[us_OriginalSizePos]), static_cast<uint32_t>(us_Size));
+    
+    CompressBlock(&(v_Message[NetMessage::us_DataPos]), us_Size, v_Compressed);
+    
+    return v_Compressed.size() < v_Message.size();
+}
+
+//*************************************************************************************
+// Decompress
+//*************************************************************************************
+
+bool NetCompression::IsValid(std::vector<uint8_t> const& v_Compressed) noexcept
+{
+    if (v_Compressed.size() <= us_HeaderSize || v_Compressed[NetMessage::us_IDPos] != NetMessage::MSG_COMPRESSED)
+    {
+        return false;
+    }
+    
+    // Only communication messages are compressed
+    switch (v_Compressed[us_OriginalIDPos])
+    {
+        case NetMessage::MSG_TEXT:
+            break;
+        
+        default:
+            return false;
+    }
+    
+    uint32_t u32_Size = NetMessageLayout::Load<uint32_t>(&(v_Compressed[us_OriginalSizePos]));
+    
+    return u32_Size > 0 && u32_Size <= NET_COMPRESSION_SIZE_MAX;
+}
+
+bool NetCompression::Decompress(std::vector<uint8_t> const& v_Compressed, std::vector<uint8_t>& v_Message)
+{
+    if (IsValid(v_Compressed) == false)
+    {
+        return false;
+    }
+    
+    v_Message.resize(NetMessage::us_DataPos + NetMessageLayout::Load<uint32_t>(&(v_Compressed[us_OriginalSizePos])));
+    v_Message[NetMessage::us_IDPos] = v_Compressed[us_OriginalIDPos];
+    
+    return DecompressBlock(&(v_Compressed[us_HeaderSize]),
+                           v_Compressed.size() - us_HeaderSize,
+                           &(v_Message[NetMessage::us_DataPos]),
+                           v_Message.size() - NetMessage::us_DataPos);
+}
@@ -0,0 +1,100 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef NetCompression_h
+#define NetCompression_h
+
+// C / C++
+#include <cstdint>
+#include <vector>
+
+// External
+
+// Project
+#include "./NetMessage.h"
+
+// Pre-defined
+#ifndef NET_COMPRESSION_SIZE_MAX
+    #define NET_COMPRESSION_SIZE_MAX (1024 * 1024)
+#endif
+
+
+namespace NetCompression
+{
+    //*************************************************************************************
+    // Codec
+    //*************************************************************************************
+    
+    enum Codec
+    {
+        CODEC_NONE = 0,                     // Uncompressed
+        CODEC_LZ = 1,                       // Built-in LZ77 codec
+        
+        // Bounds
+        CODEC_MAX = CODEC_LZ,
+        
+        CODEC_COUNT = CODEC_MAX + 1
+    };
+    
+    // @NOTE: Compressed net messages keep the id of the original net
+    //        message and its size in front of the compressed data.
+    //        [MSG_COMPRESSED][ID][Data Size (uint32_t)][Compressed Data]
+    constexpr size_t us_OriginalIDPos = NetMessage::us_DataPos;
+    constexpr size_t us_OriginalSizePos = us_OriginalIDPos + NetMessage::us_IDSize;
+    constexpr size_t us_HeaderSize = us_OriginalSizePos + sizeof(uint32_t);
+    
+    //*************************************************************************************
+    // Compress
+    //*************************************************************************************
+    
+    /**
+     *  Compress a net message.
+     *
+     *  \param v_Message The full net message buffer.
+     *  \param v_Compressed The full compressed net message buffer to write.
+     *
+     *  \return true if the net message was compressed, false if it would not shrink.
+     */
+    
+    bool Compress(std::vector<uint8_t> const& v_Message, std::vector<uint8_t>& v_Compressed);
+    
+    //*************************************************************************************
+    // Decompress
+    //*************************************************************************************
+    
+    /**
+     *  Check if a compressed net message header is valid.
+     *
+     *  \param v_Compressed The full compressed net message buffer.
+     *
+     *  \return true if the header is valid, false if not.
+     */
+    
+    bool IsValid(std::vector<uint8_t> const& v_Compressed) noexcept;
+    
+    /**
+     *  Decompress a compressed net message.
+     *
+     *  \param v_Compressed The full compressed net message buffer.
+     *  \param v_Message The full net message buffer to write.
+     *
+     *  \return true if the net message was decompressed, false if the data is invalid.
+     */
+    
+    bool Decompress(std::vector<uint8_t> const& v_Compressed, std::vector<uint8_t>& v_Message);
+}
+
+#endif /* NetCompression_h */
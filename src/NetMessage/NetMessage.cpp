@@ -21,44 +21,226 @@
 // Project
 #include "./NetMessage.h"
 
+namespace
+{
+    //*************************************************************************************
+    // Buffer
+    //*************************************************************************************
+    
+    // @NOTE: Payloads up to NET_MESSAGE_BUFFER_SIZE stay in buffers which are
+    //        handed from released to new net messages of the same thread,
+    //        no lock is taken. Buffers are sorted by capacity, control
+    //        messages take a small buffer instead of a full one. Larger
+    //        payloads are allocated and freed with their net message.
+    enum BufferClass
+    {
+        BUFFER_SMALL = 0,
+        BUFFER_FULL = 1,
+        
+        BUFFER_CLASS_COUNT = BUFFER_FULL + 1
+    };
+    
+    constexpr size_t p_BufferCapacity[BUFFER_CLASS_COUNT] =
+    {
+        NET_MESSAGE_BUFFER_SIZE_SMALL,
+        NET_MESSAGE_BUFFER_SIZE
+    };
+    
+    // Trivially destructible, readable while thread storage is destroyed
+    thread_local bool b_BufferCacheDestroyed = false;
+    
+    struct BufferCache
+    {
+        BufferCache()
+        {
+            for (size_t i = 0; i < BUFFER_CLASS_COUNT; ++i)
+            {
+                v_Buffer[i].reserve(NET_MESSAGE_BUFFER_CACHE_COUNT);
+            }
+        }
+        
+        ~BufferCache() noexcept
+        {
+            b_BufferCacheDestroyed = true;
+        }
+        
+        std::vector<std::vector<uint8_t>> v_Buffer[BUFFER_CLASS_COUNT];
+    };
+    
+    BufferCache* GetBufferCache() noexcept
+    {
+        // Net messages released during thread exit, like the static
+        // responses, free their buffer
+        if (b_BufferCacheDestroyed == true)
+        {
+            return NULL;
+        }
+        
+        try
+        {
+            static thread_local BufferCache c_Cache;
+            return &c_Cache;
+        }
+        catch (...)
+        {
+            return NULL;
+        }
+    }
+    
+    void TakeBuffer(std::vector<uint8_t>& v_Data, size_t us_Size)
+    {
+        if (us_Size > NET_MESSAGE_BUFFER_SIZE)
+        {
+            v_Data.reserve(us_Size);
+            return;
+        }
+        
+        size_t us_Class = us_Size > NET_MESSAGE_BUFFER_SIZE_SMALL ? BUFFER_FULL : BUFFER_SMALL;
+        BufferCache* p_Cache = GetBufferCache();
+        
+        if (p_Cache != NULL && p_Cache->v_Buffer[us_Class].size() > 0)
+        {
+            v_Data.swap(p_Cache->v_Buffer[us_Class].back());
+            p_Cache->v_Buffer[us_Class].pop_back();
+            return;
+        }
+        
+        v_Data.reserve(p_BufferCapacity[us_Class]);
+    }
+    
+    void ReturnBuffer(std::vector<uint8_t>& v_Data) noexcept
+    {
+        size_t us_Capacity = v_Data.capacity();
+        size_t us_Class;
+        
+        if (us_Capacity >= NET_MESSAGE_BUFFER_SIZE && us_Capacity <= NET_MESSAGE_BUFFER_SIZE * 2)
+        {
+            us_Class = BUFFER_FULL;
+        }
+        else if (us_Capacity >= NET_MESSAGE_BUFFER_SIZE_SMALL && us_Capacity <= NET_MESSAGE_BUFFER_SIZE_SMALL * 2)
+        {
+            us_Class = BUFFER_SMALL;
+        }
+        else
+        {
+            return;
+        }
+        
+        BufferCache* p_Cache = GetBufferCache();
+        
+        // Reserved on creation, adding never allocates
+        if (p_Cache != NULL && p_Cache->v_Buffer[us_Class].size() < NET_MESSAGE_BUFFER_CACHE_COUNT)
+        {
+            v_Data.clear();
+            p_Cache->v_Buffer[us_Class].emplace_back(std::move(v_Data));
+        }
+    }
+    
+    void SwapBuffer(std::vector<uint8_t>& v_Data) noexcept
+    {
+        BufferCache* p_Cache = GetBufferCache();
+        
+        if (p_Cache != NULL && p_Cache->v_Buffer[BUFFER_FULL].size() > 0)
+        {
+            v_Data.swap(p_Cache->v_Buffer[BUFFER_FULL].back());
+            p_Cache->v_Buffer[BUFFER_FULL].pop_back();
+        }
+    }
+}
 
 //*************************************************************************************
 // Constructor / Destructor
 //*************************************************************************************
 
-NetMessage::NetMessage(uint8_t u8_ID)
+NetMessage::NetMessage(NetMessageList e_ID) : u32_ReferenceCount(0)
+{
+    TakeBuffer(v_Data, us_DataPos);
+    v_Data.emplace_back(static_cast<uint8_t>(e_ID));
+}
+
+NetMessage::NetMessage(std::vector<uint8_t>& v_Data) : u32_ReferenceCount(0)
 {
-    if (u8_ID > NET_MESSAGE_LIST_MAX)
+    if (v_Data.size() < us_DataPos)
     {
-        throw Exception("Unknown message ID!");
+        throw Exception("Invalid message data size!");
     }
     
-    v_Data.emplace_back(u8_ID);
+    // The caller keeps recieving into a reused buffer, none is
+    // allocated for callers which drop the vector
+    SwapBuffer(this->v_Data);
+    this->v_Data.swap(v_Data);
 }
 
-NetMessage::NetMessage(std::vector<uint8_t>& v_Data)
+NetMessage::NetMessage(std::vector<uint8_t> const& v_Data) : u32_ReferenceCount(0)
 {
     if (v_Data.size() < us_DataPos)
     {
         throw Exception("Invalid message data size!");
     }
     
-    this->v_Data.swap(v_Data);
+    TakeBuffer(this->v_Data, v_Data.size());
+    this->v_Data.assign(v_Data.begin(), v_Data.end());
 }
 
-NetMessage::NetMessage(std::vector<uint8_t> const& v_Data)
+NetMessage::NetMessage(std::vector<uint8_t>&& v_Data) : u32_ReferenceCount(0)
 {
     if (v_Data.size() < us_DataPos)
     {
         throw Exception("Invalid message data size!");
     }
     
-    this->v_Data = v_Data;
+    this->v_Data.swap(v_Data);
 }
 
-NetMessage::~NetMessage() noexcept
+NetMessage::NetMessage(NetMessage const& c_NetMessage) : u32_ReferenceCount(0)
+{
+    TakeBuffer(v_Data, c_NetMessage.v_Data.size());
+    v_Data.assign(c_NetMessage.v_Data.begin(), c_NetMessage.v_Data.end());
+}
+
+NetMessage::NetMessage(NetMessage&& c_NetMessage) noexcept : v_Data(std::move(c_NetMessage.v_Data)),
+                                                             u32_ReferenceCount(0)
 {}
 
+NetMessage::~NetMessage() noexcept
+{
+    ReturnBuffer(v_Data);
+}
+
+//*************************************************************************************
+// Operator
+//*************************************************************************************
+
+NetMessage& NetMessage::operator=(NetMessage const& c_NetMessage)
+{
+    v_Data = c_NetMessage.v_Data;
+    return *this;
+}
+
+NetMessage& NetMessage::operator=(NetMessage&& c_NetMessage) noexcept
+{
+    ReturnBuffer(v_Data);
+    v_Data = std::move(c_NetMessage.v_Data);
+    return *this;
+}
+
+//*************************************************************************************
+// Reference
+//*************************************************************************************
+
+void NetMessage::AddReference() noexcept
+{
+    u32_ReferenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NetMessage::Release() noexcept
+{
+    if (u32_ReferenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this;
+    }
+}
+
 //*************************************************************************************
 // Getters
 //*************************************************************************************
@@ -20,12 +20,24 @@
 // C / C++
 #include <cstdint>
 #include <vector>
+#include <atomic>
 
 // External
 
 // Project
+#include "../IntrusivePointer.h"
 #include "../Exception.h"
 
+// Pre-defined
+#ifndef NET_MESSAGE_BUFFER_SIZE
+    #define NET_MESSAGE_BUFFER_SIZE 1025 // Net message id and data
+#endif
+#ifndef NET_MESSAGE_BUFFER_SIZE_SMALL
+    #define NET_MESSAGE_BUFFER_SIZE_SMALL 64 // Control and acknowledgement messages
+#endif
+#ifndef NET_MESSAGE_BUFFER_CACHE_COUNT
+    #define NET_MESSAGE_BUFFER_CACHE_COUNT 64 // Per thread and buffer size
+#endif
 
 class NetMessage
 {
@@ -48,7 +60,10 @@ public:
     static constexpr size_t us_DataPos = us_IDPos + us_IDSize;
     
     // Versioning in case auth etc changes and needs other data
-    static constexpr uint8_t u8_NetMessageVersion = 1;
+    // @NOTE: Messages are handled as version 1, newer versions are
+    //        converted when recieved and sent.
+    static constexpr uint8_t u8_NetMessageVersion = 2;
+    static constexpr uint8_t u8_NetMessageVersionMin = 1;
     
     enum NetMessageList
     {
@@ -73,12 +88,18 @@ public:
         MSG_LOCATION,                       // Location data
         MSG_NOTIFICATION,                   // Push notification
         MSG_CUSTOM,                         // Custom data
+        MSG_FAN_OUT,                        // Communication message for all user devices
+        MSG_GET_DATA_ID,                    // Request data with message id
+        MSG_DATA_ID,                        // Data with message id, kept until acknowledged
+        MSG_ACK,                            // Acknowledge message id ranges
+        MSG_COMPRESSION,                    // Select the compression codec
+        MSG_COMPRESSED,                     // Compressed communication message
         
         /**
          *  Bounds
          */
         
-        NET_MESSAGE_LIST_MAX = MSG_CUSTOM,
+        NET_MESSAGE_LIST_MAX = MSG_COMPRESSED,
         
         NET_MESSAGE_LIST_COUNT = NET_MESSAGE_LIST_MAX + 1
     };
@@ -112,22 +133,47 @@ public:
         NET_MESSAGE_ERROR_COUNT = NET_MESSAGE_ERROR_MAX + 1
     };
     
+    enum NetMessageCapability
+    {
+        /**
+         *  Net Message Version 1
+         */
+        
+        // No Capability
+        CAP_NONE = 0,                       // Nothing supported
+        
+        // Send
+        CAP_BATCHING = 1 << 0,              // Several messages per sent frame
+        CAP_PUSH = 1 << 1,                  // Data available messages are sent
+        CAP_DATAGRAM = 1 << 2,              // Messages as QUIC datagrams
+        CAP_COMPRESSION = 1 << 3,           // Compressed messages are sent as is
+        
+        // Recieve
+        CAP_FRAMED = 1 << 4,                // Frames are sent by the client
+        CAP_LONG_POLL = 1 << 5,             // Data requests wait for messages
+        
+        // Clients without capabilities
+        CAP_DEFAULT = CAP_PUSH | CAP_LONG_POLL
+    };
+    
     //*************************************************************************************
     // Constructor / Destructor
     //*************************************************************************************
     
     /**
-     *  Default constructor.
+     *  Default constructor. Only listed ids can be given, unknown ids
+     *  are rejected at compile time instead of throwing.
      *
-     *  \param u8_ID The message id to represent.
+     *  \param e_ID The message id to represent.
      */
     
-    NetMessage(uint8_t u8_ID);
+    NetMessage(NetMessageList e_ID);
     
     /**
      *  Data constructor.
      *
-     *  \param v_Data The data for the net message. The vector data will be swapped.
+     *  \param v_Data The data for the net message. The vector data will be swapped,
+     *                the given vector recieves a empty reusable buffer.
      */
     
     NetMessage(std::vector<uint8_t>& v_Data);
@@ -141,11 +187,77 @@ public:
     NetMessage(std::vector<uint8_t> const& v_Data);
     
     /**
-     *  Default destructor.
+     *  Data constructor.
+     *
+     *  \param v_Data The data for the net message. The vector data will be moved,
+     *                no reusable buffer is given back.
+     */
+    
+    NetMessage(std::vector<uint8_t>&& v_Data);
+    
+    /**
+     *  Copy constructor. The reference count is not copied.
+     *
+     *  \param c_NetMessage NetMessage class source.
+     */
+    
+    NetMessage(NetMessage const& c_NetMessage);
+    
+    /**
+     *  Move constructor. The reference count is not moved.
+     *
+     *  \param c_NetMessage NetMessage class source.
+     */
+    
+    NetMessage(NetMessage&& c_NetMessage) noexcept;
+    
+    /**
+     *  Default destructor. Buffers up to NET_MESSAGE_BUFFER_SIZE are kept
+     *  for the next net message created on the same thread.
      */
     
     ~NetMessage() noexcept;
     
+    //*************************************************************************************
+    // Operator
+    //*************************************************************************************
+    
+    /**
+     *  Copy operator. The reference count is kept.
+     *
+     *  \param c_NetMessage NetMessage class source.
+     *
+     *  \return The assigned net message.
+     */
+    
+    NetMessage& operator=(NetMessage const& c_NetMessage);
+    
+    /**
+     *  Move operator. The reference count is kept.
+     *
+     *  \param c_NetMessage NetMessage class source.
+     *
+     *  \return The assigned net message.
+     */
+    
+    NetMessage& operator=(NetMessage&& c_NetMessage) noexcept;
+    
+    //*************************************************************************************
+    // Reference
+    //*************************************************************************************
+    
+    /**
+     *  Add a reference to a net message created with MakeIntrusive().
+     */
+    
+    void AddReference() noexcept;
+    
+    /**
+     *  Remove a reference. The net message is deleted with the last reference.
+     */
+    
+    void Release() noexcept;
+    
     //*************************************************************************************
     // Getters
     //*************************************************************************************
@@ -170,6 +282,10 @@ private:
     // Data
     //*************************************************************************************
     
+    // @NOTE: Counted in the net message, queues move the pointer
+    //        without a separate control block.
+    std::atomic<uint32_t> u32_ReferenceCount;
+    
 protected:
 
 };
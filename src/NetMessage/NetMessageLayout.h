@@ -0,0 +1,294 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef NetMessageLayout_h
+#define NetMessageLayout_h
+
+// C / C++
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <type_traits>
+
+// External
+
+// Project
+#include "./NetMessage.h"
+#include "./BufferRef.h"
+
+// Pre-defined
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    #define NET_MESSAGE_BIG_ENDIAN 1
+#else
+    #define NET_MESSAGE_BIG_ENDIAN 0
+#endif
+
+
+// @NOTE: A message layout is declared once as a list of fields, each
+//        field maps a member of the message data to the next bytes
+//        of the buffer. Offsets and sizes are resolved at compile time,
+//        parsing checks the size once and then loads every field from
+//        its fixed offset.
+namespace NetMessageLayout
+{
+    //*************************************************************************************
+    // Byte Order
+    //*************************************************************************************
+    
+    // Wire values are little endian
+    using SwapBytes = std::integral_constant<bool, NET_MESSAGE_BIG_ENDIAN != 0>;
+    
+    inline uint8_t ByteSwap(uint8_t u8_Value) noexcept { return u8_Value; }
+    inline uint16_t ByteSwap(uint16_t u16_Value) noexcept { return __builtin_bswap16(u16_Value); }
+    inline uint32_t ByteSwap(uint32_t u32_Value) noexcept { return __builtin_bswap32(u32_Value); }
+    inline uint64_t ByteSwap(uint64_t u64_Value) noexcept { return __builtin_bswap64(u64_Value); }
+    
+    template <typename T> T ToWire(T Value, std::true_type) noexcept { return ByteSwap(Value); }
+    template <typename T> T ToWire(T Value, std::false_type) noexcept { return Value; }
+    
+    /**
+     *  Load a little endian value.
+     *
+     *  \param p_Buffer The bytes to load from.
+     *
+     *  \return The loaded value.
+     */
+    
+    template <typename T> T Load(const uint8_t* p_Buffer) noexcept
+    {
+        T Value;
+        std::memcpy(&Value, p_Buffer, sizeof(T));
+        
+        return ToWire(Value, SwapBytes());
+    }
+    
+    /**
+     *  Store a value as little endian.
+     *
+     *  \param p_Buffer The bytes to store to.
+     *  \param Value The value to store.
+     */
+    
+    template <typename T> void Store(uint8_t* p_Buffer, T Value) noexcept
+    {
+        Value = ToWire(Value, SwapBytes());
+        std::memcpy(p_Buffer, &Value, sizeof(T));
+    }
+    
+    //*************************************************************************************
+    // Varint
+    //*************************************************************************************
+    
+    /**
+     *  Load a LEB128 varint and move past it.
+     *
+     *  \param p_Buffer The bytes to load from, updated to the next byte.
+     *  \param p_End The end of the bytes.
+     *  \param u64_Value The loaded value to write.
+     *
+     *  \return true if the varint was loaded, false if it is truncated or too long.
+     */
+    
+    inline bool LoadVarint(const uint8_t*& p_Buffer, const uint8_t* p_End, uint64_t& u64_Value) noexcept
+    {
+        u64_Value = 0;
+        
+        for (unsigned int u_Shift = 0; u_Shift < 64 && p_Buffer != p_End; u_Shift += 7)
+        {
+            uint8_t u8_Byte = *(p_Buffer++);
+            u64_Value |= static_cast<uint64_t>(u8_Byte & 0x7F) << u_Shift;
+            
+            if ((u8_Byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+     *  Append a value as LEB128 varint.
+     *
+     *  \param v_Buffer The buffer to append to.
+     *  \param u64_Value The value to store.
+     */
+    
+    inline void StoreVarint(std::vector<uint8_t>& v_Buffer, uint64_t u64_Value)
+    {
+        for (; u64_Value >= 0x80; u64_Value >>= 7)
+        {
+            v_Buffer.emplace_back(static_cast<uint8_t>(u64_Value | 0x80));
+        }
+        
+        v_Buffer.emplace_back(static_cast<uint8_t>(u64_Value));
+    }
+    
+    //*************************************************************************************
+    // Field
+    //*************************************************************************************
+    
+    /**
+     *  Integer field.
+     */
+    
+    template <typename Data, typename T, T Data::*p_Member> struct Scalar
+    {
+        static_assert(std::is_integral<T>::value, "Scalar fields have to be integers!");
+        
+        static constexpr size_t us_Size = sizeof(T);
+        
+        static void Load(Data& c_Data, const uint8_t* p_Field) noexcept
+        {
+            c_Data.*p_Member = NetMessageLayout::Load<T>(p_Field);
+        }
+        
+        static void Store(Data const& c_Data, uint8_t* p_Field) noexcept
+        {
+            NetMessageLayout::Store<T>(p_Field, c_Data.*p_Member);
+        }
+    };
+    
+    /**
+     *  Fixed size byte array field.
+     */
+    
+    template <typename Data, typename T, size_t us_Count, T (Data::*p_Member)[us_Count]> struct Array
+    {
+        static_assert(sizeof(T) == 1, "Array fields have to be byte arrays!");
+        
+        static constexpr size_t us_Size = us_Count;
+        
+        static void Load(Data& c_Data, const uint8_t* p_Field) noexcept
+        {
+            std::memcpy(c_Data.*p_Member, p_Field, us_Size);
+        }
+        
+        static void Store(Data const& c_Data, uint8_t* p_Field) noexcept
+        {
+            std::memcpy(p_Field, c_Data.*p_Member, us_Size);
+        }
+    };
+    
+    /**
+     *  Fixed size field referenced in the buffer.
+     */
+    
+    template <typename Data, size_t us_Count, BufferRef Data::*p_Member> struct Ref
+    {
+        static constexpr size_t us_Size = us_Count;
+        
+        static void Load(Data& c_Data, const uint8_t* p_Field) noexcept
+        {
+            c_Data.*p_Member = BufferRef(p_Field, us_Size);
+        }
+        
+        static void Store(Data const& c_Data, uint8_t* p_Field) noexcept
+        {
+            BufferRef const& c_Ref = c_Data.*p_Member;
+            std::memcpy(p_Field, c_Ref.GetData(), c_Ref.GetSize() < us_Size ? c_Ref.GetSize() : us_Size);
+        }
+    };
+    
+    //*************************************************************************************
+    // Field List
+    //*************************************************************************************
+    
+    template <size_t us_Pos, typename... Fields> struct FieldList;
+    
+    template <size_t us_Pos> struct FieldList<us_Pos>
+    {
+        static constexpr size_t us_End = us_Pos;
+        
+        template <typename Data> static void Load(Data&, const uint8_t*) noexcept
+        {}
+        
+        template <typename Data> static void Store(Data const&, uint8_t*) noexcept
+        {}
+    };
+    
+    template <size_t us_Pos, typename Field, typename... Fields> struct FieldList<us_Pos, Field, Fields...>
+    {
+        using Next = FieldList<us_Pos + Field::us_Size, Fields...>;
+        
+        static constexpr size_t us_End = Next::us_End;
+        
+        template <typename Data> static void Load(Data& c_Data, const uint8_t* p_Buffer) noexcept
+        {
+            Field::Load(c_Data, p_Buffer + us_Pos);
+            Next::Load(c_Data, p_Buffer);
+        }
+        
+        template <typename Data> static void Store(Data const& c_Data, uint8_t* p_Buffer) noexcept
+        {
+            Field::Store(c_Data, p_Buffer + us_Pos);
+            Next::Store(c_Data, p_Buffer);
+        }
+    };
+    
+    //*************************************************************************************
+    // Layout
+    //*************************************************************************************
+    
+    template <typename Data, uint8_t u8_ID, typename... Fields> struct Layout
+    {
+        using List = FieldList<NetMessage::us_DataPos, Fields...>;
+        
+        // Full size including the message id
+        static constexpr size_t us_Size = List::us_End;
+        
+        /**
+         *  Parse a net message buffer.
+         *
+         *  \param v_Buffer The net message buffer.
+         *  \param c_Data The parsed net message data to write.
+         *
+         *  \return true if the buffer was parsed, false if the size is invalid.
+         */
+        
+        static bool Parse(std::vector<uint8_t> const& v_Buffer, Data& c_Data) noexcept
+        {
+            if (v_Buffer.size() != us_Size)
+            {
+                return false;
+            }
+            
+            List::Load(c_Data, v_Buffer.data());
+            
+            return true;
+        }
+        
+        /**
+         *  Serialize net message data.
+         *
+         *  \param c_Data The net message data.
+         *
+         *  \return The net message buffer.
+         */
+        
+        static std::vector<uint8_t> Serialize(Data const& c_Data)
+        {
+            std::vector<uint8_t> v_Buffer(us_Size, '\0');
+            
+            v_Buffer[NetMessage::us_IDPos] = u8_ID;
+            List::Store(c_Data, v_Buffer.data());
+            
+            return v_Buffer;
+        }
+    };
+}
+
+#endif /* NetMessageLayout_h */
@@ -0,0 +1,58 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+
+// External
+
+// Project
+#include "./NetResponse.h"
+
+using namespace NetResponse;
+
+namespace
+{
+    // @NOTE: Created once on startup and kept until exit, the
+    //        responses are identical for all net message versions.
+    const IntrusivePointer<NetMessage> p_Response[RESPONSE_COUNT] =
+    {
+        MakeIntrusive<NetMessage>(NetMessage::MSG_NO_DATA),
+        MakeIntrusive<NetMessage>(NetMessage::MSG_DATA_AVAILABLE),
+        MakeIntrusive<NetMessage>(std::vector<uint8_t>({ NetMessage::MSG_AUTH_RESULT, NetMessage::ERR_NONE }))
+    };
+}
+
+//*************************************************************************************
+// Getters
+//*************************************************************************************
+
+IntrusivePointer<NetMessage> const& NetResponse::Get(Response e_Response) noexcept
+{
+    return p_Response[e_Response];
+}
+
+bool NetResponse::IsResponse(NetMessage const& c_NetMessage) noexcept
+{
+    for (size_t i = 0; i < RESPONSE_COUNT; ++i)
+    {
+        if (p_Response[i].get() == &c_NetMessage)
+        {
+            return true;
+        }
+    }
+    
+    return false;
+}
@@ -0,0 +1,86 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef NetResponse_h
+#define NetResponse_h
+
+// C / C++
+
+// External
+
+// Project
+#include "./NetMessage.h"
+
+// Pre-defined
+struct QUIC_BUFFER;
+
+
+namespace NetResponse
+{
+    //*************************************************************************************
+    // Response
+    //*************************************************************************************
+    
+    enum Response
+    {
+        RESPONSE_NO_DATA = 0,               // MSG_NO_DATA
+        RESPONSE_DATA_AVAILABLE = 1,        // MSG_DATA_AVAILABLE
+        RESPONSE_AUTH_RESULT = 2,           // MSG_AUTH_RESULT, ERR_NONE without capabilities
+        
+        // Bounds
+        RESPONSE_MAX = RESPONSE_AUTH_RESULT,
+        
+        RESPONSE_COUNT = RESPONSE_MAX + 1
+    };
+    
+    //*************************************************************************************
+    // Getters
+    //*************************************************************************************
+    
+    /**
+     *  Get a preallocated response. The response is shared by all clients and
+     *  has to be sent by reference, the net message data is never changed.
+     *
+     *  \param e_Response The response to get.
+     *
+     *  \return The shared response net message.
+     */
+    
+    IntrusivePointer<NetMessage> const& Get(Response e_Response) noexcept;
+    
+    /**
+     *  Get the prebuilt quic buffer of a preallocated response. The buffer owns
+     *  a copy of the response data and is shared by all sends.
+     *
+     *  \param c_NetMessage The net message to get the buffer for.
+     *
+     *  \return The shared response quic buffer, NULL if not a response.
+     */
+    
+    QUIC_BUFFER const* GetBuffer(NetMessage const& c_NetMessage) noexcept;
+    
+    /**
+     *  Check if a net message is a preallocated response.
+     *
+     *  \param c_NetMessage The net message to check.
+     *
+     *  \return true if the net message is a response, false if not.
+     */
+    
+    bool IsResponse(NetMessage const& c_NetMessage) noexcept;
+}
+
+#endif /* NetResponse_h */
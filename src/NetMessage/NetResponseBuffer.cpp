@@ -0,0 +1,69 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+
+// External
+#include <msquic.h>
+
+// Project
+#include "./NetResponse.h"
+
+using namespace NetResponse;
+
+namespace
+{
+    // @NOTE: Kept apart from the responses, only the server
+    //        sends and links the quic library.
+    class ResponseBuffer
+    {
+    public:
+        
+        ResponseBuffer()
+        {
+            for (size_t i = 0; i < RESPONSE_COUNT; ++i)
+            {
+                v_Data[i] = Get(static_cast<Response>(i))->v_Data;
+                
+                c_Buffer[i].Buffer = v_Data[i].data();
+                c_Buffer[i].Length = static_cast<uint32_t>(v_Data[i].size());
+            }
+        }
+        
+        std::vector<uint8_t> v_Data[RESPONSE_COUNT]; // Owned copy, never changed after construction
+        QUIC_BUFFER c_Buffer[RESPONSE_COUNT];
+    };
+}
+
+//*************************************************************************************
+// Getters
+//*************************************************************************************
+
+QUIC_BUFFER const* NetResponse::GetBuffer(NetMessage const& c_NetMessage) noexcept
+{
+    // Built on first use, the responses are created on startup
+    static const ResponseBuffer c_Response;
+    
+    for (size_t i = 0; i < RESPONSE_COUNT; ++i)
+    {
+        if (Get(static_cast<Response>(i)).get() == &c_NetMessage)
+        {
+            return &(c_Response.c_Buffer[i]);
+        }
+    }
+    
+    return NULL;
+}
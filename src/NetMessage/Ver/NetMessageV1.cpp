@@ -15,49 +15,65 @@
  */
 
 // C / C++
-#include <cstring>
-#ifdef __APPLE__
-    #include <libkern/OSByteOrder.h>
-#else
-    #include <byteswap.h>
-#endif
 
 // External
 
 // Project
 #include "./NetMessageV1.h"
-
-// Pre-defined
-#define IS_BIG_ENDIAN (*(uint16_t *)"\0\xff" < 0x100)
-#ifdef __APPLE__
-    #define bswap_16(x) OSSwapInt16(x)
-    #define bswap_32(x) OSSwapInt32(x)
-    #define bswap_64(x) OSSwapInt64(x)
-#endif
+#include "../NetMessageLayout.h"
 
 using namespace NetMessageV1;
+using namespace NetMessageLayout;
 
 namespace
 {
     // Data Creation
-    constexpr size_t us_MsgAuthRequestSize = NetMessage::us_DataPos +
-                                             us_SizeAccountMail +
-                                             us_SizeDeviceKey +
-                                             sizeof(uint8_t) +      /* Client Type */
-                                             sizeof(uint8_t);       /* Net Message Version */
-    constexpr size_t us_MsgAuthProofSize = NetMessage::us_DataPos +
-                                           us_SizeNonceHash;
-    constexpr size_t us_MsgNotificationSize = NetMessage::us_DataPos +
-                                              us_SizeNotificationString;
+    using MsgAuthRequest = Layout<MSG_AUTH_REQUEST_DATA, NetMessage::MSG_AUTH_REQUEST,
+                                  Ref<MSG_AUTH_REQUEST_DATA, us_SizeAccountMail, &MSG_AUTH_REQUEST_DATA::c_Mail>,
+                                  Ref<MSG_AUTH_REQUEST_DATA, us_SizeDeviceKey, &MSG_AUTH_REQUEST_DATA::c_DeviceKey>,
+                                  Scalar<MSG_AUTH_REQUEST_DATA, uint8_t, &MSG_AUTH_REQUEST_DATA::u8_ClientType>,
+                                  Scalar<MSG_AUTH_REQUEST_DATA, uint8_t, &MSG_AUTH_REQUEST_DATA::u8_Version>>;
+    using MsgAuthRequestCapability = Layout<MSG_AUTH_REQUEST_DATA, NetMessage::MSG_AUTH_REQUEST,
+                                            Ref<MSG_AUTH_REQUEST_DATA, us_SizeAccountMail, &MSG_AUTH_REQUEST_DATA::c_Mail>,
+                                            Ref<MSG_AUTH_REQUEST_DATA, us_SizeDeviceKey, &MSG_AUTH_REQUEST_DATA::c_DeviceKey>,
+                                            Scalar<MSG_AUTH_REQUEST_DATA, uint8_t, &MSG_AUTH_REQUEST_DATA::u8_ClientType>,
+                                            Scalar<MSG_AUTH_REQUEST_DATA, uint8_t, &MSG_AUTH_REQUEST_DATA::u8_Version>,
+                                            Scalar<MSG_AUTH_REQUEST_DATA, uint32_t, &MSG_AUTH_REQUEST_DATA::u32_Capability>>;
+    using MsgAuthProof = Layout<MSG_AUTH_PROOF_DATA, NetMessage::MSG_AUTH_PROOF,
+                                Ref<MSG_AUTH_PROOF_DATA, us_SizeNonceHash, &MSG_AUTH_PROOF_DATA::c_NonceHash>>;
+    using MsgNotification = Layout<MSG_NOTIFICATION_DATA, NetMessage::MSG_NOTIFICATION,
+                                   Ref<MSG_NOTIFICATION_DATA, us_SizeNotificationString, &MSG_NOTIFICATION_DATA::c_String>>;
+    using MsgCompression = Layout<MSG_COMPRESSION_DATA, NetMessage::MSG_COMPRESSION,
+                                  Scalar<MSG_COMPRESSION_DATA, uint8_t, &MSG_COMPRESSION_DATA::u8_Codec>>;
+    constexpr size_t us_MsgAckRangeSize = us_SizeMessageID +        /* First */
+                                          us_SizeMessageID;         /* Last */
     
     // Buffer Creation
-    constexpr size_t us_MsgAuthChallengeSize = NetMessage::us_DataPos +
-                                               us_SizeAccountPasswordSalt +
-                                               sizeof(uint32_t) +   /* Nonce */
-                                               sizeof(uint8_t);     /* Hash Type */
-    constexpr size_t us_MsgAuthSateSize = NetMessage::us_DataPos +
-                                          sizeof(uint8_t);          /* Auth State Result */
-    
+    using MsgAuthChallenge = Layout<MSG_AUTH_CHALLENGE_DATA, NetMessage::MSG_AUTH_CHALLENGE,
+                                    Array<MSG_AUTH_CHALLENGE_DATA, char, us_SizeAccountPasswordSalt, &MSG_AUTH_CHALLENGE_DATA::p_Salt>,
+                                    Scalar<MSG_AUTH_CHALLENGE_DATA, uint32_t, &MSG_AUTH_CHALLENGE_DATA::u32_Nonce>,
+                                    Scalar<MSG_AUTH_CHALLENGE_DATA, uint8_t, &MSG_AUTH_CHALLENGE_DATA::u8_HashType>>;
+    using MsgAuthResult = Layout<MSG_AUTH_RESULT_DATA, NetMessage::MSG_AUTH_RESULT,
+                                 Scalar<MSG_AUTH_RESULT_DATA, uint8_t, &MSG_AUTH_RESULT_DATA::u8_Result>>;
+    using MsgAuthResultCapability = Layout<MSG_AUTH_RESULT_DATA, NetMessage::MSG_AUTH_RESULT,
+                                           Scalar<MSG_AUTH_RESULT_DATA, uint8_t, &MSG_AUTH_RESULT_DATA::u8_Result>,
+                                           Scalar<MSG_AUTH_RESULT_DATA, uint32_t, &MSG_AUTH_RESULT_DATA::u32_Capability>>;
+    constexpr size_t us_MsgDataIDSize = NetMessage::us_DataPos +
+                                        us_SizeMessageID;           /* Message ID, message follows */
+    
+    // Wire sizes, a change here breaks existing clients
+    static_assert(MsgAuthRequest::us_Size == 156, "Invalid MSG_AUTH_REQUEST size!");
+    static_assert(MsgAuthProof::us_Size == 45, "Invalid MSG_AUTH_PROOF size!");
+    static_assert(MsgNotification::us_Size == 257, "Invalid MSG_NOTIFICATION size!");
+    static_assert(MsgAuthChallenge::us_Size == 22, "Invalid MSG_AUTH_CHALLENGE size!");
+    static_assert(MsgAuthResult::us_Size == 2, "Invalid MSG_AUTH_RESULT size!");
+    static_assert(MsgAuthRequestCapability::us_Size == us_SizeMsgAuthRequestCapability, "Invalid MSG_AUTH_REQUEST size!");
+    static_assert(MsgAuthResultCapability::us_Size == 6, "Invalid MSG_AUTH_RESULT size!");
+    
+    static_assert(MsgAuthRequest::us_Size == us_SizeMsgAuthRequest &&
+                  MsgAuthProof::us_Size == us_SizeMsgAuthProof &&
+                  MsgNotification::us_Size == us_SizeMsgNotification &&
+                  MsgCompression::us_Size == us_SizeMsgCompression, "Layout and message size mismatch!");
 }
 
 
@@ -65,116 +81,123 @@ namespace
 // Data Creation
 //*************************************************************************************
 
-template<> MSG_AUTH_REQUEST_DATA NetMessageV1::ToData(std::vector<uint8_t> const& v_Buffer)
+template<> bool NetMessageV1::ToData(std::vector<uint8_t> const& v_Buffer, MSG_AUTH_REQUEST_DATA& Data)
 {
-    if (v_Buffer.size() != us_MsgAuthRequestSize)
+    // Capabilities are optional
+    if (v_Buffer.size() == us_SizeMsgAuthRequestCapability)
     {
-        throw Exception("Invalid data buffer!");
+        return MsgAuthRequestCapability::Parse(v_Buffer, Data);
     }
     
-    MSG_AUTH_REQUEST_DATA c_Data;
-    size_t us_Pos = NetMessage::us_IDPos + NetMessage::us_IDSize;
-    
-    memcpy(&(c_Data.p_Mail[0]),
-           &(v_Buffer[us_Pos]),
-           us_SizeAccountMail);
-    us_Pos += us_SizeAccountMail;
-    
-    memcpy(&(c_Data.p_DeviceKey[0]),
-           &(v_Buffer[us_Pos]),
-           us_SizeDeviceKey);
-    us_Pos += us_SizeDeviceKey;
-    
-    c_Data.u8_ClientType = v_Buffer[us_Pos];
-    us_Pos += 1;
-    
-    c_Data.u8_Version = v_Buffer[us_Pos];
+    Data.u32_Capability = NetMessage::CAP_NONE;
     
-    return c_Data;
+    return MsgAuthRequest::Parse(v_Buffer, Data);
 }
 
-template<> MSG_AUTH_PROOF_DATA NetMessageV1::ToData(std::vector<uint8_t> const& v_Buffer)
+template<> bool NetMessageV1::ToData(std::vector<uint8_t> const& v_Buffer, MSG_AUTH_PROOF_DATA& Data)
 {
-    if (v_Buffer.size() != us_MsgAuthProofSize)
-    {
-        throw Exception("Invalid data buffer!");
-    }
-    
-    MSG_AUTH_PROOF_DATA c_Data;
-    size_t us_Pos = NetMessage::us_IDPos + NetMessage::us_IDSize;
-    
-    memcpy(&(c_Data.p_NonceHash[0]),
-           &(v_Buffer[us_Pos]),
-           us_SizeNonceHash);
-    
-    return c_Data;
+    return MsgAuthProof::Parse(v_Buffer, Data);
 }
 
-template<> MSG_NOTIFICATION_DATA NetMessageV1::ToData(std::vector<uint8_t> const& v_Buffer)
+template<> bool NetMessageV1::ToData(std::vector<uint8_t> const& v_Buffer, MSG_NOTIFICATION_DATA& Data)
 {
-    if (v_Buffer.size() != us_MsgNotificationSize)
+    return MsgNotification::Parse(v_Buffer, Data);
+}
+
+template<> bool NetMessageV1::ToData(std::vector<uint8_t> const& v_Buffer, MSG_COMPRESSION_DATA& Data)
+{
+    return MsgCompression::Parse(v_Buffer, Data);
+}
+
+template<> bool NetMessageV1::ToData(std::vector<uint8_t> const& v_Buffer, MSG_ACK_DATA& Data)
+{
+    size_t us_Pos = NetMessage::us_IDPos + NetMessage::us_IDSize;
+    
+    if (v_Buffer.size() <= us_Pos ||
+        (v_Buffer.size() - us_Pos) % us_MsgAckRangeSize != 0 ||
+        (v_Buffer.size() - us_Pos) / us_MsgAckRangeSize > us_SizeAckRangeMax)
     {
-        throw Exception("Invalid data buffer!");
+        return false;
     }
     
-    MSG_NOTIFICATION_DATA c_Data;
-    size_t us_Pos = NetMessage::us_IDPos + NetMessage::us_IDSize;
+    uint64_t u64_First;
+    uint64_t u64_Last;
     
-    memcpy(&(c_Data.p_String[0]),
-           &(v_Buffer[us_Pos]),
-           us_SizeNotificationString);
+    Data.v_Range.clear();
+    Data.v_Range.reserve((v_Buffer.size() - us_Pos) / us_MsgAckRangeSize);
+    
+    while (us_Pos < v_Buffer.size())
+    {
+        u64_First = Load<uint64_t>(&(v_Buffer[us_Pos]));
+        us_Pos += us_SizeMessageID;
+        
+        u64_Last = Load<uint64_t>(&(v_Buffer[us_Pos]));
+        us_Pos += us_SizeMessageID;
+        
+        if (u64_First > u64_Last)
+        {
+            return false;
+        }
+        
+        Data.v_Range.emplace_back(u64_First, u64_Last);
+    }
     
-    return c_Data;
+    return true;
 }
 
 //*************************************************************************************
 // Buffer Creation
 //*************************************************************************************
 
-template<> std::vector<uint8_t> NetMessageV1::ToBuffer(MSG_AUTH_CHALLENGE_DATA const& Data)
+template<> std::vector<uint8_t> NetMessageV1::ToBuffer(MSG_AUTH_REQUEST_DATA const& Data)
 {
-    std::vector<uint8_t> v_Buffer(us_MsgAuthChallengeSize, '\0');
-    size_t us_Pos = NetMessage::us_IDPos;
-    
-    v_Buffer[NetMessage::us_IDPos] = NetMessage::MSG_AUTH_CHALLENGE;
-    us_Pos += NetMessage::us_IDSize;
-    
-    memcpy(&(v_Buffer[us_Pos]),
-           &(Data.p_Salt[0]),
-           us_SizeAccountPasswordSalt);
-    us_Pos += us_SizeAccountPasswordSalt;
-    
-    if (IS_BIG_ENDIAN)
+    if (Data.u32_Capability != NetMessage::CAP_NONE)
     {
-        uint32_t u32_Nonce = bswap_32(Data.u32_Nonce);
-    
-        memcpy(&(v_Buffer[us_Pos]),
-               &u32_Nonce,
-               sizeof(u32_Nonce));
+        return MsgAuthRequestCapability::Serialize(Data);
     }
-    else
+    
+    return MsgAuthRequest::Serialize(Data);
+}
+
+template<> std::vector<uint8_t> NetMessageV1::ToBuffer(MSG_AUTH_CHALLENGE_DATA const& Data)
+{
+    return MsgAuthChallenge::Serialize(Data);
+}
+
+template<> std::vector<uint8_t> NetMessageV1::ToBuffer(MSG_AUTH_RESULT_DATA const& Data)
+{
+    // Clients without capabilities expect the result only
+    if (Data.u32_Capability != NetMessage::CAP_NONE)
     {
-        memcpy(&(v_Buffer[us_Pos]),
-               &(Data.u32_Nonce),
-               sizeof(Data.u32_Nonce));
+        return MsgAuthResultCapability::Serialize(Data);
     }
     
-    us_Pos += sizeof(Data.u32_Nonce);
-    
-    v_Buffer[us_Pos] = Data.u8_HashType;
-    
-    return v_Buffer;
+    return MsgAuthResult::Serialize(Data);
 }
 
-template<> std::vector<uint8_t> NetMessageV1::ToBuffer(MSG_AUTH_RESULT_DATA const& Data)
+template<> std::vector<uint8_t> NetMessageV1::ToBuffer(MSG_NOTIFICATION_DATA const& Data)
+{
+    return MsgNotification::Serialize(Data);
+}
+
+template<> std::vector<uint8_t> NetMessageV1::ToBuffer(MSG_COMPRESSION_DATA const& Data)
+{
+    return MsgCompression::Serialize(Data);
+}
+
+template<> std::vector<uint8_t> NetMessageV1::ToBuffer(MSG_DATA_ID_DATA const& Data)
 {
-    std::vector<uint8_t> v_Buffer(us_MsgAuthSateSize, '\0');
-    size_t us_Pos = NetMessage::us_IDPos;
+    std::vector<uint8_t> v_Buffer;
+    
+    v_Buffer.reserve(us_MsgDataIDSize + Data.v_Message.size());
+    v_Buffer.resize(us_MsgDataIDSize, '\0');
     
-    v_Buffer[NetMessage::us_IDPos] = NetMessage::MSG_AUTH_RESULT;
-    us_Pos += NetMessage::us_IDSize;
+    v_Buffer[NetMessage::us_IDPos] = NetMessage::MSG_DATA_ID;
+    Store<uint64_t>(&(v_Buffer[NetMessage::us_DataPos]), Data.u64_MessageID);
     
-    v_Buffer[us_Pos] = Data.u8_Result;
+    v_Buffer.insert(v_Buffer.end(),
+                    Data.v_Message.begin(),
+                    Data.v_Message.end());
     
     return v_Buffer;
 }
@@ -18,12 +18,13 @@
 #define NetMessageV1_h
 
 // C / C++
+#include <utility>
 
 // External
-#include <sodium.h>
 
 // Project
 #include "../NetMessage.h"
+#include "../BufferRef.h"
 
 
 namespace NetMessageV1
@@ -46,12 +47,25 @@ namespace NetMessageV1
     
     // Communication
     constexpr size_t us_SizeNotificationString = 256;
+    constexpr size_t us_SizeMessageID = sizeof(uint64_t);
+    constexpr size_t us_SizeAckRangeMax = 64; // Ranges per acknowledgement
+    
+    // Full recieved net message
+    constexpr size_t us_SizeMsgAuthRequest = NetMessage::us_DataPos + us_SizeAccountMail + us_SizeDeviceKey + sizeof(uint8_t) + sizeof(uint8_t);
+    constexpr size_t us_SizeMsgAuthRequestCapability = us_SizeMsgAuthRequest + sizeof(uint32_t);
+    constexpr size_t us_SizeMsgAuthProof = NetMessage::us_DataPos + us_SizeNonceHash;
+    constexpr size_t us_SizeMsgNotification = NetMessage::us_DataPos + us_SizeNotificationString;
+    constexpr size_t us_SizeMsgAckMin = NetMessage::us_DataPos + us_SizeMessageID + us_SizeMessageID;
+    constexpr size_t us_SizeMsgAckMax = NetMessage::us_DataPos + (us_SizeMessageID + us_SizeMessageID) * us_SizeAckRangeMax;
+    constexpr size_t us_SizeMsgCompression = NetMessage::us_DataPos + sizeof(uint8_t);
     
     //*************************************************************************************
     // NetMessage Data
     //*************************************************************************************
 
     // @NOTE: Client to client messages are not listed!
+    //        Recieved message data references the net message buffer,
+    //        the buffer has to outlive the data.
     
     //
     //  Server Auth
@@ -59,10 +73,11 @@ namespace NetMessageV1
     
     struct MSG_AUTH_REQUEST_DATA
     {
-        char p_Mail[us_SizeAccountMail]; // The account mail
-        char p_DeviceKey[us_SizeDeviceKey]; // Device valid for server
+        BufferRef c_Mail; // The account mail
+        BufferRef c_DeviceKey; // Device valid for server
         uint8_t u8_ClientType;  // Which type of client (platform or app)
         uint8_t u8_Version; // NetMessage version in use
+        uint32_t u32_Capability; // Supported by the client, 0 if not sent
     };
     
     struct MSG_AUTH_CHALLENGE_DATA
@@ -74,12 +89,13 @@ namespace NetMessageV1
     
     struct MSG_AUTH_PROOF_DATA
     {
-        uint8_t p_NonceHash[us_SizeNonceHash]; // Created hash
+        BufferRef c_NonceHash; // Created hash
     };
     
     struct MSG_AUTH_RESULT_DATA
     {
         uint8_t u8_Result; // The result of the auth
+        uint32_t u32_Capability; // Selected by the server, 0 if not sent
     };
     
     //
@@ -88,7 +104,23 @@ namespace NetMessageV1
     
     struct MSG_NOTIFICATION_DATA
     {
-        char p_String[us_SizeNotificationString];
+        BufferRef c_String;
+    };
+    
+    struct MSG_DATA_ID_DATA
+    {
+        uint64_t u64_MessageID; // Id to acknowledge
+        std::vector<uint8_t> v_Message; // Full stored net message
+    };
+    
+    struct MSG_ACK_DATA
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> v_Range; // First and last id, both included
+    };
+    
+    struct MSG_COMPRESSION_DATA
+    {
+        uint8_t u8_Codec; // Requested by the client, selected by the server
     };
     
     //*************************************************************************************
@@ -96,21 +128,24 @@ namespace NetMessageV1
     //*************************************************************************************
     
     /**
-     *  Convert a given client net message buffer to net message data.
+     *  Convert a given client net message buffer to net message data. No bytes
+     *  are copied, the data references the buffer. Invalid buffers are
+     *  reported by the result, recieved data is untrusted.
      *
      *  \param v_Buffer The net message buffer.
+     *  \param Data The converted net message data to write.
      *
-     *  \return The converted net message data.
+     *  \return true if the buffer was converted, false if it is invalid.
      */
 
-    template <typename T> T ToData(std::vector<uint8_t> const& v_Buffer);
+    template <typename T> bool ToData(std::vector<uint8_t> const& v_Buffer, T& Data);
     
     //*************************************************************************************
     // Buffer Creation
     //*************************************************************************************
     
     /**
-     *  Convert given server net message data to a net message buffer.
+     *  Convert given net message data to a net message buffer.
      *
      *  \param Data The data to convert.
      *
@@ -0,0 +1,200 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+
+// External
+
+// Project
+#include "./NetMessageV2.h"
+#include "../NetMessageLayout.h"
+
+using namespace NetMessageV1;
+using namespace NetMessageLayout;
+
+namespace
+{
+    // Variable length field
+    bool LoadField(const uint8_t*& p_Pos, const uint8_t* p_End, size_t us_SizeMax, BufferRef& c_Field) noexcept
+    {
+        uint64_t u64_Size;
+        
+        if (LoadVarint(p_Pos, p_End, u64_Size) == false ||
+            u64_Size > us_SizeMax ||
+            u64_Size > static_cast<uint64_t>(p_End - p_Pos))
+        {
+            return false;
+        }
+        
+        c_Field = BufferRef(p_Pos, static_cast<size_t>(u64_Size));
+        p_Pos += u64_Size;
+        
+        return true;
+    }
+    
+    // [ID][Mail Size (varint)][Mail][Device Key Size (varint)][Device Key][Client Type][Version]([Capability (varint)])
+    bool DecodeAuthRequest(std::vector<uint8_t>& v_Message)
+    {
+        const uint8_t* p_Pos = v_Message.data() + NetMessage::us_DataPos;
+        const uint8_t* p_End = v_Message.data() + v_Message.size();
+        MSG_AUTH_REQUEST_DATA c_Data;
+        uint64_t u64_Capability = NetMessage::CAP_NONE;
+        
+        if (LoadField(p_Pos, p_End, us_SizeAccountMail, c_Data.c_Mail) == false ||
+            LoadField(p_Pos, p_End, us_SizeDeviceKey, c_Data.c_DeviceKey) == false ||
+            p_End - p_Pos < 2)
+        {
+            return false;
+        }
+        
+        c_Data.u8_ClientType = *(p_Pos++);
+        c_Data.u8_Version = *(p_Pos++);
+        
+        // Capabilities are optional
+        if (p_Pos != p_End && (LoadVarint(p_Pos, p_End, u64_Capability) == false || p_Pos != p_End || u64_Capability > UINT32_MAX))
+        {
+            return false;
+        }
+        
+        c_Data.u32_Capability = static_cast<uint32_t>(u64_Capability);
+        
+        std::vector<uint8_t> v_Result = ToBuffer(c_Data);
+        v_Message.swap(v_Result);
+        
+        return true;
+    }
+    
+    // [ID][String Size (varint)][String]
+    bool DecodeNotification(std::vector<uint8_t>& v_Message)
+    {
+        const uint8_t* p_Pos = v_Message.data() + NetMessage::us_DataPos;
+        const uint8_t* p_End = v_Message.data() + v_Message.size();
+        MSG_NOTIFICATION_DATA c_Data;
+        
+        if (LoadField(p_Pos, p_End, us_SizeNotificationString, c_Data.c_String) == false || p_Pos != p_End)
+        {
+            return false;
+        }
+        
+        std::vector<uint8_t> v_Result = ToBuffer(c_Data);
+        v_Message.swap(v_Result);
+        
+        return true;
+    }
+}
+
+
+//*************************************************************************************
+// Frame
+//*************************************************************************************
+
+bool NetMessageV2::DecodeFrame(std::vector<uint8_t> const& v_Frame, std::vector<std::vector<uint8_t>>& v_Message)
+{
+    if (v_Frame.size() <= NetMessage::us_DataPos || v_Frame[NetMessage::us_IDPos] != u8_FrameID)
+    {
+        return false;
+    }
+    
+    const uint8_t* p_Pos = v_Frame.data() + NetMessage::us_DataPos;
+    const uint8_t* p_End = v_Frame.data() + v_Frame.size();
+    uint64_t u64_Size;
+    
+    v_Message.clear();
+    
+    while (p_Pos != p_End)
+    {
+        if (v_Message.size() == us_FrameCountMax ||
+            LoadVarint(p_Pos, p_End, u64_Size) == false ||
+            u64_Size < NetMessage::us_DataPos ||
+            u64_Size > static_cast<uint64_t>(p_End - p_Pos))
+        {
+            return false;
+        }
+        
+        v_Message.emplace_back(p_Pos, p_Pos + u64_Size);
+        p_Pos += u64_Size;
+        
+        if (v_Message.back()[NetMessage::us_IDPos] == NetMessage::MSG_CUSTOM || Decode(v_Message.back()) == false)
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void NetMessageV2::AddToFrame(std::vector<uint8_t>& v_Frame, std::vector<uint8_t> const& v_Message)
+{
+    if (v_Frame.size() == 0)
+    {
+        v_Frame.emplace_back(u8_FrameID);
+    }
+    
+    StoreVarint(v_Frame, v_Message.size());
+    v_Frame.insert(v_Frame.end(),
+                   v_Message.begin(),
+                   v_Message.end());
+}
+
+//*************************************************************************************
+// Net Message
+//*************************************************************************************
+
+bool NetMessageV2::Decode(std::vector<uint8_t>& v_Message)
+{
+    if (v_Message.size() < NetMessage::us_DataPos)
+    {
+        return false;
+    }
+    
+    // @NOTE: Only messages with fixed size fields differ, all
+    //        others are the same as version 1.
+    switch (v_Message[NetMessage::us_IDPos])
+    {
+        case NetMessage::MSG_AUTH_REQUEST:
+            return DecodeAuthRequest(v_Message);
+        case NetMessage::MSG_NOTIFICATION:
+            return DecodeNotification(v_Message);
+        case u8_FrameID:
+            return false;
+        
+        default:
+            return true;
+    }
+}
+
+void NetMessageV2::Encode(std::vector<uint8_t>& v_Message)
+{
+    MSG_NOTIFICATION_DATA c_Data;
+    
+    // Only notifications are sent by the server
+    if (v_Message.size() == 0 ||
+        v_Message[NetMessage::us_IDPos] != NetMessage::MSG_NOTIFICATION ||
+        ToData(v_Message, c_Data) == false)
+    {
+        return;
+    }
+    
+    size_t us_Length = c_Data.c_String.GetStringLength();
+    std::vector<uint8_t> v_Result(1, NetMessage::MSG_NOTIFICATION);
+    
+    StoreVarint(v_Result, us_Length);
+    v_Result.insert(v_Result.end(),
+                    c_Data.c_String.GetData(),
+                    c_Data.c_String.GetData() + us_Length);
+    
+    v_Message.swap(v_Result);
+}
@@ -0,0 +1,89 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef NetMessageV2_h
+#define NetMessageV2_h
+
+// C / C++
+#include <cstdint>
+#include <vector>
+
+// External
+
+// Project
+#include "./NetMessageV1.h"
+
+
+// @NOTE: Version 2 messages are version 1 messages with variable length
+//        fields. Several messages can be sent in one frame, every message
+//        is prefixed with its varint length:
+//        [Frame ID][Size (varint)][Net Message]...[Size (varint)][Net Message]
+//        Single messages on a stream use the connection version.
+namespace NetMessageV2
+{
+    //*************************************************************************************
+    // Frame
+    //*************************************************************************************
+    
+    constexpr uint8_t u8_FrameID = 0xFF; // Never a net message id
+    constexpr size_t us_FrameCountMax = 64; // Net messages per frame
+    
+    /**
+     *  Convert a recieved frame to version 1 net messages. Custom net
+     *  messages are spooled and can't be part of a frame.
+     *
+     *  \param v_Frame The full frame buffer.
+     *  \param v_Message The version 1 net message buffers to write.
+     *
+     *  \return true if the frame was converted, false if it is invalid.
+     */
+    
+    bool DecodeFrame(std::vector<uint8_t> const& v_Frame, std::vector<std::vector<uint8_t>>& v_Message);
+    
+    /**
+     *  Add a version 2 net message to a frame.
+     *
+     *  \param v_Frame The frame buffer to add to, started if empty.
+     *  \param v_Message The version 2 net message buffer.
+     */
+    
+    void AddToFrame(std::vector<uint8_t>& v_Frame, std::vector<uint8_t> const& v_Message);
+    
+    //*************************************************************************************
+    // Net Message
+    //*************************************************************************************
+    
+    /**
+     *  Convert a recieved version 2 net message to version 1.
+     *
+     *  \param v_Message The net message buffer to convert.
+     *
+     *  \return true if the net message was converted, false if it is invalid.
+     */
+    
+    bool Decode(std::vector<uint8_t>& v_Message);
+    
+    /**
+     *  Convert a version 1 net message to version 2. Net messages with an
+     *  invalid size are kept.
+     *
+     *  \param v_Message The net message buffer to convert.
+     */
+    
+    void Encode(std::vector<uint8_t>& v_Message);
+}
+
+#endif /* NetMessageV2_h */
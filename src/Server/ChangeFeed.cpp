@@ -0,0 +1,109 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <chrono>
+
+// External
+
+// Project
+#include "./ChangeFeed.h"
+#include "../Logger.h"
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+ChangeFeed::ChangeFeed(ClientPool& c_ClientPool,
+                       std::unique_ptr<MySQLStore> p_MySQLStore,
+                       int i_IntervalMS) : c_ClientPool(c_ClientPool),
+                                           p_MySQLStore(std::move(p_MySQLStore)),
+                                           i_IntervalMS(i_IntervalMS),
+                                           b_Run(true)
+{
+    if (this->p_MySQLStore == NULL)
+    {
+        throw Exception("Invalid change feed store!");
+    }
+    
+    // Messages before start are found by requests
+    u64_MessageID = this->p_MySQLStore->GetLastMessageID();
+    
+    try
+    {
+        c_Thread = std::thread(Update, this);
+    }
+    catch (std::exception& e)
+    {
+        throw Exception(e.what());
+    }
+}
+
+ChangeFeed::~ChangeFeed() noexcept
+{
+    c_Mutex.lock();
+    b_Run = false;
+    c_Mutex.unlock();
+    
+    c_Condition.notify_one();
+    c_Thread.join();
+}
+
+//*************************************************************************************
+// Update
+//*************************************************************************************
+
+void ChangeFeed::Update(ChangeFeed* p_Instance) noexcept
+{
+    std::vector<InboxKey> v_Recipient;
+    std::unique_lock<std::mutex> c_Lock(p_Instance->c_Mutex);
+    
+    while (p_Instance->b_Run == true)
+    {
+        c_Lock.unlock();
+        
+        try
+        {
+            // Read until caught up, large bursts need multiple batches
+            do
+            {
+                p_Instance->p_MySQLStore->GetRecipients(p_Instance->u64_MessageID,
+                                                        CHANGE_FEED_BATCH_SIZE,
+                                                        v_Recipient);
+                
+                for (auto& Recipient : v_Recipient)
+                {
+                    p_Instance->c_ClientPool.DataAvailable(Recipient);
+                }
+            }
+            while (v_Recipient.size() == CHANGE_FEED_BATCH_SIZE);
+        }
+        catch (std::exception& e)
+        {
+            Logger::Singleton().Log(Logger::ERROR, "Failed to read change feed: " +
+                                                   std::string(e.what()),
+                                    "ChangeFeed.cpp", __LINE__);
+        }
+        
+        c_Lock.lock();
+        
+        if (p_Instance->b_Run == true)
+        {
+            p_Instance->c_Condition.wait_for(c_Lock, std::chrono::milliseconds(p_Instance->i_IntervalMS));
+        }
+    }
+}
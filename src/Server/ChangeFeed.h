@@ -0,0 +1,108 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef ChangeFeed_h
+#define ChangeFeed_h
+
+// C / C++
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+// External
+
+// Project
+#include "./ClientPool.h"
+#include "../Database/MySQL/MySQLStore.h"
+
+// Pre-defined
+#ifndef CHANGE_FEED_BATCH_SIZE
+    #define CHANGE_FEED_BATCH_SIZE 1024
+#endif
+
+
+class ChangeFeed
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     *
+     *  \param c_ClientPool The client pool to notify.
+     *  \param p_MySQLStore The mysql store to read new messages from. The store is
+     *                      only used by the change feed.
+     *  \param i_IntervalMS The interval in which new messages are read.
+     */
+    
+    ChangeFeed(ClientPool& c_ClientPool,
+               std::unique_ptr<MySQLStore> p_MySQLStore,
+               int i_IntervalMS);
+    
+    /**
+     *  Copy constructor. Disabled for this class.
+     *
+     *  \param c_ChangeFeed ChangeFeed class source.
+     */
+    
+    ChangeFeed(ChangeFeed const& c_ChangeFeed) = delete;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~ChangeFeed() noexcept;
+    
+private:
+    
+    //*************************************************************************************
+    // Update
+    //*************************************************************************************
+    
+    /**
+     *  Run the change feed update.
+     *
+     *  \param p_Instance The change feed instance to update with.
+     */
+    
+    static void Update(ChangeFeed* p_Instance) noexcept;
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    ClientPool& c_ClientPool;
+    std::unique_ptr<MySQLStore> p_MySQLStore;
+    int i_IntervalMS;
+    
+    // @NOTE: Only new message ids are read, messages stored by other
+    //        instances are notified the same as local ones.
+    uint64_t u64_MessageID;
+    
+    std::mutex c_Mutex;
+    std::condition_variable c_Condition;
+    std::thread c_Thread;
+    bool b_Run; // Guarded by mutex
+    
+protected:
+
+};
+
+#endif /* ChangeFeed_h */
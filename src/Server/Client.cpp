@@ -15,32 +15,55 @@
  */
 
 // C / C++
+#include <algorithm>
+#include <limits>
 
 // External
 
 // Project
 #include "./Client.h"
+#include "./ClientPool.h"
 #include "./Client/ClientAuthentication.h"
 #include "./Client/ClientCommunication.h"
 #include "./MsQuic/MsQuic.h"
+#include "../Database/Database.h"
+#include "../NetMessage/NetCompression.h"
+#include "../NetMessage/NetResponse.h"
+#include "../NetMessage/Ver/NetMessageV2.h"
 #include "../Logger.h"
 
 // Pre-defined
 #ifndef CLIENT_EXTENDED_LOGGING
     #define CLIENT_EXTENDED_LOGGING 0
 #endif
+#ifndef CLIENT_DIRECT_TIMEOUT_S
+    #define CLIENT_DIRECT_TIMEOUT_S 10
+#endif
 
 using namespace ClientAuthentication;
 using namespace ClientCommunication;
 
+namespace
+{
+    // Forwarded net messages carry data, no upper limit
+    constexpr size_t us_SizeMsgDataMin = NetMessage::us_DataPos + 1;
+    constexpr size_t us_SizeMsgDataMax = std::numeric_limits<size_t>::max();
+    constexpr size_t us_SizeMsgCompressedMin = NetCompression::us_HeaderSize + 1;
+}
+
 
 //*************************************************************************************
 // Constructor / Destructor
 //*************************************************************************************
 
-Client::Client(const QUIC_API_TABLE* p_APITable,
+Client::Client(ClientPool& c_ClientPool,
+               const QUIC_API_TABLE* p_APITable,
                HQUIC p_Connection,
                size_t us_ClientID) noexcept : us_ClientID(us_ClientID),
+                                              b_Parked(false),
+                                              b_ParkedID(false),
+                                              u64_NextSendID(1),
+                                              c_ClientPool(c_ClientPool),
                                               p_APITable(p_APITable),
                                               p_Connection(p_Connection)
 {}
@@ -80,6 +103,9 @@ void Client::Disconnected() noexcept
                             "Client.cpp", __LINE__);
 #endif
     
+    // @NOTE: No direct messages are accepted after this point, the
+    //        final job run stores the undelivered ones.
+    c_Direct.Close();
     p_Connection = NULL;
 }
 
@@ -101,13 +127,7 @@ void Client::Disconnect() noexcept
 
 bool Client::Perform(std::shared_ptr<ThreadShared>& p_Shared) noexcept
 {
-    if (p_Connection == NULL)
-    {
-        // @NOTE: Return success, connection dead and
-        //        nothing left to do.
-        return true;
-    }
-    else if (c_PerformMutex.try_lock() == false)
+    if (c_PerformMutex.try_lock() == false)
     {
         // @NOTE: Same client might be in different threads due to
         //        multiple added recieved messages!
@@ -117,94 +137,89 @@ bool Client::Perform(std::shared_ptr<ThreadShared>& p_Shared) noexcept
         return false;
     }
     
+    Database* p_Database = dynamic_cast<Database*>(p_Shared.get());
+    MessageStore& c_MessageStore = *(p_Database->p_MessageStore);
+    
+    // Handle finished sends first
+    UpdateDelivery(c_MessageStore);
+    
+    if (p_Connection == NULL)
+    {
+        // @NOTE: Return success, connection dead and nothing
+        //        left to do after keeping undelivered messages.
+        ForwardNotification(c_MessageStore);
+        StoreDirect(c_MessageStore);
+        
+        c_PerformMutex.unlock();
+        return true;
+    }
+    
+    // Parked data request, answer once messages arrived or timed out
+    if (b_Parked == true)
+    {
+        std::vector<uint8_t> v_Message;
+        uint64_t u64_MessageID;
+        uint64_t u64_Generation = c_Direct.GetGeneration();
+        
+        if (ClientCommunication::RetrieveMessage(c_MessageStore,
+                                                 c_UserInfo,
+                                                 v_Message,
+                                                 u64_MessageID) == true)
+        {
+            NetMessage c_Result(std::move(v_Message));
+            
+            SendStored(c_Result, u64_MessageID, b_ParkedID);
+            b_Parked = false;
+        }
+        else
+        {
+            c_Direct.SetDrained(u64_Generation);
+            
+            if (std::chrono::steady_clock::now() >= c_ParkExpire)
+            {
+                c_Send.Add(NetResponse::Get(NetResponse::RESPONSE_NO_DATA));
+                b_Parked = false;
+            }
+        }
+    }
+    
     // Grab and process recieved messages
-    std::shared_ptr<NetMessage> p_Recieved;
+    IntrusivePointer<NetMessage> p_Recieved;
     
     while ((p_Recieved = c_Recieved.GetElement()) != NULL)
     {
         try
         {
             auto& Recieved = *p_Recieved;
-            Database& c_Database = dynamic_cast<Database&>(*(p_Shared.get()));
             
-            switch (Recieved.GetID())
+            // Frames are always version 2, single messages use the auth version
+            if (Recieved.v_Data[NetMessage::us_IDPos] == NetMessageV2::u8_FrameID)
             {
-                /**
-                 *  Net Message Version 1
-                 */
+                std::vector<std::vector<uint8_t>> v_Frame;
                 
-                // Server Auth
-                case NetMessage::MSG_AUTH_REQUEST:
-                {
-                    NetMessage c_Result = HandleAuthRequest(ToData<MSG_AUTH_REQUEST_DATA>(Recieved.v_Data),
-                                                            c_Database,
-                                                            c_UserInfo);
-                    
-                    // We should recieve MSG_AUTH_CHALLENGE on success
-                    if (c_Result.GetID() == NetMessage::MSG_AUTH_RESULT)
-                    {
-                        Disconnect();
-                    }
-                    
-                    c_Send.Add(std::make_shared<NetMessage>(c_Result));
-                    break;
-                }
-                case NetMessage::MSG_AUTH_PROOF:
-                {
-                    NetMessage c_Result = HandleAuthProof(ToData<MSG_AUTH_PROOF_DATA>(Recieved.v_Data),
-                                                          c_Database,
-                                                          c_UserInfo);
-                    
-                    // Our proof result is an error? (Pos 1, uint8_t)
-                    if (c_Result.v_Data[NetMessage::us_DataPos] != NetMessage::ERR_NONE)
-                    {
-                        Disconnect();
-                    }
-                    
-                    c_Send.Add(std::make_shared<NetMessage>(c_Result));
-                    break;
-                }
-                    
-                // Communication
-                case NetMessage::MSG_GET_DATA:
+                // Frames need to be negotiated after auth
+                if (c_UserInfo.b_Authenticated == false ||
+                    (c_UserInfo.u32_Capability & NetMessage::CAP_FRAMED) == 0 ||
+                    NetMessageV2::DecodeFrame(Recieved.v_Data, v_Frame) == false)
                 {
-                    if (c_UserInfo.b_Authenticated == false)
-                    {
-                        Disconnect();
-                        break;
-                    }
-                    
-                    c_Send.Add(std::make_shared<NetMessage>(ClientCommunication::RetrieveMessage(c_Database,
-                                                                                                 c_UserInfo)));
-                    break;
-                }
-                case NetMessage::MSG_TEXT:
-                case NetMessage::MSG_LOCATION:
-                {
-                    if (c_UserInfo.b_Authenticated == false)
-                    {
-                        Disconnect();
-                        break;
-                    }
-                    
-                    ClientCommunication::StoreMessage(Recieved,
-                                                      c_Database,
-                                                      c_UserInfo);
-                    break;
+                    Disconnect();
+                    continue;
                 }
-                case NetMessage::MSG_NOTIFICATION: { break; } // NYI
-                case NetMessage::MSG_CUSTOM: { break; } // NYI
-                    
-                /**
-                 *  Unk
-                 */
-                    
-                default:
+                
+                for (auto& Message : v_Frame)
                 {
-                    Disconnect();
-                    break;
+                    NetMessage c_NetMessage(Message);
+                    Process(c_NetMessage, p_Database);
                 }
             }
+            else if (c_UserInfo.u8_Version > 1 && NetMessageV2::Decode(Recieved.v_Data) == false)
+            {
+                Disconnect();
+            }
+            else
+            {
+                Process(Recieved, p_Database);
+            }
         }
         catch (std::exception& e)
         {
@@ -222,6 +237,9 @@ bool Client::Perform(std::shared_ptr<ThreadShared>& p_Shared) noexcept
         }
     }
     
+    // Coalesced notification window ended
+    ForwardNotification(c_MessageStore);
+    
     // Processed recieved messages, now send
     bool b_Result = true;
     
@@ -254,6 +272,302 @@ bool Client::Perform(std::shared_ptr<ThreadShared>& p_Shared) noexcept
     return (p_Connection == NULL ? true : b_Result);
 }
 
+//*************************************************************************************
+// Process
+//*************************************************************************************
+
+// @NOTE: Indexed by net message id, server sent and unknown ids have
+//        no handler. The size range is checked before processing.
+constexpr Client::Handler Client::p_Handler[NetMessage::NET_MESSAGE_LIST_COUNT] =
+{
+    /**
+     *  Net Message Version 1
+     */
+    
+    // Unk
+    { NULL, false, 0, 0 },                                                                   // MSG_UNK
+    
+    // Server Auth
+    { &Client::ProcessAuthRequest, false, us_SizeMsgAuthRequest, us_SizeMsgAuthRequestCapability }, // MSG_AUTH_REQUEST
+    { NULL, false, 0, 0 },                                                                   // MSG_AUTH_CHALLENGE
+    { &Client::ProcessAuthProof, false, us_SizeMsgAuthProof, us_SizeMsgAuthProof },          // MSG_AUTH_PROOF
+    { NULL, false, 0, 0 },                                                                   // MSG_AUTH_RESULT
+    
+    // Communication
+    { NULL, false, 0, 0 },                                                                   // MSG_DATA_AVAILABLE
+    { &Client::ProcessGetData, true, NetMessage::us_DataPos, NetMessage::us_DataPos },       // MSG_GET_DATA
+    { NULL, false, 0, 0 },                                                                   // MSG_NO_DATA
+    { &Client::ProcessMessage, true, us_SizeMsgDataMin, us_SizeMsgDataMax },                 // MSG_TEXT
+    { &Client::ProcessMessage, true, us_SizeMsgDataMin, us_SizeMsgDataMax },                 // MSG_LOCATION
+    { &Client::ProcessNotification, true, us_SizeMsgNotification, us_SizeMsgNotification },  // MSG_NOTIFICATION
+    { &Client::ProcessCustom, true, us_SizeMsgDataMin, us_SizeMsgDataMax },                  // MSG_CUSTOM
+    { &Client::ProcessFanOut, true, us_SizeMsgDataMin, us_SizeMsgDataMax },                  // MSG_FAN_OUT
+    { &Client::ProcessGetData, true, NetMessage::us_DataPos, NetMessage::us_DataPos },       // MSG_GET_DATA_ID
+    { NULL, false, 0, 0 },                                                                   // MSG_DATA_ID
+    { &Client::ProcessAck, true, us_SizeMsgAckMin, us_SizeMsgAckMax },                       // MSG_ACK
+    { &Client::ProcessCompression, true, us_SizeMsgCompression, us_SizeMsgCompression },     // MSG_COMPRESSION
+    { &Client::ProcessCompressed, true, us_SizeMsgCompressedMin, us_SizeMsgDataMax }         // MSG_COMPRESSED
+};
+
+void Client::Process(NetMessage& c_NetMessage, Database* p_Database)
+{
+    static_assert(p_Handler[NetMessage::MSG_UNK].p_Process == NULL, "Unknown net messages are not accepted");
+    
+    NetMessage::NetMessageList e_ID = c_NetMessage.GetID();
+    Handler const& c_Handler = p_Handler[e_ID <= NetMessage::NET_MESSAGE_LIST_MAX ? e_ID : NetMessage::MSG_UNK];
+    
+    // Unknown, server sent or invalid for the client state
+    if (c_Handler.p_Process == NULL ||
+        (c_Handler.b_Authenticated == true && c_UserInfo.b_Authenticated == false) ||
+        c_NetMessage.v_Data.size() < c_Handler.us_SizeMin ||
+        c_NetMessage.v_Data.size() > c_Handler.us_SizeMax)
+    {
+        // Rejected custom net messages are not kept
+        uint64_t u64_SpoolID = CustomSpool::ToSpoolID(c_NetMessage.v_Data);
+        
+        if (u64_SpoolID != 0)
+        {
+            c_ClientPool.GetCustomSpool().Remove(u64_SpoolID);
+        }
+        
+        Disconnect();
+        return;
+    }
+    
+    (this->*(c_Handler.p_Process))(c_NetMessage, p_Database);
+}
+
+void Client::ProcessAuthRequest(NetMessage& c_NetMessage, Database* p_Database)
+{
+    MSG_AUTH_REQUEST_DATA c_Request;
+    
+    if (ToData(c_NetMessage.v_Data, c_Request) == false)
+    {
+        Disconnect();
+        return;
+    }
+    
+    NetMessage c_Result = HandleAuthRequest(c_Request,
+                                            *(p_Database->p_AccountStore),
+                                            *(p_Database->p_AccountCache),
+                                            c_UserInfo);
+    
+    // We should recieve MSG_AUTH_CHALLENGE on success
+    if (c_Result.GetID() == NetMessage::MSG_AUTH_RESULT)
+    {
+        Disconnect();
+    }
+    
+    c_Send.Add(MakeIntrusive<NetMessage>(std::move(c_Result)));
+}
+
+void Client::ProcessAuthProof(NetMessage& c_NetMessage, Database* /* p_Database */)
+{
+    MSG_AUTH_PROOF_DATA c_Proof;
+    
+    if (ToData(c_NetMessage.v_Data, c_Proof) == false)
+    {
+        Disconnect();
+        return;
+    }
+    
+    // Repeated proofs get the shared result, already online
+    if (c_UserInfo.b_Authenticated == true && c_UserInfo.b_CapabilityResult == false)
+    {
+        c_Send.Add(NetResponse::Get(NetResponse::RESPONSE_AUTH_RESULT));
+        return;
+    }
+    
+    NetMessage c_Result = HandleAuthProof(c_Proof,
+                                          c_UserInfo);
+    
+    // Our proof result is an error? (Pos 1, uint8_t)
+    uint8_t u8_SenderType;
+    
+    if (c_Result.v_Data[NetMessage::us_DataPos] != NetMessage::ERR_NONE)
+    {
+        Disconnect();
+    }
+    else if (GetSenderType(c_UserInfo, u8_SenderType) == true)
+    {
+        // Online, now notified for stored messages
+        c_ClientPool.SetOnline(us_ClientID, InboxKey(c_UserInfo.u32_UserID,
+                                                     c_UserInfo.s_DeviceKey,
+                                                     u8_SenderType));
+    }
+    
+    c_Send.Add(MakeIntrusive<NetMessage>(std::move(c_Result)));
+}
+
+void Client::ProcessGetData(NetMessage& c_NetMessage, Database* p_Database)
+{
+    bool b_WithID = c_NetMessage.GetID() == NetMessage::MSG_GET_DATA_ID;
+    std::vector<uint8_t> v_Message;
+    uint64_t u64_MessageID;
+    uint64_t u64_Generation = c_Direct.GetGeneration();
+    
+    // Stored messages are acknowledged on send completion
+    // or by the client with the message id
+    if (ClientCommunication::RetrieveMessage(*(p_Database->p_MessageStore),
+                                             c_UserInfo,
+                                             v_Message,
+                                             u64_MessageID) == true)
+    {
+        NetMessage c_Result(std::move(v_Message));
+        
+        SendStored(c_Result, u64_MessageID, b_WithID);
+        b_Parked = false;
+        
+        return;
+    }
+    
+    // Read completely, online senders deliver directly from now on
+    c_Direct.SetDrained(u64_Generation);
+    
+    if (c_ClientPool.GetLongPollS() > 0 && (c_UserInfo.u32_Capability & NetMessage::CAP_LONG_POLL) != 0)
+    {
+        // Wait for messages instead of answering empty,
+        // woken by new messages or the timer
+        if (b_Parked == false)
+        {
+            c_ParkExpire = std::chrono::steady_clock::now() + std::chrono::seconds(c_ClientPool.GetLongPollS());
+            b_ParkedID = b_WithID;
+            b_Parked = true;
+            
+            c_ClientPool.UpdateAt(us_ClientID, c_ParkExpire);
+        }
+    }
+    else
+    {
+        c_Send.Add(NetResponse::Get(NetResponse::RESPONSE_NO_DATA));
+    }
+}
+
+void Client::ProcessAck(NetMessage& c_NetMessage, Database* p_Database)
+{
+    MSG_ACK_DATA c_Ack;
+    
+    if (ToData(c_NetMessage.v_Data, c_Ack) == false)
+    {
+        Disconnect();
+        return;
+    }
+    
+    AcknowledgeClaims(c_Ack.v_Range,
+                      *(p_Database->p_MessageStore));
+}
+
+void Client::ProcessMessage(NetMessage& c_NetMessage, Database* p_Database)
+{
+    // Large text is kept compressed, also in the store
+    // @NOTE: Only for clients which negotiated compression,
+    //        recipients without it get the text decompressed.
+    int i_SizeMin = c_ClientPool.GetCompressionSizeMin();
+    
+    if ((c_UserInfo.u32_Capability & NetMessage::CAP_COMPRESSION) != 0 &&
+        i_SizeMin > 0 &&
+        c_NetMessage.GetID() == NetMessage::MSG_TEXT &&
+        c_NetMessage.v_Data.size() >= static_cast<size_t>(i_SizeMin))
+    {
+        std::vector<uint8_t> v_Compressed;
+        
+        if (NetCompression::Compress(c_NetMessage.v_Data, v_Compressed) == true)
+        {
+            c_NetMessage.v_Data.swap(v_Compressed);
+        }
+    }
+    
+    ForwardMessage(c_NetMessage, *(p_Database->p_MessageStore));
+}
+
+void Client::ProcessCompression(NetMessage& c_NetMessage, Database* /* p_Database */)
+{
+    MSG_COMPRESSION_DATA c_Compression;
+    
+    if (ToData(c_NetMessage.v_Data, c_Compression) == false)
+    {
+        Disconnect();
+        return;
+    }
+    
+    // Unknown codecs are answered with none
+    if (c_Compression.u8_Codec > NetCompression::CODEC_MAX)
+    {
+        c_Compression.u8_Codec = NetCompression::CODEC_NONE;
+    }
+    
+    if (c_Compression.u8_Codec == NetCompression::CODEC_LZ)
+    {
+        c_UserInfo.u32_Capability |= NetMessage::CAP_COMPRESSION;
+    }
+    else
+    {
+        c_UserInfo.u32_Capability &= ~NetMessage::CAP_COMPRESSION;
+    }
+    
+    c_Send.Add(MakeIntrusive<NetMessage>(ToBuffer(c_Compression)));
+}
+
+void Client::ProcessCompressed(NetMessage& c_NetMessage, Database* p_Database)
+{
+    // Decompressed by recipients without compression
+    if ((c_UserInfo.u32_Capability & NetMessage::CAP_COMPRESSION) == 0 ||
+        NetCompression::IsValid(c_NetMessage.v_Data) == false)
+    {
+        Disconnect();
+        return;
+    }
+    
+    ForwardMessage(c_NetMessage, *(p_Database->p_MessageStore));
+}
+
+void Client::ProcessFanOut(NetMessage& c_NetMessage, Database* p_Database)
+{
+    // Stored once, every device of the user retrieves it
+    if (ClientCommunication::StoreFanOutMessage(c_NetMessage,
+                                                *(p_Database->p_MessageStore),
+                                                c_UserInfo) == true)
+    {
+        c_ClientPool.DataAvailable(InboxKey(c_UserInfo.u32_UserID,
+                                            "",
+                                            c_UserInfo.u8_ClientType));
+    }
+}
+
+void Client::ProcessNotification(NetMessage& c_NetMessage, Database* p_Database)
+{
+    MSG_NOTIFICATION_DATA c_Data;
+    
+    if (ToData(c_NetMessage.v_Data, c_Data) == false)
+    {
+        Disconnect();
+        return;
+    }
+    
+    if (c_ClientPool.GetNotificationWindowMS() <= 0)
+    {
+        ForwardMessage(c_NetMessage, *(p_Database->p_MessageStore));
+        return;
+    }
+    
+    // Bursts are coalesced, the newest is forwarded once
+    // the window of the first ended
+    if (c_Notification.Add(c_NetMessage.v_Data, std::chrono::steady_clock::now() + std::chrono::milliseconds(c_ClientPool.GetNotificationWindowMS())) == true)
+    {
+        c_ClientPool.UpdateAt(us_ClientID, c_Notification.GetExpire());
+    }
+}
+
+void Client::ProcessCustom(NetMessage& c_NetMessage, Database* p_Database)
+{
+    // @NOTE: Recieved custom net messages were spooled
+    //        while recieved, only the reference is forwarded.
+    if (CustomSpool::ToSpoolID(c_NetMessage.v_Data) != 0)
+    {
+        ForwardMessage(c_NetMessage, *(p_Database->p_MessageStore));
+    }
+}
+
 //*************************************************************************************
 // Recieve
 //*************************************************************************************
@@ -277,11 +591,20 @@ void Client::RecieveNetMessage(StreamData& c_Data) noexcept
                                 "Client.cpp", __LINE__);
 #endif
     
+    // Nothing to handle, dropped without building a message
+    if (c_Data.v_Bytes.size() < NetMessage::us_DataPos)
+    {
+        return;
+    }
+    
+    // Spooled custom net messages are removed if not added
+    uint64_t u64_SpoolID = CustomSpool::ToSpoolID(c_Data.v_Bytes);
+    
     // No free space, add new
     try
     {
-        std::shared_ptr<NetMessage> p_Message = std::make_shared<NetMessage>(c_Data.v_Bytes);
-        c_Recieved.Add(p_Message);
+        IntrusivePointer<NetMessage> p_Message = MakeIntrusive<NetMessage>(c_Data.v_Bytes);
+        c_Recieved.Add(std::move(p_Message));
     }
     catch (std::exception& e)
     {
@@ -296,15 +619,74 @@ void Client::RecieveNetMessage(StreamData& c_Data) noexcept
                                                " ): Failed to add recieved net message: " +
                                                e.what(),
                                 "Client.cpp", __LINE__);
+        
+        if (u64_SpoolID != 0)
+        {
+            c_ClientPool.GetCustomSpool().Remove(u64_SpoolID);
+        }
+    }
+}
+
+bool Client::RecieveDirectMessage(NetMessage const& c_NetMessage) noexcept
+{
+    try
+    {
+        return c_Direct.Add(c_NetMessage);
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "(Client ID: " +
+                                               std::to_string(us_ClientID) +
+                                               ", User ID " +
+                                               std::to_string(c_UserInfo.u32_UserID) +
+                                               ", Device Key: " +
+                                               c_UserInfo.s_DeviceKey +
+                                               ", Client Type: " +
+                                               std::to_string(c_UserInfo.u8_ClientType) +
+                                               " ): Failed to add direct message: " +
+                                               e.what(),
+                                "Client.cpp", __LINE__);
+        return false;
+    }
+}
+
+void Client::RecieveDataSent(uint64_t u64_SendID, bool b_Delivered) noexcept
+{
+    try
+    {
+        c_Tracker.Complete(u64_SendID, b_Delivered);
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "(Client ID: " +
+                                               std::to_string(us_ClientID) +
+                                               ", User ID " +
+                                               std::to_string(c_UserInfo.u32_UserID) +
+                                               ", Device Key: " +
+                                               c_UserInfo.s_DeviceKey +
+                                               ", Client Type: " +
+                                               std::to_string(c_UserInfo.u8_ClientType) +
+                                               " ): Failed to add sent message notification: " +
+                                               e.what(),
+                                "Client.cpp", __LINE__);
     }
 }
 
 void Client::RecieveDataAvailable() noexcept
 {
+    // Stored messages are read before direct ones
+    c_Direct.SetAvailable();
+    
+    // Parked requests retrieve on the next run
+    if (b_Parked == true)
+    {
+        return;
+    }
+    
     try
     {
-        std::shared_ptr<NetMessage> p_Message = std::make_shared<NetMessage>(NetMessage::MSG_DATA_AVAILABLE);
-        c_Recieved.Add(p_Message);
+        // Sent to the client, not handled by the server
+        c_Send.Add(NetResponse::Get(NetResponse::RESPONSE_DATA_AVAILABLE));
     }
     catch (std::exception& e)
     {
@@ -323,109 +705,583 @@ void Client::RecieveDataAvailable() noexcept
 }
 
 //*************************************************************************************
-// Send
+// Delivery
 //*************************************************************************************
 
-void Client::Send()
+void Client::UpdateDelivery(MessageStore& c_MessageStore) noexcept
 {
-    while (true)
+    std::vector<SendTracker::Result> v_Result;
+    std::vector<uint64_t> v_Expired;
+    
+    try
+    {
+        c_Tracker.Update(std::chrono::steady_clock::now(), v_Result, v_Expired);
+    }
+    catch (...)
+    {
+        return;
+    }
+    
+    for (auto& Result : v_Result)
     {
-        // Grab send message
-        std::shared_ptr<NetMessage> p_Send = c_Send.GetElement();
+        SendTracker::Send& c_Send = Result.c_Send;
         
-        if (p_Send == NULL)
+        // Delivered custom net messages are no longer referenced
+        if (Result.b_Delivered == true && c_Send.u64_SpoolID != 0)
         {
-            // Nothing left to send for this update
-            return;
+            c_ClientPool.GetCustomSpool().Remove(c_Send.u64_SpoolID);
         }
         
-#if CLIENT_EXTENDED_LOGGING > 0
-        Logger::Singleton().Log(Logger::INFO, "(Client ID: " +
-                                              std::to_string(us_ClientID) +
-                                              ", Client (User ID " +
-                                              std::to_string(c_UserInfo.u32_UserID) +
-                                              ", Device Key: " +
-                                              c_UserInfo.s_DeviceKey +
-                                              ", Client Type: " +
-                                              std::to_string(c_UserInfo.u8_ClientType) +
-                                              "): Sending NetMessage " +
-                                              std::to_string(p_Send->GetID()) +
-                                              " (Size: " +
-                                              std::to_string(p_Send->v_Data.size()) +
-                                              ").",
-                                "Client.cpp", __LINE__);
-#endif
-        
-        // Find free stream data first
-        StreamSendContext* p_Context = NULL;
-        
-        for (auto Context = l_StreamContext.begin(); Context != l_StreamContext.end(); ++Context)
+        if (c_Send.u64_MessageID != 0)
         {
-            // Select empty message available
-            if (Context->c_Data.e_State == StreamData::FREE || Context->c_Data.e_State == StreamData::COMPLETED)
+            // Stored messages stay claimed if canceled
+            if (Result.b_Delivered == true)
             {
-                Context->c_Data.e_State = StreamData::IN_USE;
-                p_Context = &(*(Context));
-                break;
+                ClientCommunication::AcknowledgeMessage(c_MessageStore,
+                                                        c_UserInfo,
+                                                        c_Send.u64_MessageID);
             }
         }
-        
-        // No data, add new
-        if (p_Context == NULL)
+        else if (Result.b_Delivered == false)
         {
-            l_StreamContext.emplace_back(p_APITable);
-            p_Context = &(*(--(l_StreamContext.end())));
+            ClientCommunication::StoreUndelivered(c_Send.v_Data,
+                                                  c_MessageStore,
+                                                  c_UserInfo);
+            RecieveDataAvailable();
         }
+    }
+    
+    // Unfinished sends after the timeout are aborted, the
+    // canceled completion stores them
+    for (auto& SendID : v_Expired)
+    {
+        AbortSend(SendID);
+    }
+}
+
+void Client::AbortSend(uint64_t u64_SendID) noexcept
+{
+    for (auto& Context : l_StreamContext)
+    {
+        if (Context.Abort(u64_SendID) == true)
+        {
+            return;
+        }
+    }
+}
+
+void Client::StoreDirect(MessageStore& c_MessageStore) noexcept
+{
+    std::deque<NetMessage> dq_Unsent;
+    std::vector<SendTracker::Send> v_Unfinished;
+    
+    c_Direct.Take(dq_Unsent);
+    
+    for (auto& Unsent : dq_Unsent)
+    {
+        ClientCommunication::StoreUndelivered(Unsent.v_Data,
+                                              c_MessageStore,
+                                              c_UserInfo);
+    }
+    
+    try
+    {
+        c_Tracker.Clear(v_Unfinished);
+    }
+    catch (...)
+    {
+        return;
+    }
+    
+    for (auto& Unfinished : v_Unfinished)
+    {
+        if (Unfinished.u64_MessageID == 0)
+        {
+            ClientCommunication::StoreUndelivered(Unfinished.v_Data,
+                                                  c_MessageStore,
+                                                  c_UserInfo);
+        }
+    }
+}
+
+//*************************************************************************************
+// Forward
+//*************************************************************************************
+
+void Client::ForwardMessage(NetMessage const& c_NetMessage, MessageStore& c_MessageStore)
+{
+    // Recipients read the inbox keyed by the sender
+    InboxKey c_Key(c_UserInfo.u32_UserID,
+                   c_UserInfo.s_DeviceKey,
+                   c_UserInfo.u8_ClientType);
+    
+    // Online recipients get the message directly
+    if (c_ClientPool.DeliverMessage(c_Key, c_NetMessage) == true)
+    {
+        return;
+    }
+    
+    if (ClientCommunication::StoreMessage(c_NetMessage,
+                                          c_MessageStore,
+                                          c_UserInfo) == true)
+    {
+        c_ClientPool.DataAvailable(c_Key);
+    }
+}
+
+void Client::ForwardNotification(MessageStore& c_MessageStore) noexcept
+{
+    std::vector<uint8_t> v_Notification;
+    
+    // Disconnected clients forward without waiting for the window
+    if ((p_Connection == NULL ? c_Notification.Take(v_Notification) : c_Notification.Take(std::chrono::steady_clock::now(), v_Notification)) == false)
+    {
+        return;
+    }
+    
+    try
+    {
+        NetMessage c_Forward(std::move(v_Notification));
+        ForwardMessage(c_Forward, c_MessageStore);
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "(Client ID: " +
+                                               std::to_string(us_ClientID) +
+                                               ", User ID " +
+                                               std::to_string(c_UserInfo.u32_UserID) +
+                                               ", Device Key: " +
+                                               c_UserInfo.s_DeviceKey +
+                                               ", Client Type: " +
+                                               std::to_string(c_UserInfo.u8_ClientType) +
+                                               " ): Failed to forward notification: " +
+                                               e.what(),
+                                "Client.cpp", __LINE__);
+    }
+}
+
+//*************************************************************************************
+// Send
+//*************************************************************************************
+
+void Client::Send()
+{
+    auto c_Expire = std::chrono::steady_clock::now() + std::chrono::seconds(CLIENT_DIRECT_TIMEOUT_S);
+    
+    // Stored messages first, they were requested first
+    while (dq_SendStored.size() > 0)
+    {
+        uint64_t u64_SendID = u64_NextSendID++;
+        SendTracker::Send& c_Tracked = c_Tracker.Add(u64_SendID);
         
-        // Add the send data
-        p_Context->c_Data.v_Bytes.swap(p_Send->v_Data);
-        
-        // Now we perform the quic buffer setup
-        p_Context->c_Data.v_Bytes.insert(p_Context->c_Data.v_Bytes.begin(),
-                                         sizeof(QUIC_BUFFER),
-                                         0);
+        c_Tracked.u64_MessageID = dq_SendStored.front().first;
+        c_Tracked.u64_SpoolID = CustomSpool::ToSpoolID(dq_SendStored.front().second.v_Data);
+        c_Tracked.c_Expire = c_Expire;
+        
+        try
+        {
+            SendNetMessage(dq_SendStored.front().second, u64_SendID);
+        }
+        catch (...)
+        {
+            c_Tracker.Remove(u64_SendID);
+            throw;
+        }
         
-        QUIC_BUFFER* p_QuicBuffer;
+        dq_SendStored.pop_front();
+    }
+    
+    // Direct messages are kept until delivered
+    std::deque<NetMessage> dq_Send;
+    
+    c_Direct.Take(dq_Send);
+    
+    while (dq_Send.size() > 0)
+    {
+        uint64_t u64_SendID = u64_NextSendID++;
+        SendTracker::Send& c_Tracked = c_Tracker.Add(u64_SendID);
         
-        p_QuicBuffer = (QUIC_BUFFER*)&(p_Context->c_Data.v_Bytes[0]);
-        p_QuicBuffer->Buffer = &(p_Context->c_Data.v_Bytes[sizeof(QUIC_BUFFER)]);
-        p_QuicBuffer->Length = p_Context->c_Data.v_Bytes.size() - sizeof(QUIC_BUFFER);
+        c_Tracked.v_Data = dq_Send.front().v_Data;
+        c_Tracked.u64_SpoolID = CustomSpool::ToSpoolID(c_Tracked.v_Data);
+        c_Tracked.c_Expire = c_Expire;
         
-        // Buffer is setup, send data
-        HQUIC p_Stream;
+        // Stored as recieved if not delivered
+        Encode(dq_Send.front());
         
-        if (QUIC_FAILED(p_APITable->StreamOpen(p_Connection,
-                                               QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL, /* QUIC_STREAM_OPEN_FLAG_NONE, */
-                                               StreamSendCallback,
-                                               p_Context,
-                                               &p_Stream)))
+        try
         {
-            c_Send.Add(p_Send); // Return to send
-            p_Context->c_Data.e_State = StreamData::FREE;
+            SendNetMessage(dq_Send.front(), u64_SendID);
+        }
+        catch (...)
+        {
+            c_Tracker.Remove(u64_SendID);
             
-            throw Exception("Failed to open stream!");
+            // Return unsent in order
+            c_Direct.Return(dq_Send);
+            throw;
         }
-        else if (QUIC_FAILED(p_APITable->StreamStart(p_Stream,
-                                                     QUIC_STREAM_START_FLAG_SHUTDOWN_ON_FAIL)))
+        
+        dq_Send.pop_front();
+        
+        // Answers a parked data request
+        b_Parked = false;
+    }
+    
+    // Grab send messages
+    std::deque<IntrusivePointer<NetMessage>> dq_Pending;
+    IntrusivePointer<NetMessage> p_Send;
+    
+    while ((p_Send = c_Send.GetElement()) != NULL)
+    {
+        // Clients without push request data on their own
+        if (p_Send->GetID() == NetMessage::MSG_DATA_AVAILABLE && (c_UserInfo.u32_Capability & NetMessage::CAP_PUSH) == 0)
         {
-            c_Send.Add(p_Send);
-            p_APITable->StreamClose(p_Stream);
+            continue;
+        }
+        
+        dq_Pending.emplace_back(std::move(p_Send));
+    }
+    
+    // @NOTE: Frames and spooled custom net messages are sent alone.
+    auto Frameable = [](NetMessage const& c_NetMessage)
+    {
+        return c_NetMessage.v_Data[NetMessage::us_IDPos] != NetMessageV2::u8_FrameID &&
+               CustomSpool::ToSpoolID(c_NetMessage.v_Data) == 0 &&
+               CustomSpool::ToSpoolID(c_NetMessage.v_Data, NetMessage::us_DataPos + us_SizeMessageID) == 0;
+    };
+    
+    while (dq_Pending.size() > 0)
+    {
+        // Batching sends the pending messages in frames
+        if ((c_UserInfo.u32_Capability & NetMessage::CAP_BATCHING) != 0 && Frameable(*(dq_Pending.front())) == true)
+        {
+            std::vector<uint8_t> v_Frame;
+            
+            for (size_t i = 0; i < NetMessageV2::us_FrameCountMax && dq_Pending.size() > 0 && Frameable(*(dq_Pending.front())) == true; ++i)
+            {
+                NetMessageV2::AddToFrame(v_Frame, dq_Pending.front()->v_Data);
+                dq_Pending.pop_front();
+            }
+            
+            p_Send = MakeIntrusive<NetMessage>(std::move(v_Frame));
+        }
+        else
+        {
+            p_Send = std::move(dq_Pending.front());
+            dq_Pending.pop_front();
+        }
+        
+        try
+        {
+            SendNetMessage(*p_Send, 0);
+        }
+        catch (...)
+        {
+            // Return to send
+            c_Send.Add(std::move(p_Send));
+            
+            for (auto& Pending : dq_Pending)
+            {
+                c_Send.Add(std::move(Pending));
+            }
+            
+            throw;
+        }
+    }
+}
+
+void Client::SendNetMessage(NetMessage& c_NetMessage, uint64_t u64_SendID)
+{
+#if CLIENT_EXTENDED_LOGGING > 0
+    Logger::Singleton().Log(Logger::INFO, "(Client ID: " +
+                                          std::to_string(us_ClientID) +
+                                          ", Client (User ID " +
+                                          std::to_string(c_UserInfo.u32_UserID) +
+                                          ", Device Key: " +
+                                          c_UserInfo.s_DeviceKey +
+                                          ", Client Type: " +
+                                          std::to_string(c_UserInfo.u8_ClientType) +
+                                          "): Sending NetMessage " +
+                                          std::to_string(c_NetMessage.GetID()) +
+                                          " (Size: " +
+                                          std::to_string(c_NetMessage.v_Data.size()) +
+                                          ").",
+                            "Client.cpp", __LINE__);
+#endif
+    
+    // Find free stream data first
+    StreamSendContext* p_Context = NULL;
+    
+    for (auto Context = l_StreamContext.begin(); Context != l_StreamContext.end(); ++Context)
+    {
+        // Select empty message available
+        if (Context->c_Data.e_State == StreamData::FREE || Context->c_Data.e_State == StreamData::COMPLETED)
+        {
+            Context->c_Data.e_State = StreamData::IN_USE;
+            p_Context = &(*(Context));
+            break;
+        }
+    }
+    
+    // No data, add new
+    if (p_Context == NULL)
+    {
+        l_StreamContext.emplace_back(p_APITable,
+                                     c_ClientPool,
+                                     us_ClientID);
+        p_Context = &(*(--(l_StreamContext.end())));
+    }
+    
+    // Add the send data
+    p_Context->u64_SendID = u64_SendID;
+    p_Context->u64_SpoolRemaining = 0;
+    
+    const QUIC_BUFFER* p_QuicBuffer;
+    bool b_Swapped = false;
+    size_t us_SpoolPos = (c_NetMessage.GetID() == NetMessage::MSG_DATA_ID ? NetMessage::us_DataPos + us_SizeMessageID : 0);
+    uint64_t u64_SpoolID = CustomSpool::ToSpoolID(c_NetMessage.v_Data, us_SpoolPos);
+    
+    if (u64_SpoolID != 0)
+    {
+        // Custom net messages are sent in chunks read from disk, the
+        // reference stays with the net message
+        // @NOTE: The message id header is sent in front of the file.
+        try
+        {
+            p_Context->c_Data.v_Bytes.assign(sizeof(QUIC_BUFFER), 0);
+            p_Context->c_Data.v_Bytes.insert(p_Context->c_Data.v_Bytes.end(),
+                                             c_NetMessage.v_Data.begin(),
+                                             c_NetMessage.v_Data.begin() + us_SpoolPos);
+            
+            p_Context->i_SpoolFD = c_ClientPool.GetCustomSpool().Open(u64_SpoolID,
+                                                                      p_Context->u64_SpoolRemaining);
+            p_QuicBuffer = p_Context->ReadSpooled(us_SpoolPos);
+        }
+        catch (std::exception& e)
+        {
+            CustomSpool::Close(p_Context->i_SpoolFD);
+            p_Context->i_SpoolFD = -1;
             p_Context->c_Data.e_State = StreamData::FREE;
             
-            throw Exception("Failed to start stream!");
+            Logger::Singleton().Log(Logger::ERROR, "(Client ID: " +
+                                                   std::to_string(us_ClientID) +
+                                                   ", User ID " +
+                                                   std::to_string(c_UserInfo.u32_UserID) +
+                                                   ", Device Key: " +
+                                                   c_UserInfo.s_DeviceKey +
+                                                   ", Client Type: " +
+                                                   std::to_string(c_UserInfo.u8_ClientType) +
+                                                   " ): Failed to read custom net message: " +
+                                                   e.what(),
+                                    "Client.cpp", __LINE__);
+            
+            // @NOTE: The spool file can never be sent, finish as delivered
+            //        to drop the reference instead of retrying forever.
+            RecieveDataSent(u64_SendID, true);
+            return;
+        }
+    }
+    else if (NetResponse::IsResponse(c_NetMessage) == true)
+    {
+        // Preallocated responses are kept until exit and sent
+        // with their prebuilt buffer without copying
+        p_QuicBuffer = NetResponse::GetBuffer(c_NetMessage);
+    }
+    else if (c_NetMessage.v_Data.size() <= STREAM_SEND_BUFFER_SIZE)
+    {
+        // Small net messages are copied to the kept context buffer
+        p_QuicBuffer = p_Context->CopyBuffer(c_NetMessage.v_Data);
+    }
+    else
+    {
+        p_Context->c_Data.v_Bytes.swap(c_NetMessage.v_Data);
+        b_Swapped = true;
+        
+        // Now we perform the quic buffer setup
+        p_Context->c_Data.v_Bytes.insert(p_Context->c_Data.v_Bytes.begin(),
+                                         sizeof(QUIC_BUFFER),
+                                         0);
+        
+        QUIC_BUFFER* p_Swapped = (QUIC_BUFFER*)&(p_Context->c_Data.v_Bytes[0]);
+        p_Swapped->Buffer = &(p_Context->c_Data.v_Bytes[sizeof(QUIC_BUFFER)]);
+        p_Swapped->Length = p_Context->c_Data.v_Bytes.size() - sizeof(QUIC_BUFFER);
+        
+        p_QuicBuffer = p_Swapped;
+    }
+    
+    // Buffer is setup, send data
+    HQUIC p_Stream;
+    const char* p_Error = NULL;
+    
+    if (QUIC_FAILED(p_APITable->StreamOpen(p_Connection,
+                                           QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL, /* QUIC_STREAM_OPEN_FLAG_NONE, */
+                                           StreamSendCallback,
+                                           p_Context,
+                                           &p_Stream)))
+    {
+        p_Error = "Failed to open stream!";
+    }
+    else
+    {
+        // Kept for aborting, no callback before the stream started
+        p_Context->SetStream(p_Stream);
+        
+        if (QUIC_FAILED(p_APITable->StreamStart(p_Stream,
+                                                QUIC_STREAM_START_FLAG_SHUTDOWN_ON_FAIL)))
+        {
+            p_Error = "Failed to start stream!";
         }
         else if (QUIC_FAILED(p_APITable->StreamSend(p_Stream,
                                                     p_QuicBuffer,
                                                     1,
-                                                    QUIC_SEND_FLAG_FIN,
+                                                    p_Context->u64_SpoolRemaining > 0 ? QUIC_SEND_FLAG_NONE : QUIC_SEND_FLAG_FIN,
                                                     NULL)))
         {
-            c_Send.Add(p_Send);
+            p_Error = "Failed to send on stream!";
+        }
+        
+        if (p_Error != NULL)
+        {
+            p_Context->ClearStream(p_Stream);
             p_APITable->StreamClose(p_Stream);
-            p_Context->c_Data.e_State = StreamData::FREE;
+        }
+    }
+    
+    if (p_Error != NULL)
+    {
+        // Return the data to the message for the next attempt
+        if (u64_SpoolID != 0)
+        {
+            CustomSpool::Close(p_Context->i_SpoolFD);
+            p_Context->i_SpoolFD = -1;
+        }
+        else if (b_Swapped == true)
+        {
+            p_Context->c_Data.v_Bytes.erase(p_Context->c_Data.v_Bytes.begin(),
+                                            p_Context->c_Data.v_Bytes.begin() + sizeof(QUIC_BUFFER));
+            c_NetMessage.v_Data.swap(p_Context->c_Data.v_Bytes);
+        }
+        
+        p_Context->c_Data.e_State = StreamData::FREE;
+        
+        throw Exception(p_Error);
+    }
+}
+
+void Client::SendStored(NetMessage& c_NetMessage, uint64_t u64_MessageID, bool b_WithID)
+{
+    Encode(c_NetMessage);
+    
+    if (b_WithID == false)
+    {
+        dq_SendStored.emplace_back(u64_MessageID, std::move(c_NetMessage));
+        return;
+    }
+    
+    // Claims ended without acknowledgement are redelivered by the store
+    auto c_Time = std::chrono::steady_clock::now();
+    
+    for (auto It = m_Claim.begin(); It != m_Claim.end();)
+    {
+        if (It->second.c_Expire <= c_Time)
+        {
+            It = m_Claim.erase(It);
+        }
+        else
+        {
+            ++It;
+        }
+    }
+    
+    Claim& c_Claim = m_Claim[u64_MessageID];
+    c_Claim.u64_SpoolID = CustomSpool::ToSpoolID(c_NetMessage.v_Data);
+    c_Claim.c_Expire = c_Time + std::chrono::seconds(MESSAGE_STORE_CLAIM_TIMEOUT_S);
+    
+    // Kept claimed until the client acknowledges the message id
+    MSG_DATA_ID_DATA c_Data;
+    c_Data.u64_MessageID = u64_MessageID;
+    c_Data.v_Message.swap(c_NetMessage.v_Data);
+    
+    c_Send.Add(MakeIntrusive<NetMessage>(ToBuffer(c_Data)));
+}
+
+void Client::Encode(NetMessage& c_NetMessage) noexcept
+{
+    try
+    {
+        if ((c_UserInfo.u32_Capability & NetMessage::CAP_COMPRESSION) == 0 && c_NetMessage.GetID() == NetMessage::MSG_COMPRESSED)
+        {
+            std::vector<uint8_t> v_Message;
             
-            throw Exception("Failed to send on stream!");
+            if (NetCompression::Decompress(c_NetMessage.v_Data, v_Message) == false)
+            {
+                throw Exception("Invalid compressed data!");
+            }
+            
+            c_NetMessage.v_Data.swap(v_Message);
+        }
+        
+        if (c_UserInfo.u8_Version > 1)
+        {
+            NetMessageV2::Encode(c_NetMessage.v_Data);
         }
+        
+        return;
+    }
+    catch (...)
+    {
+        // Handled like invalid data
+    }
+    
+    // @NOTE: Invalid data is sent as is, the client drops the unknown
+    //        net message and a stored message is not redelivered forever.
+    Logger::Singleton().Log(Logger::WARNING, "(Client ID: " +
+                                             std::to_string(us_ClientID) +
+                                             ", User ID " +
+                                             std::to_string(c_UserInfo.u32_UserID) +
+                                             ", Device Key: " +
+                                             c_UserInfo.s_DeviceKey +
+                                             ", Client Type: " +
+                                             std::to_string(c_UserInfo.u8_ClientType) +
+                                             " ): Failed to encode net message!",
+                            "Client.cpp", __LINE__);
+}
+
+//*************************************************************************************
+// Acknowledge
+//*************************************************************************************
+
+void Client::AcknowledgeClaims(std::vector<std::pair<uint64_t, uint64_t>> const& v_Range, MessageStore& c_MessageStore)
+{
+    std::vector<uint64_t> v_MessageID;
+    std::vector<uint64_t> v_SpoolID;
+    
+    // Only messages sent to this client can be acknowledged
+    for (auto& Range : v_Range)
+    {
+        for (auto It = m_Claim.lower_bound(Range.first); It != m_Claim.end() && It->first <= Range.second;)
+        {
+            v_MessageID.emplace_back(It->first);
+            
+            if (It->second.u64_SpoolID != 0)
+            {
+                v_SpoolID.emplace_back(It->second.u64_SpoolID);
+            }
+            
+            It = m_Claim.erase(It);
+        }
+    }
+    
+    if (v_MessageID.size() == 0 || ClientCommunication::AcknowledgeMessages(c_MessageStore,
+                                                                            c_UserInfo,
+                                                                            v_MessageID) == false)
+    {
+        return;
+    }
+    
+    for (auto& SpoolID : v_SpoolID)
+    {
+        c_ClientPool.GetCustomSpool().Remove(SpoolID);
     }
 }
 
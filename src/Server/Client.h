@@ -21,6 +21,9 @@
 #include <mutex>
 #include <deque>
 #include <list>
+#include <unordered_map>
+#include <map>
+#include <chrono>
 #include <utility>
 
 // External
@@ -28,10 +31,18 @@
 // Project
 #include "./MsQuic/StreamSendContext.h"
 #include "./Client/UserInfo.h"
+#include "./DirectQueue.h"
+#include "./SendTracker.h"
+#include "./NotificationWindow.h"
+#include "../Database/MessageStore.h"
 #include "../NetMessage/NetMessage.h"
 #include "../Job/Job.h"
 #include "../SharedList.h"
 
+// Pre-defined
+class ClientPool;
+class Database;
+
 
 class Client : public Job
 {
@@ -44,12 +55,14 @@ public:
     /**
      *  Default constructor.
      *
+     *  \param c_ClientPool The client pool containing the client.
      *  \param p_APITable The api table to use for sending.
      *  \param p_Connection The connection for the client.
      *  \param us_ClientID The id for the client.
      */
     
-    Client(const QUIC_API_TABLE* p_APITable,
+    Client(ClientPool& c_ClientPool,
+           const QUIC_API_TABLE* p_APITable,
            HQUIC p_Connection,
            size_t us_ClientID) noexcept;
     
@@ -109,6 +122,25 @@ public:
     
     void RecieveDataAvailable() noexcept;
     
+    /**
+     *  Recieve a message sent directly by a online sender.
+     *
+     *  \param c_NetMessage The message to send to the client.
+     *
+     *  \return true if the message was accepted, false if not.
+     */
+    
+    bool RecieveDirectMessage(NetMessage const& c_NetMessage) noexcept;
+    
+    /**
+     *  Recieve a tracked send completion notification.
+     *
+     *  \param u64_SendID The id of the tracked send.
+     *  \param b_Delivered If the send was delivered or canceled.
+     */
+    
+    void RecieveDataSent(uint64_t u64_SendID, bool b_Delivered) noexcept;
+    
     //*************************************************************************************
     // Getters
     //*************************************************************************************
@@ -123,6 +155,36 @@ public:
     
 private:
     
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    struct Claim
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        uint64_t u64_SpoolID; // Custom net message removed once acknowledged, 0 if none
+        std::chrono::steady_clock::time_point c_Expire; // Redelivered by the store if passed
+    };
+    
+    struct Handler
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        void (Client::*p_Process)(NetMessage& c_NetMessage, Database* p_Database); // NULL if not accepted
+        bool b_Authenticated; // Requires an authenticated client
+        size_t us_SizeMin; // Full net message size range
+        size_t us_SizeMax;
+    };
+    
     //*************************************************************************************
     // Disconnect
     //*************************************************************************************
@@ -133,6 +195,160 @@ private:
     
     void Disconnect() noexcept;
     
+    //*************************************************************************************
+    // Process
+    //*************************************************************************************
+    
+    /**
+     *  Process a recieved version 1 net message with its handler.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database.
+     */
+    
+    void Process(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved auth request.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessAuthRequest(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved auth proof.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessAuthProof(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved data request, with or without message id.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessGetData(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process recieved message id acknowledgements.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessAck(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved communication message.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessMessage(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved fan-out message.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessFanOut(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved notification.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessNotification(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved spooled custom net message.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessCustom(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved compression codec request.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessCompression(NetMessage& c_NetMessage, Database* p_Database);
+    
+    /**
+     *  Process a recieved compressed communication message.
+     *
+     *  \param c_NetMessage The recieved net message.
+     *  \param p_Database The thread database, NULL for CPU only handlers.
+     */
+    
+    void ProcessCompressed(NetMessage& c_NetMessage, Database* p_Database);
+    
+    //*************************************************************************************
+    // Delivery
+    //*************************************************************************************
+    
+    /**
+     *  Update tracked sends with send results and timeouts.
+     *
+     *  \param c_MessageStore The message store for undelivered messages.
+     */
+    
+    void UpdateDelivery(MessageStore& c_MessageStore) noexcept;
+    
+    /**
+     *  Abort a tracked send which did not complete in time. The send completes
+     *  as canceled afterwards.
+     *
+     *  \param u64_SendID The id of the tracked send.
+     */
+    
+    void AbortSend(uint64_t u64_SendID) noexcept;
+    
+    /**
+     *  Store all direct messages which were not delivered.
+     *
+     *  \param c_MessageStore The message store for undelivered messages.
+     */
+    
+    void StoreDirect(MessageStore& c_MessageStore) noexcept;
+    
+    //*************************************************************************************
+    // Forward
+    //*************************************************************************************
+    
+    /**
+     *  Forward a communication message to the counterpart client type, directly
+     *  if online or stored if not.
+     *
+     *  \param c_NetMessage The communication message to forward.
+     *  \param c_MessageStore The message store for offline recipients.
+     */
+    
+    void ForwardMessage(NetMessage const& c_NetMessage, MessageStore& c_MessageStore);
+    
+    /**
+     *  Forward the coalesced notification.
+     *
+     *  \param c_MessageStore The message store for offline recipients.
+     */
+    
+    void ForwardNotification(MessageStore& c_MessageStore) noexcept;
+    
     //*************************************************************************************
     // Send
     //*************************************************************************************
@@ -143,17 +359,79 @@ private:
     
     void Send();
     
+    /**
+     *  Send a net message as stream data.
+     *
+     *  \param c_NetMessage The net message to send.
+     *  \param u64_SendID The id to track the send with, 0 if untracked.
+     */
+    
+    void SendNetMessage(NetMessage& c_NetMessage, uint64_t u64_SendID);
+    
+    /**
+     *  Add a retrieved stored message to send.
+     *
+     *  \param c_NetMessage The retrieved stored message. The message data will be swapped.
+     *  \param u64_MessageID The id of the claimed message.
+     *  \param b_WithID If the client acknowledges the message by id.
+     */
+    
+    void SendStored(NetMessage& c_NetMessage, uint64_t u64_MessageID, bool b_WithID);
+    
+    /**
+     *  Convert a net message to the version and compression selected by
+     *  the client.
+     *
+     *  \param c_NetMessage The net message to convert.
+     */
+    
+    void Encode(NetMessage& c_NetMessage) noexcept;
+    
+    //*************************************************************************************
+    // Acknowledge
+    //*************************************************************************************
+    
+    /**
+     *  Remove stored messages acknowledged by the client.
+     *
+     *  \param v_Range The acknowledged message id ranges.
+     *  \param c_MessageStore The message store of the messages.
+     */
+    
+    void AcknowledgeClaims(std::vector<std::pair<uint64_t, uint64_t>> const& v_Range, MessageStore& c_MessageStore);
+    
     //*************************************************************************************
     // Data
     //*************************************************************************************
     
+    // Process
+    static const Handler p_Handler[NetMessage::NET_MESSAGE_LIST_COUNT]; // Defined constexpr
+    
     // State
     size_t us_ClientID;
     std::mutex c_PerformMutex; // Stop multiple job threads
     
+    // Long Poll
+    std::atomic<bool> b_Parked; // Data request waits for messages
+    std::chrono::steady_clock::time_point c_ParkExpire; // Guarded by perform mutex
+    bool b_ParkedID; // Answered with message id, guarded by perform mutex
+    
+    // Acknowledge
+    std::map<uint64_t, Claim> m_Claim; // Sent with message id, guarded by perform mutex
+    
+    // Notification
+    NotificationWindow c_Notification; // Guarded by perform mutex
+    
     // Net Message
-    SharedList<NetMessage> c_Recieved;
-    SharedList<NetMessage> c_Send;
+    SharedList<NetMessage, IntrusivePointer<NetMessage>> c_Recieved;
+    SharedList<NetMessage, IntrusivePointer<NetMessage>> c_Send;
+    std::deque<std::pair<uint64_t, NetMessage>> dq_SendStored; // Guarded by perform mutex
+    
+    // Delivery
+    DirectQueue c_Direct;
+    SendTracker c_Tracker; // Completions are thread safe, guarded by perform mutex
+    uint64_t u64_NextSendID;
+    ClientPool& c_ClientPool;
     
     // MsQuic
     const QUIC_API_TABLE* p_APITable;
@@ -21,7 +21,6 @@
 
 // Project
 #include "./ClientAuthentication.h"
-#include "./Base64.h"
 #include "../../Logger.h"
 
 // Pre-defined
@@ -29,32 +28,75 @@
     #define CLIENT_EXTENDED_LOGGING 0
 #endif
 
-using namespace DatabaseTable;
-using namespace mysqlx;
+namespace
+{
+    // @NOTE: Datagrams are not supported, the server only uses streams
+    constexpr uint32_t u32_ServerCapability = NetMessage::CAP_BATCHING |
+                                              NetMessage::CAP_PUSH |
+                                              NetMessage::CAP_COMPRESSION |
+                                              NetMessage::CAP_FRAMED |
+                                              NetMessage::CAP_LONG_POLL;
+    
+    // Single messages only for version 1
+    constexpr uint32_t u32_FrameCapability = NetMessage::CAP_BATCHING |
+                                             NetMessage::CAP_FRAMED;
+}
 
 
 //*************************************************************************************
 // Auth Result
 //*************************************************************************************
 
-static inline NetMessage CreateAuthResult(uint8_t u8_Result) noexcept
+static inline NetMessage CreateAuthResult(uint8_t u8_Result, uint32_t u32_Capability = NetMessage::CAP_NONE) noexcept
 {
     MSG_AUTH_RESULT_DATA c_Result;
     c_Result.u8_Result = u8_Result;
+    c_Result.u32_Capability = u32_Capability;
     
     return NetMessage(ToBuffer<MSG_AUTH_RESULT_DATA>(c_Result));
 }
 
+static inline NetMessage CreateAuthResult(UserInfo const& c_UserInfo) noexcept
+{
+    // Clients without capabilities expect the short result
+    return CreateAuthResult(NetMessage::ERR_NONE, c_UserInfo.b_CapabilityResult == true ? c_UserInfo.u32_Capability : static_cast<uint32_t>(NetMessage::CAP_NONE));
+}
+
 //*************************************************************************************
 // Auth Request
 //*************************************************************************************
 
-NetMessage ClientAuthentication::HandleAuthRequest(MSG_AUTH_REQUEST_DATA c_Request, Database& c_Database, UserInfo& c_UserInfo) noexcept
+NetMessage ClientAuthentication::HandleAuthRequest(MSG_AUTH_REQUEST_DATA c_Request, AccountStore& c_AccountStore, AccountCache& c_AccountCache, UserInfo& c_UserInfo) noexcept
 {
     // Already authenticated? Skip db access etc to reduce load
     if (c_UserInfo.b_Authenticated == true)
     {
-        return CreateAuthResult(NetMessage::ERR_NONE);
+        return CreateAuthResult(c_UserInfo);
+    }
+    
+    // Following single messages use the requested version
+    if (c_Request.u8_Version < NetMessage::u8_NetMessageVersionMin || c_Request.u8_Version > NetMessage::u8_NetMessageVersion)
+    {
+        return CreateAuthResult(NetMessage::ERR_SA_VERSION);
+    }
+    
+    c_UserInfo.u8_Version = c_Request.u8_Version;
+    
+    // Pick the fast paths supported by both sides
+    if (c_Request.u32_Capability == NetMessage::CAP_NONE)
+    {
+        c_UserInfo.u32_Capability = NetMessage::CAP_DEFAULT;
+        c_UserInfo.b_CapabilityResult = false;
+    }
+    else
+    {
+        c_UserInfo.u32_Capability = c_Request.u32_Capability & u32_ServerCapability;
+        c_UserInfo.b_CapabilityResult = true;
+        
+        if (c_UserInfo.u8_Version < 2)
+        {
+            c_UserInfo.u32_Capability &= ~u32_FrameCapability;
+        }
     }
     
     // Remember client type
@@ -68,34 +110,18 @@ NetMessage ClientAuthentication::HandleAuthRequest(MSG_AUTH_REQUEST_DATA c_Reque
             return CreateAuthResult(NetMessage::ERR_SA_UNK_ACTOR);
     }
     
+    // @NOTE: We need to reset the password from this point onwards,
+    //        so that a following auth proof message fails!
+    c_UserInfo.s_Password = "";
+    
     // Define user login info
-    std::string s_Mail = std::string(c_Request.p_Mail,
-                                     c_Request.p_Mail + strnlen(c_Request.p_Mail, NetMessageV1::us_SizeAccountMail));
-    std::string s_Base64Password("");
+    std::string s_Mail = c_Request.c_Mail.ToString();
+    std::shared_ptr<const AccountCache::Account> p_Account;
     
-    // Get data from table user_account first
+    // Get the account first, cached with decoded password and devices
     try
     {
-        RowResult c_Result = c_Database.c_Session
-                                     .getSchema(c_Database.s_Database)
-                                     .getTable(p_UATableName)
-                                     .select(p_UAFieldName[UA_USER_ID],         /* 0 */
-                                             p_UAFieldName[UA_MAIL_ADDRESS],    /* 1 */
-                                             p_UAFieldName[UA_PASSWORD])        /* 2 */
-                                     .where(std::string(p_UAFieldName[UA_MAIL_ADDRESS]) +
-                                            " == :value")
-                                     .bind("value",
-                                           s_Mail)
-                                     .execute();
-        
-        if (c_Result.count() == 1) // Unique account rows
-        {
-            Row c_Row = c_Result.fetchOne();
-            
-            c_UserInfo.u32_UserID = c_Row[0].get<uint32_t>();
-            s_Base64Password = c_Row[2].get<std::string>();
-        }
-        else
+        if ((p_Account = c_AccountCache.GetAccount(c_AccountStore, s_Mail)) == NULL)
         {
             return CreateAuthResult(NetMessage::ERR_SA_ACCOUNT);
         }
@@ -105,66 +131,25 @@ NetMessage ClientAuthentication::HandleAuthRequest(MSG_AUTH_REQUEST_DATA c_Reque
         return CreateAuthResult(NetMessage::ERR_SG_ERROR);
     }
     
-    // Check what we recieved and grab important auth info
-    std::string s_Salt = Base64::ToBytesPart(s_Base64Password,
-                                             0,
-                                             crypto_pwhash_SALTBYTES);
-    c_UserInfo.s_Password = Base64::ToBytesPart(s_Base64Password,
-                                                crypto_pwhash_SALTBYTES,
-                                                crypto_box_SEEDBYTES);
-    
-    if (s_Salt.size() == 0 || c_UserInfo.s_Password.size() == 0)
-    {
-        // @NOTE: We need to reset the password from this point onwards,
-        //        so that a following auth proof message fails!
-        c_UserInfo.s_Password = "";
-        return CreateAuthResult(NetMessage::ERR_SA_ACCOUNT);
-    }
+    c_UserInfo.u32_UserID = p_Account->u32_UserID;
     
-    // Now grab user device list from table user_device_list and search device key
-    c_UserInfo.s_DeviceKey = std::string(c_Request.p_DeviceKey,
-                                         c_Request.p_DeviceKey + strnlen(c_Request.p_DeviceKey, NetMessageV1::us_SizeDeviceKey));
+    // Now check if the device is known for the user
+    c_UserInfo.s_DeviceKey = c_Request.c_DeviceKey.ToString();
     
-    try
-    {
-        RowResult c_Result = c_Database.c_Session
-                                     .getSchema(c_Database.s_Database)
-                                     .getTable(p_UDLTableName)
-                                     .select(p_UDLFieldName[UDL_USER_ID],       /* 0 */
-                                             p_UDLFieldName[UDL_DEVICE_KEY])    /* 1 */
-                                     .where(std::string(p_UDLFieldName[UDL_USER_ID]) +
-                                            " == :value")
-                                     .bind("value",
-                                           c_UserInfo.u32_UserID)
-                                     .execute();
-        
-        size_t us_Count = c_Result.count();
-        for (; us_Count > 0; --us_Count)
-        {
-            if (c_Result.fetchOne()[1].get<std::string>().compare(c_UserInfo.s_DeviceKey) == 0)
-            {
-                break;
-            }
-        }
-        
-        // Not found, send error
-        if (us_Count == 0)
-        {
-            c_UserInfo.s_Password = "";
-            return CreateAuthResult(NetMessage::ERR_SA_NO_DEVICE);
-        }
-    }
-    catch (std::exception& e)
+    if (p_Account->us_DeviceKey.count(c_UserInfo.s_DeviceKey) == 0)
     {
-        c_UserInfo.s_Password = "";
-        return CreateAuthResult(NetMessage::ERR_SG_ERROR);
+        return CreateAuthResult(NetMessage::ERR_SA_NO_DEVICE);
     }
     
+    c_UserInfo.s_Password = p_Account->s_Key;
+    c_UserInfo.v_DeviceKey.assign(p_Account->us_DeviceKey.begin(),
+                                  p_Account->us_DeviceKey.end());
+    
     // Got everything, build challenge
     MSG_AUTH_CHALLENGE_DATA c_Result;
     
     memset(c_Result.p_Salt, '\0', us_SizeAccountPasswordSalt);
-    memcpy(c_Result.p_Salt, s_Salt.data(), s_Salt.size());
+    memcpy(c_Result.p_Salt, p_Account->s_Salt.data(), p_Account->s_Salt.size());
     
     randombytes_buf(&(c_Result.u32_Nonce), sizeof(c_Result.u32_Nonce));
     c_UserInfo.u32_Nonce = c_Result.u32_Nonce;
@@ -179,14 +164,12 @@ NetMessage ClientAuthentication::HandleAuthRequest(MSG_AUTH_REQUEST_DATA c_Reque
 // Auth Proof
 //*************************************************************************************
 
-NetMessage ClientAuthentication::HandleAuthProof(MSG_AUTH_PROOF_DATA c_Proof, Database& c_Database, UserInfo& c_UserInfo) noexcept
+NetMessage ClientAuthentication::HandleAuthProof(MSG_AUTH_PROOF_DATA c_Proof, UserInfo& c_UserInfo) noexcept
 {
-    NetMessage c_Result = CreateAuthResult(NetMessage::ERR_NONE);
-    
     // Already authenticated? Skip account checking to reduce load
     if (c_UserInfo.b_Authenticated == true)
     {
-        return c_Result;
+        return CreateAuthResult(c_UserInfo);
     }
     
     // We have a valid password?
@@ -194,21 +177,19 @@ NetMessage ClientAuthentication::HandleAuthProof(MSG_AUTH_PROOF_DATA c_Proof, Da
     //        point! The size call always returns 0.
     if (c_UserInfo.s_Password.size() != crypto_box_SEEDBYTES)
     {
-        c_Result.v_Data[0] = NetMessage::ERR_SA_ACCOUNT;
-        return c_Result;
+        return CreateAuthResult(NetMessage::ERR_SA_ACCOUNT);
     }
     
     // Now get the nonce
     uint32_t u32_Nonce;
     
     if (crypto_secretbox_open_easy((unsigned char*)&u32_Nonce,
-                                   (const unsigned char*)&(c_Proof.p_NonceHash[crypto_secretbox_NONCEBYTES]),
+                                   (const unsigned char*)(c_Proof.c_NonceHash.GetData() + crypto_secretbox_NONCEBYTES),
                                    crypto_secretbox_MACBYTES + sizeof(uint32_t),
-                                   (const unsigned char*)(c_Proof.p_NonceHash),
+                                   (const unsigned char*)(c_Proof.c_NonceHash.GetData()),
                                    (const unsigned char*)(c_UserInfo.s_Password.data())) != 0)
     {
-        c_Result.v_Data[0] = NetMessage::ERR_SA_ACCOUNT;
-        return c_Result;
+        return CreateAuthResult(NetMessage::ERR_SA_ACCOUNT);
     }
     
     // We are now authenticated
@@ -224,5 +205,5 @@ NetMessage ClientAuthentication::HandleAuthProof(MSG_AUTH_PROOF_DATA c_Proof, Da
 #endif
     
     c_UserInfo.b_Authenticated = true;
-    return c_Result;
+    return CreateAuthResult(c_UserInfo);
 }
@@ -24,7 +24,7 @@
 // Project
 #include "./UserInfo.h"
 #include "../../NetMessage/Ver/NetMessageV1.h"
-#include "../../Database/Database.h"
+#include "../../Database/AccountCache.h"
 #include "../../Exception.h"
 
 using namespace NetMessageV1;
@@ -40,13 +40,14 @@ namespace ClientAuthentication
      *  Handle a client authentication request.
      *
      *  \param c_Request The recieved request.
-     *  \param c_Database The database to use.
+     *  \param c_AccountStore The account store to use.
+     *  \param c_AccountCache The account cache to use.
      *  \param c_UserInfo The user info to write.
      *
      *  \return The result net message to send.
      */
     
-    NetMessage HandleAuthRequest(MSG_AUTH_REQUEST_DATA c_Request, Database& c_Database, UserInfo& c_UserInfo) noexcept;
+    NetMessage HandleAuthRequest(MSG_AUTH_REQUEST_DATA c_Request, AccountStore& c_AccountStore, AccountCache& c_AccountCache, UserInfo& c_UserInfo) noexcept;
     
     //*************************************************************************************
     // Auth Proof
@@ -56,13 +57,12 @@ namespace ClientAuthentication
      *  Handle a client authentication proof.
      *
      *  \param c_Proof The recieved proof.
-     *  \param c_Database The database to use.
      *  \param c_UserInfo The user info to write.
      *
      *  \return The result net message to send.
      */
     
-    NetMessage HandleAuthProof(MSG_AUTH_PROOF_DATA c_Proof, Database& c_Database, UserInfo& c_UserInfo) noexcept;
+    NetMessage HandleAuthProof(MSG_AUTH_PROOF_DATA c_Proof, UserInfo& c_UserInfo) noexcept;
 }
 
 #endif /* ClientAuthentication_h */
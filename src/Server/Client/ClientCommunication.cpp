@@ -20,115 +20,129 @@
 
 // Project
 #include "./ClientCommunication.h"
-#include "./Base64.h"
 #include "../../Logger.h"
 
-// Pre-defined
-using namespace DatabaseTable;
-using namespace mysqlx;
-
-
 
 //*************************************************************************************
-// Retrieve
+// Sender
 //*************************************************************************************
 
-NetMessage ClientCommunication::RetrieveMessage( Database& c_Database, UserInfo const& c_UserInfo) noexcept
+bool ClientCommunication::GetSenderType(UserInfo const& c_UserInfo, uint8_t& u8_SenderType) noexcept
 {
-    Logger& c_Logger = Logger::Singleton();
-    
     // Get the sender based on the reciever
-    uint8_t u8_SenderType;
-    
     switch (c_UserInfo.u8_ClientType)
     {
         case CLIENT_APP:
             u8_SenderType = CLIENT_PLATFORM;
-            break;
+            return true;
         case CLIENT_PLATFORM:
             u8_SenderType = CLIENT_APP;
-            break;
+            return true;
             
         default:
-            c_Logger.Log(Logger::ERROR, "Unknown client type to retrieve for!",
-                         "ClientCommunication.cpp", __LINE__);
-            
-            return NetMessage(NetMessage::MSG_NO_DATA);
+            Logger::Singleton().Log(Logger::ERROR, "Unknown client type to retrieve for!",
+                                    "ClientCommunication.cpp", __LINE__);
+            return false;
+    }
+}
+
+//*************************************************************************************
+// Retrieve
+//*************************************************************************************
+
+bool ClientCommunication::RetrieveMessage(MessageStore& c_MessageStore, UserInfo const& c_UserInfo, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID) noexcept
+{
+    uint8_t u8_SenderType;
+    
+    u64_MessageID = 0;
+    
+    if (GetSenderType(c_UserInfo, u8_SenderType) == false)
+    {
+        return false;
     }
     
     // Got all required, read
+    // @NOTE: No data is answered with the shared response,
+    //        nothing is allocated for empty polls.
     try
     {
-        Table c_Table = c_Database.c_Session
-                            .getSchema(c_Database.s_Database)
-                            .getTable(p_MDTableName);
+        uint64_t u64_ID;
         
-        RowResult c_Result = c_Table
-                                .select(p_MDFieldName[MD_MESSAGE_ID],      /* 0 */
-                                        p_MDFieldName[MD_USER_ID],         /* 1 */
-                                        p_MDFieldName[MD_DEVICE_KEY],      /* 2 */
-                                        p_MDFieldName[MD_ACTOR_TYPE],      /* 3 */
-                                        p_MDFieldName[MD_MESSAGE_TYPE],    /* 4 */
-                                        p_MDFieldName[MD_MESSAGE_DATA])    /* 5 */
-                                .where(std::string(p_MDFieldName[MD_USER_ID]) +
-                                       " == :valueA AND " +
-                                       p_MDFieldName[MD_DEVICE_KEY] +
-                                       " == :valueB AND " +
-                                       p_MDFieldName[MD_ACTOR_TYPE] +
-                                       " == :valueC")
-                                .limit(1)
-                                .bind("valueA",
-                                      c_UserInfo.u32_UserID)
-                                .bind("valueB",
-                                      c_UserInfo.s_DeviceKey)
-                                .bind("valueC",
-                                      u8_SenderType)
-                                .execute();
-        
-        if (c_Result.count() > 0)
+        if (c_MessageStore.RetrieveMessage(c_UserInfo.u32_UserID,
+                                           c_UserInfo.s_DeviceKey,
+                                           u8_SenderType,
+                                           v_Message,
+                                           u64_ID) == false ||
+            v_Message.size() < NetMessage::us_DataPos)
         {
-            // Decode base64
-            Row c_Row = c_Result.fetchOne();
-            
-            std::string s_Bin = Base64::ToBytes(c_Row[5].get<std::string>());
-            
-            if (s_Bin.size() == 0)
-            {
-                c_Logger.Log(Logger::WARNING, "Failed to decode message base64!",
-                             "ClientCommunication.cpp", __LINE__);
-                
-                return NetMessage(NetMessage::MSG_NO_DATA);
-            }
-            
-            // Create
-            NetMessage c_NetMessage(c_Row[4].get<uint32_t>());
-            std::move(s_Bin.begin(),
-                      s_Bin.end(),
-                      std::back_inserter(c_NetMessage.v_Data));
-            
-            // Remove message
-            c_Table.remove()
-                .where(std::string(p_MDFieldName[MD_MESSAGE_ID]) +
-                       " == :value")
-                .bind("value",
-                      c_Row[0].get<uint64_t>())
-                .execute();
-            
-            // Now send
-            return c_NetMessage;
-        }
-        else
-        {
-            return NetMessage(NetMessage::MSG_NO_DATA);
+            return false;
         }
+        
+        // Claimed, now kept until sent
+        u64_MessageID = u64_ID;
+        return true;
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "Message retrieval from store failed: " +
+                                               std::string(e.what()),
+                                "ClientCommunication.cpp", __LINE__);
+        
+        return false;
+    }
+}
+
+void ClientCommunication::AcknowledgeMessage(MessageStore& c_MessageStore, UserInfo const& c_UserInfo, uint64_t u64_MessageID) noexcept
+{
+    uint8_t u8_SenderType;
+    
+    if (GetSenderType(c_UserInfo, u8_SenderType) == false)
+    {
+        return;
+    }
+    
+    // @NOTE: A failed removal only causes a redelivery once the claim expired
+    try
+    {
+        c_MessageStore.AcknowledgeMessage(c_UserInfo.u32_UserID,
+                                          c_UserInfo.s_DeviceKey,
+                                          u8_SenderType,
+                                          u64_MessageID);
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "Message removal from store failed: " +
+                                               std::string(e.what()),
+                                "ClientCommunication.cpp", __LINE__);
+    }
+}
+
+bool ClientCommunication::AcknowledgeMessages(MessageStore& c_MessageStore, UserInfo const& c_UserInfo, std::vector<uint64_t> const& v_MessageID) noexcept
+{
+    uint8_t u8_SenderType;
+    
+    if (GetSenderType(c_UserInfo, u8_SenderType) == false)
+    {
+        return false;
+    }
+    
+    // @NOTE: Messages not removed are redelivered once the claim expired
+    try
+    {
+        c_MessageStore.AcknowledgeMessages(c_UserInfo.u32_UserID,
+                                           c_UserInfo.s_DeviceKey,
+                                           u8_SenderType,
+                                           v_MessageID);
+        
+        return true;
     }
     catch (std::exception& e)
     {
-        Logger::Singleton().Log(Logger::ERROR, "Message retrieval from database failed: " +
+        Logger::Singleton().Log(Logger::ERROR, "Message removal from store failed: " +
                                                std::string(e.what()),
                                 "ClientCommunication.cpp", __LINE__);
         
-        return NetMessage(NetMessage::MSG_NO_DATA);
+        return false;
     }
 }
 
@@ -136,49 +150,105 @@ NetMessage ClientCommunication::RetrieveMessage( Database& c_Database, UserInfo
 // Store
 //*************************************************************************************
 
-void ClientCommunication::StoreMessage(NetMessage const& c_NetMessage, Database& c_Database, UserInfo const& c_UserInfo) noexcept
+bool ClientCommunication::StoreMessage(NetMessage const& c_NetMessage, MessageStore& c_MessageStore, UserInfo const& c_UserInfo) noexcept
 {
     // Can insert?
     if (c_NetMessage.v_Data.size() <= NetMessage::us_DataPos)
     {
         Logger::Singleton().Log(Logger::WARNING, "Tried to store message without data!",
                                 "ClientCommunication.cpp", __LINE__);
-        return;
+        return false;
     }
     
-    // Convert message data to base64
-    std::string s_Base64 = Base64::ToString(&(c_NetMessage.v_Data[NetMessage::us_DataPos]),
-                                            c_NetMessage.v_Data.size() - NetMessage::us_DataPos);
+    // Message is valid, now store for user
+    try
+    {
+        c_MessageStore.StoreMessage(c_UserInfo.u32_UserID,
+                                    c_UserInfo.s_DeviceKey,
+                                    c_UserInfo.u8_ClientType,
+                                    c_NetMessage.v_Data);
+        
+        return true;
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "Message insertion in store failed: " +
+                                               std::string(e.what()),
+                                "ClientCommunication.cpp", __LINE__);
+        
+        return false;
+    }
+}
+
+bool ClientCommunication::StoreFanOutMessage(NetMessage const& c_NetMessage, MessageStore& c_MessageStore, UserInfo const& c_UserInfo) noexcept
+{
+    // Fan-out id followed by the full communication message
+    if (c_NetMessage.v_Data.size() <= NetMessage::us_DataPos + NetMessage::us_DataPos)
+    {
+        Logger::Singleton().Log(Logger::WARNING, "Tried to store fan-out message without data!",
+                                "ClientCommunication.cpp", __LINE__);
+        return false;
+    }
     
-    if (s_Base64.size() == 0 || s_Base64.size() > us_MDMessageDataSize)
+    switch (c_NetMessage.v_Data[NetMessage::us_DataPos])
+    {
+        case NetMessage::MSG_TEXT:
+        case NetMessage::MSG_LOCATION:
+            break;
+            
+        default:
+            Logger::Singleton().Log(Logger::WARNING, "Tried to store unsupported fan-out message!",
+                                    "ClientCommunication.cpp", __LINE__);
+            return false;
+    }
+    
+    try
+    {
+        std::vector<uint8_t> v_Message(c_NetMessage.v_Data.begin() + NetMessage::us_DataPos,
+                                       c_NetMessage.v_Data.end());
+        
+        c_MessageStore.StoreFanOutMessage(c_UserInfo.u32_UserID,
+                                          c_UserInfo.v_DeviceKey,
+                                          c_UserInfo.u8_ClientType,
+                                          v_Message);
+        
+        return true;
+    }
+    catch (std::exception& e)
     {
-        Logger::Singleton().Log(Logger::ERROR, "Failed to encode message as base64!",
+        Logger::Singleton().Log(Logger::ERROR, "Fan-out message insertion in store failed: " +
+                                               std::string(e.what()),
                                 "ClientCommunication.cpp", __LINE__);
-        return;
+        
+        return false;
+    }
+}
+
+bool ClientCommunication::StoreUndelivered(std::vector<uint8_t> const& v_Message, MessageStore& c_MessageStore, UserInfo const& c_UserInfo) noexcept
+{
+    uint8_t u8_SenderType;
+    
+    // Stored for the recipient, from the sender side
+    if (GetSenderType(c_UserInfo, u8_SenderType) == false)
+    {
+        return false;
     }
     
-    // Created data string, now store for user
     try
     {
-        c_Database.c_Session
-            .getSchema(c_Database.s_Database)
-            .getTable(p_MDTableName)
-            .insert(DatabaseTable::p_MDFieldName[DatabaseTable::MD_USER_ID],
-                    DatabaseTable::p_MDFieldName[DatabaseTable::MD_DEVICE_KEY],
-                    DatabaseTable::p_MDFieldName[DatabaseTable::MD_ACTOR_TYPE],
-                    DatabaseTable::p_MDFieldName[DatabaseTable::MD_MESSAGE_TYPE],
-                    DatabaseTable::p_MDFieldName[DatabaseTable::MD_MESSAGE_DATA])
-            .values(c_UserInfo.u32_UserID,
-                    c_UserInfo.s_DeviceKey,
-                    c_UserInfo.u8_ClientType,
-                    c_NetMessage.v_Data[0],
-                    s_Base64.c_str())
-            .execute();
+        c_MessageStore.StoreMessage(c_UserInfo.u32_UserID,
+                                    c_UserInfo.s_DeviceKey,
+                                    u8_SenderType,
+                                    v_Message);
+        
+        return true;
     }
     catch (std::exception& e)
     {
-        Logger::Singleton().Log(Logger::ERROR, "Message insertion in database failed: " +
+        Logger::Singleton().Log(Logger::ERROR, "Undelivered message insertion in store failed: " +
                                                std::string(e.what()),
                                 "ClientCommunication.cpp", __LINE__);
+        
+        return false;
     }
 }
@@ -25,12 +25,27 @@
 // Project
 #include "./UserInfo.h"
 #include "../../NetMessage/Ver/NetMessageV1.h"
-#include "../../Database/Database.h"
+#include "../../Database/MessageStore.h"
 #include "../../Exception.h"
 
 
 namespace ClientCommunication
 {
+    //*************************************************************************************
+    // Sender
+    //*************************************************************************************
+    
+    /**
+     *  Get the client type which sends messages to a user.
+     *
+     *  \param c_UserInfo The user info of the recipient.
+     *  \param u8_SenderType The sender client type to write.
+     *
+     *  \return true if the sender type is known, false if not.
+     */
+    
+    bool GetSenderType(UserInfo const& c_UserInfo, uint8_t& u8_SenderType) noexcept;
+    
     //*************************************************************************************
     // Retrieve
     //*************************************************************************************
@@ -38,13 +53,37 @@ namespace ClientCommunication
     /**
      *  Retrieve all sendable communication messages.
      *
-     *  \param c_Database The database to use.
+     *  \param c_MessageStore The message store to use.
+     *  \param c_UserInfo The user info to use.
+     *  \param v_Message The full net message buffer to write.
+     *  \param u64_MessageID The id of the claimed stored message to write, 0 if none.
+     *
+     *  \return true if a message was retrieved, false if no data is available.
+     */
+    
+    bool RetrieveMessage(MessageStore& c_MessageStore, UserInfo const& c_UserInfo, std::vector<uint8_t>& v_Message, uint64_t& u64_MessageID) noexcept;
+    
+    /**
+     *  Remove a retrieved communication message after it was sent.
+     *
+     *  \param c_MessageStore The message store to use.
+     *  \param c_UserInfo The user info to use.
+     *  \param u64_MessageID The id of the sent stored message.
+     */
+    
+    void AcknowledgeMessage(MessageStore& c_MessageStore, UserInfo const& c_UserInfo, uint64_t u64_MessageID) noexcept;
+    
+    /**
+     *  Remove retrieved communication messages acknowledged by the client.
+     *
+     *  \param c_MessageStore The message store to use.
      *  \param c_UserInfo The user info to use.
+     *  \param v_MessageID The ids of the acknowledged stored messages.
      *
-     *  \return The sendable communication net message.
+     *  \return true if removed, false if not.
      */
     
-    NetMessage RetrieveMessage(Database& c_Database, UserInfo const& c_UserInfo) noexcept;
+    bool AcknowledgeMessages(MessageStore& c_MessageStore, UserInfo const& c_UserInfo, std::vector<uint64_t> const& v_MessageID) noexcept;
     
     //*************************************************************************************
     // Store
@@ -54,11 +93,37 @@ namespace ClientCommunication
      *  Store a communication message.
      *
      *  \param c_NetMessage The communication message to store.
-     *  \param c_Database The database to use.
+     *  \param c_MessageStore The message store to use.
+     *  \param c_UserInfo The user info to write.
+     *
+     *  \return true if the message was stored, false if not.
+     */
+    
+    bool StoreMessage(NetMessage const& c_NetMessage, MessageStore& c_MessageStore, UserInfo const& c_UserInfo) noexcept;
+    
+    /**
+     *  Store a fan-out message once for all devices of the user.
+     *
+     *  \param c_NetMessage The fan-out message containing the communication message.
+     *  \param c_MessageStore The message store to use.
      *  \param c_UserInfo The user info to write.
+     *
+     *  \return true if the message was stored, false if not.
+     */
+    
+    bool StoreFanOutMessage(NetMessage const& c_NetMessage, MessageStore& c_MessageStore, UserInfo const& c_UserInfo) noexcept;
+    
+    /**
+     *  Store a communication message which could not be delivered directly.
+     *
+     *  \param v_Message The full net message buffer to store.
+     *  \param c_MessageStore The message store to use.
+     *  \param c_UserInfo The user info of the recipient.
+     *
+     *  \return true if the message was stored, false if not.
      */
     
-    void StoreMessage(NetMessage const& c_NetMessage, Database& c_Database, UserInfo const& c_UserInfo) noexcept;
+    bool StoreUndelivered(std::vector<uint8_t> const& v_Message, MessageStore& c_MessageStore, UserInfo const& c_UserInfo) noexcept;
 }
 
 #endif /* ClientCommunication_h */
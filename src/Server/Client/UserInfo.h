@@ -20,6 +20,7 @@
 // C / C++
 #include <cstdint>
 #include <string>
+#include <vector>
 
 // External
 
@@ -62,7 +63,10 @@ public:
                           u8_ClientType(0),
                           b_Authenticated(false),
                           s_Password(""),
-                          u32_Nonce(0)
+                          u32_Nonce(0),
+                          u8_Version(1),
+                          u32_Capability(0),
+                          b_CapabilityResult(false)
     {}
     
     //*************************************************************************************
@@ -72,10 +76,15 @@ public:
     uint32_t u32_UserID;
     std::string s_DeviceKey;
     uint8_t u8_ClientType;
+    std::vector<std::string> v_DeviceKey; // All user devices, from auth
     
     bool b_Authenticated;
     std::string s_Password;
     uint32_t u32_Nonce;
+    
+    uint8_t u8_Version; // Net message version of single messages, from auth
+    uint32_t u32_Capability; // Negotiated NetMessageCapability flags, from auth
+    bool b_CapabilityResult; // Capabilities are part of the auth result
 };
 
 
@@ -15,6 +15,7 @@
  */
 
 // C / C++
+#include <algorithm>
 
 // External
 
@@ -32,20 +33,34 @@
 // Constructor / Destructor
 //*************************************************************************************
 
-ClientPool::ClientPool(JobList& c_JobList) : c_JobList(c_JobList),
-                                             us_MemberCount(0)
+ClientPool::ClientPool(JobList& c_JobList,
+                       JobTimer& c_JobTimer,
+                       int i_LongPollS,
+                       int i_NotificationWindowMS,
+                       int i_CompressionSizeMin,
+                       CustomSpool& c_CustomSpool) : c_JobList(c_JobList),
+                                                     c_JobTimer(c_JobTimer),
+                                                     i_LongPollS(i_LongPollS),
+                                                     i_NotificationWindowMS(i_NotificationWindowMS),
+                                                     i_CompressionSizeMin(i_CompressionSizeMin),
+                                                     c_CustomSpool(c_CustomSpool),
+                                                     us_MemberCount(0)
 {}
 
 ClientPool::~ClientPool() noexcept
-{}
+{
+    c_JobTimer.RemoveSource(*this);
+}
 
-ClientPool::Member::Member(const QUIC_API_TABLE* p_APITable,
+ClientPool::Member::Member(ClientPool& c_ClientPool,
+                           const QUIC_API_TABLE* p_APITable,
                            HQUIC p_Connection,
                            size_t us_ID)
 {
-    p_Client = std::make_shared<Client>(p_APITable,
-                                        p_Connection,
-                                        us_ID);
+    p_Client = MakeIntrusive<Client>(c_ClientPool,
+                                     p_APITable,
+                                     p_Connection,
+                                     us_ID);
 }
 
 //*************************************************************************************
@@ -65,9 +80,10 @@ size_t ClientPool::AddClient(const QUIC_API_TABLE* p_APITable, HQUIC p_Connectio
         {
             try
             {
-                dq_Member[i].p_Client = std::make_shared<Client>(p_APITable,
-                                                                 p_Connection,
-                                                                 i);
+                dq_Member[i].p_Client = MakeIntrusive<Client>(*this,
+                                                              p_APITable,
+                                                              p_Connection,
+                                                              i);
                 dq_Member[i].c_Mutex.unlock();
                 
 #if CLIENT_EXTENDED_LOGGING > 0
@@ -90,7 +106,8 @@ size_t ClientPool::AddClient(const QUIC_API_TABLE* p_APITable, HQUIC p_Connectio
         // Lock for outside multithreading
         std::lock_guard<std::mutex> c_Guard(c_Mutex);
         
-        dq_Member.emplace_back(p_APITable,
+        dq_Member.emplace_back(*this,
+                               p_APITable,
                                p_Connection,
                                us_MemberCount);
         us_MemberCount += 1;
@@ -117,18 +134,26 @@ void ClientPool::DataRecieved(size_t us_ClientID, StreamData& c_Data) noexcept
     if (us_ClientID < us_MemberCount)
     {
         dq_Member[us_ClientID].c_Mutex.lock();
-        std::shared_ptr<Client> p_Client = dq_Member[us_ClientID].p_Client;
+        IntrusivePointer<Client> p_Client = dq_Member[us_ClientID].p_Client;
         dq_Member[us_ClientID].c_Mutex.unlock();
         
         if (p_Client != NULL)
         {
             p_Client->RecieveNetMessage(c_Data);
-            c_JobList.AddJob(p_Client);
+            c_JobList.AddJob(std::move(p_Client));
     
             return;
         }
     }
     
+    // Spooled custom net message without recipient
+    uint64_t u64_SpoolID = CustomSpool::ToSpoolID(c_Data.v_Bytes);
+    
+    if (u64_SpoolID != 0)
+    {
+        c_CustomSpool.Remove(u64_SpoolID);
+    }
+    
 #if CLIENT_EXTENDED_LOGGING > 0
     Logger::Singleton().Log(Logger::WARNING, "Failed to hand recieved net message data to client " +
                                              std::to_string(us_ClientID),
@@ -141,13 +166,13 @@ void ClientPool::SendableAvailable(size_t us_ClientID) noexcept
     if (us_ClientID < us_MemberCount)
     {
         dq_Member[us_ClientID].c_Mutex.lock();
-        std::shared_ptr<Client> p_Client = dq_Member[us_ClientID].p_Client;
+        IntrusivePointer<Client> p_Client = dq_Member[us_ClientID].p_Client;
         dq_Member[us_ClientID].c_Mutex.unlock();
         
         if (p_Client != NULL)
         {
             p_Client->RecieveDataAvailable();
-            c_JobList.AddJob(p_Client);
+            c_JobList.AddJob(std::move(p_Client));
         
             return;
         }
@@ -160,19 +185,272 @@ void ClientPool::SendableAvailable(size_t us_ClientID) noexcept
 #endif
 }
 
+void ClientPool::DataSent(size_t us_ClientID, uint64_t u64_SendID, bool b_Delivered) noexcept
+{
+    if (us_ClientID < us_MemberCount)
+    {
+        dq_Member[us_ClientID].c_Mutex.lock();
+        IntrusivePointer<Client> p_Client = dq_Member[us_ClientID].p_Client;
+        dq_Member[us_ClientID].c_Mutex.unlock();
+        
+        if (p_Client != NULL)
+        {
+            p_Client->RecieveDataSent(u64_SendID, b_Delivered);
+            c_JobList.AddJob(std::move(p_Client));
+            
+            return;
+        }
+    }
+
+#if CLIENT_EXTENDED_LOGGING > 0
+    Logger::Singleton().Log(Logger::WARNING, "Failed to hand send result to client " +
+                                             std::to_string(us_ClientID),
+                            "ClientPool.cpp", __LINE__);
+#endif
+}
+
+void ClientPool::UpdateAt(size_t us_ClientID, std::chrono::steady_clock::time_point c_Time) noexcept
+{
+    // Resolved when due, no reference is held while waiting
+    if (us_ClientID < us_MemberCount)
+    {
+        try
+        {
+            c_JobTimer.AddJob(*this, us_ClientID, c_Time);
+            return;
+        }
+        catch (...)
+        {}
+    }
+
+#if CLIENT_EXTENDED_LOGGING > 0
+    Logger::Singleton().Log(Logger::WARNING, "Failed to add timed update for client " +
+                                             std::to_string(us_ClientID),
+                            "ClientPool.cpp", __LINE__);
+#endif
+}
+
+//*************************************************************************************
+// Timer
+//*************************************************************************************
+
+void ClientPool::AddDueJob(size_t us_ClientID) noexcept
+{
+    if (us_ClientID >= us_MemberCount)
+    {
+        return;
+    }
+    
+    dq_Member[us_ClientID].c_Mutex.lock();
+    IntrusivePointer<Client> p_Client = dq_Member[us_ClientID].p_Client;
+    dq_Member[us_ClientID].c_Mutex.unlock();
+    
+    if (p_Client != NULL)
+    {
+        try
+        {
+            c_JobList.AddJob(std::move(p_Client));
+        }
+        catch (...)
+        {}
+    }
+}
+
+//*************************************************************************************
+// Presence
+//*************************************************************************************
+
+void ClientPool::SetOnline(size_t us_ClientID, InboxKey const& c_Key) noexcept
+{
+    try
+    {
+        std::lock_guard<std::mutex> c_Guard(c_PresenceMutex);
+        
+        if (m_OnlineKey.find(us_ClientID) != m_OnlineKey.end())
+        {
+            return;
+        }
+        
+        m_OnlineKey.emplace(us_ClientID, c_Key);
+        m_Online[c_Key].emplace_back(us_ClientID);
+        m_Online[InboxKey(c_Key.u32_UserID, "", c_Key.u8_ActorType)].emplace_back(us_ClientID);
+    }
+    catch (std::exception& e)
+    {
+        Logger::Singleton().Log(Logger::ERROR, "Failed to set client " +
+                                               std::to_string(us_ClientID) +
+                                               " online: " +
+                                               e.what(),
+                                "ClientPool.cpp", __LINE__);
+    }
+}
+
+void ClientPool::DataAvailable(InboxKey const& c_Key) noexcept
+{
+    std::vector<size_t> v_ClientID;
+    
+    // Copy, notifying locks the members
+    try
+    {
+        std::lock_guard<std::mutex> c_Guard(c_PresenceMutex);
+        auto Online = m_Online.find(c_Key);
+        
+        if (Online == m_Online.end())
+        {
+            return;
+        }
+        
+        v_ClientID = Online->second;
+    }
+    catch (...)
+    {
+        return;
+    }
+    
+    for (auto& ClientID : v_ClientID)
+    {
+        SendableAvailable(ClientID);
+    }
+}
+
+bool ClientPool::DeliverMessage(InboxKey const& c_Key, NetMessage const& c_NetMessage) noexcept
+{
+    std::vector<size_t> v_ClientID;
+    
+    try
+    {
+        std::lock_guard<std::mutex> c_Guard(c_PresenceMutex);
+        auto Online = m_Online.find(c_Key);
+        
+        if (Online == m_Online.end())
+        {
+            return false;
+        }
+        
+        v_ClientID = Online->second;
+    }
+    catch (...)
+    {
+        return false;
+    }
+    
+    // First client to accept recieves, message is only kept once
+    for (auto& ClientID : v_ClientID)
+    {
+        if (ClientID >= us_MemberCount)
+        {
+            continue;
+        }
+        
+        dq_Member[ClientID].c_Mutex.lock();
+        IntrusivePointer<Client> p_Client = dq_Member[ClientID].p_Client;
+        dq_Member[ClientID].c_Mutex.unlock();
+        
+        if (p_Client != NULL && p_Client->RecieveDirectMessage(c_NetMessage) == true)
+        {
+            try
+            {
+                c_JobList.AddJob(std::move(p_Client));
+                return true;
+            }
+            catch (...)
+            {
+                // @NOTE: Accepted messages are stored by the client
+                //        on its next run if never sent.
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
 //*************************************************************************************
 // Remove
 //*************************************************************************************
 
 void ClientPool::RemoveClient(size_t us_ClientID) noexcept
 {
-    if (us_ClientID > us_MemberCount)
+    if (us_ClientID >= us_MemberCount)
     {
         return;
     }
     
+    // Offline first, no more notifications
+    {
+        std::lock_guard<std::mutex> c_Guard(c_PresenceMutex);
+        auto Key = m_OnlineKey.find(us_ClientID);
+        
+        if (Key != m_OnlineKey.end())
+        {
+            InboxKey p_Key[2] =
+            {
+                Key->second,
+                InboxKey(Key->second.u32_UserID, "", Key->second.u8_ActorType)
+            };
+            
+            for (auto& OnlineKey : p_Key)
+            {
+                auto Online = m_Online.find(OnlineKey);
+                
+                if (Online == m_Online.end())
+                {
+                    continue;
+                }
+                
+                std::vector<size_t>& v_ClientID = Online->second;
+                v_ClientID.erase(std::remove(v_ClientID.begin(), v_ClientID.end(), us_ClientID),
+                                 v_ClientID.end());
+                
+                if (v_ClientID.size() == 0)
+                {
+                    m_Online.erase(Online);
+                }
+            }
+            
+            m_OnlineKey.erase(Key);
+        }
+    }
+    
     std::lock_guard<std::mutex> c_Guard(dq_Member[us_ClientID].c_Mutex);
     
+    // Final run stores undelivered direct messages
+    if (dq_Member[us_ClientID].p_Client != NULL)
+    {
+        dq_Member[us_ClientID].p_Client->Disconnected();
+        
+        try
+        {
+            c_JobList.AddJob(std::move(dq_Member[us_ClientID].p_Client));
+        }
+        catch (...)
+        {}
+    }
+    
     dq_Member[us_ClientID].p_Client.reset();
     dq_Member[us_ClientID].p_Client = NULL;
 }
+
+//*************************************************************************************
+// Getters
+//*************************************************************************************
+
+int ClientPool::GetLongPollS() const noexcept
+{
+    return i_LongPollS;
+}
+
+int ClientPool::GetNotificationWindowMS() const noexcept
+{
+    return i_NotificationWindowMS;
+}
+
+int ClientPool::GetCompressionSizeMin() const noexcept
+{
+    return i_CompressionSizeMin;
+}
+
+CustomSpool& ClientPool::GetCustomSpool() noexcept
+{
+    return c_CustomSpool;
+}
@@ -18,15 +18,20 @@
 #define ClientPool_h
 
 // C / C++
+#include <unordered_map>
+#include <vector>
 
 // External
 
 // Project
 #include "./Client.h"
+#include "./CustomSpool.h"
 #include "../Job/JobList.h"
+#include "../Job/JobTimer.h"
+#include "../Database/InboxKey.h"
 
 
-class ClientPool
+class ClientPool : public JobTimer::Source
 {
 public:
     
@@ -38,9 +43,19 @@ public:
      *  Default constructor.
      *
      *  \param c_JobList The job list to update clients with.
+     *  \param c_JobTimer The job timer to update clients later with.
+     *  \param i_LongPollS The time in seconds data requests wait for messages.
+     *  \param i_NotificationWindowMS The time in milliseconds notifications are coalesced.
+     *  \param i_CompressionSizeMin The size in bytes from which text messages are compressed.
+     *  \param c_CustomSpool The spool for custom net messages.
      */
     
-    ClientPool(JobList& c_JobList);
+    ClientPool(JobList& c_JobList,
+               JobTimer& c_JobTimer,
+               int i_LongPollS,
+               int i_NotificationWindowMS,
+               int i_CompressionSizeMin,
+               CustomSpool& c_CustomSpool);
     
     /**
      *  Copy constructor. Disabled for this class.
@@ -92,6 +107,58 @@ public:
     
     void SendableAvailable(size_t us_ClientID) noexcept;
     
+    /**
+     *  Notify a client of a finished tracked send.
+     *
+     *  \param us_ClientID The id of the client.
+     *  \param u64_SendID The id of the tracked send.
+     *  \param b_Delivered If the send was delivered or canceled.
+     */
+    
+    void DataSent(size_t us_ClientID, uint64_t u64_SendID, bool b_Delivered) noexcept;
+    
+    /**
+     *  Update a client again at a given time. Clients removed before are
+     *  skipped, a new client with the same id is updated instead.
+     *
+     *  \param us_ClientID The id of the client.
+     *  \param c_Time The time to update the client at.
+     */
+    
+    void UpdateAt(size_t us_ClientID, std::chrono::steady_clock::time_point c_Time) noexcept;
+    
+    //*************************************************************************************
+    // Presence
+    //*************************************************************************************
+    
+    /**
+     *  Set a client as online for the inbox it retrieves from.
+     *
+     *  \param us_ClientID The id of the client.
+     *  \param c_Key The inbox key the client retrieves from.
+     */
+    
+    void SetOnline(size_t us_ClientID, InboxKey const& c_Key) noexcept;
+    
+    /**
+     *  Notify all online clients of a inbox of available data.
+     *
+     *  \param c_Key The inbox key which recieved data.
+     */
+    
+    void DataAvailable(InboxKey const& c_Key) noexcept;
+    
+    /**
+     *  Deliver a message directly to a online client of a inbox.
+     *
+     *  \param c_Key The inbox key of the recipient.
+     *  \param c_NetMessage The message to deliver.
+     *
+     *  \return true if a client accepted the message, false if not.
+     */
+    
+    bool DeliverMessage(InboxKey const& c_Key, NetMessage const& c_NetMessage) noexcept;
+    
     //*************************************************************************************
     // Remove
     //*************************************************************************************
@@ -104,6 +171,42 @@ public:
     
     void RemoveClient(size_t us_ClientID) noexcept;
     
+    //*************************************************************************************
+    // Getters
+    //*************************************************************************************
+    
+    /**
+     *  Get the time data requests wait for messages.
+     *
+     *  \return The long poll time in seconds, 0 if disabled.
+     */
+    
+    int GetLongPollS() const noexcept;
+    
+    /**
+     *  Get the time notifications of a sender are coalesced.
+     *
+     *  \return The notification window in milliseconds, 0 if disabled.
+     */
+    
+    int GetNotificationWindowMS() const noexcept;
+    
+    /**
+     *  Get the size from which text messages are compressed.
+     *
+     *  \return The min compression size in bytes, 0 if disabled.
+     */
+    
+    int GetCompressionSizeMin() const noexcept;
+    
+    /**
+     *  Get the spool for custom net messages.
+     *
+     *  \return The custom spool.
+     */
+    
+    CustomSpool& GetCustomSpool() noexcept;
+    
 private:
     
     //*************************************************************************************
@@ -119,12 +222,14 @@ private:
         /**
          *  Default constructor.
          *
+         *  \param c_ClientPool The client pool of the member client.
          *  \param p_APITable The api table for the member client
          *  \param p_Connection The connection for the member client.
          *  \param us_ID The id for the member client.
          */
         
-        Member(const QUIC_API_TABLE* p_APITable,
+        Member(ClientPool& c_ClientPool,
+               const QUIC_API_TABLE* p_APITable,
                HQUIC p_Connection,
                size_t us_ID);
         
@@ -133,19 +238,44 @@ private:
         //*************************************************************************************
         
         std::mutex c_Mutex;
-        std::shared_ptr<Client> p_Client;
+        IntrusivePointer<Client> p_Client;
     };
     
+    //*************************************************************************************
+    // Timer
+    //*************************************************************************************
+    
+    /**
+     *  Update a client for a due timed update.
+     *
+     *  \param us_ClientID The id of the client.
+     */
+    
+    void AddDueJob(size_t us_ClientID) noexcept override;
+    
     //*************************************************************************************
     // Data
     //*************************************************************************************
     
     JobList& c_JobList;
+    JobTimer& c_JobTimer;
+    int i_LongPollS;
+    int i_NotificationWindowMS;
+    int i_CompressionSizeMin;
+    CustomSpool& c_CustomSpool;
     
     std::mutex c_Mutex;
     std::deque<Member> dq_Member;
     std::atomic<size_t> us_MemberCount;
     
+    // @NOTE: Clients are indexed by the inbox they retrieve from, a
+    //        stored message key is the recipient inbox key. Clients
+    //        are also indexed by the fan-out inbox of their user,
+    //        which has no device key.
+    std::mutex c_PresenceMutex;
+    std::unordered_map<InboxKey, std::vector<size_t>, InboxKeyHash> m_Online;
+    std::unordered_map<size_t, InboxKey> m_OnlineKey;
+    
 protected:
 
 };
@@ -0,0 +1,239 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+
+// External
+
+// Project
+#include "./CustomSpool.h"
+
+namespace
+{
+    constexpr size_t us_ReferenceSize = NetMessage::us_DataPos + sizeof(uint64_t);
+    
+    std::string GetErrorString() noexcept
+    {
+        return std::string(std::strerror(errno)) +
+               " (" +
+               std::to_string(errno) +
+               ")";
+    }
+}
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+CustomSpool::CustomSpool(std::string const& s_DirectoryPath,
+                         uint64_t u64_SizeMax) : s_DirectoryPath(s_DirectoryPath),
+                                                 u64_SizeMax(u64_SizeMax)
+{
+    if (mkdir(s_DirectoryPath.c_str(), 0700) < 0 && errno != EEXIST)
+    {
+        throw Exception("Failed to create custom spool directory " +
+                        s_DirectoryPath +
+                        ": " +
+                        GetErrorString());
+    }
+    
+    // @NOTE: Ids continue after files of earlier runs or other
+    //        instances sharing the directory, creation skips taken ones.
+    u64_NextSpoolID = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+CustomSpool::~CustomSpool() noexcept
+{}
+
+//*************************************************************************************
+// Spool
+//*************************************************************************************
+
+uint64_t CustomSpool::Create(int& i_FD)
+{
+    while (true)
+    {
+        uint64_t u64_SpoolID = u64_NextSpoolID++;
+        
+        if (u64_SpoolID == 0)
+        {
+            continue;
+        }
+        
+        i_FD = open(GetPath(u64_SpoolID).c_str(), O_WRONLY | O_CREAT | O_EXCL, 0600);
+        
+        if (i_FD >= 0)
+        {
+            return u64_SpoolID;
+        }
+        else if (errno != EEXIST)
+        {
+            throw Exception("Failed to create custom spool file: " + GetErrorString());
+        }
+    }
+}
+
+int CustomSpool::Open(uint64_t u64_SpoolID, uint64_t& u64_Size)
+{
+    int i_FD = open(GetPath(u64_SpoolID).c_str(), O_RDONLY);
+    struct stat c_Stat;
+    
+    if (i_FD < 0)
+    {
+        throw Exception("Failed to open custom spool file: " + GetErrorString());
+    }
+    else if (fstat(i_FD, &c_Stat) < 0)
+    {
+        std::string s_Error = GetErrorString();
+        close(i_FD);
+        
+        throw Exception("Failed to read custom spool file size: " + s_Error);
+    }
+    
+    u64_Size = c_Stat.st_size;
+    return i_FD;
+}
+
+void CustomSpool::Remove(uint64_t u64_SpoolID) noexcept
+{
+    unlink(GetPath(u64_SpoolID).c_str());
+}
+
+void CustomSpool::Write(int i_FD, const uint8_t* p_Data, size_t us_Size)
+{
+    while (us_Size > 0)
+    {
+        ssize_t ss_Written = write(i_FD, p_Data, us_Size);
+        
+        if (ss_Written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            
+            throw Exception("Failed to write custom spool file: " + GetErrorString());
+        }
+        
+        p_Data += ss_Written;
+        us_Size -= ss_Written;
+    }
+}
+
+size_t CustomSpool::Read(int i_FD, uint8_t* p_Buffer, size_t us_Size)
+{
+    size_t us_Read = 0;
+    
+    while (us_Read < us_Size)
+    {
+        ssize_t ss_Read = read(i_FD, p_Buffer + us_Read, us_Size - us_Read);
+        
+        if (ss_Read < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            
+            throw Exception("Failed to read custom spool file: " + GetErrorString());
+        }
+        else if (ss_Read == 0)
+        {
+            break;
+        }
+        
+        us_Read += ss_Read;
+    }
+    
+    return us_Read;
+}
+
+void CustomSpool::ReadChunk(int i_FD, uint64_t& u64_Remaining, std::vector<uint8_t>& v_Buffer, size_t us_Offset)
+{
+    size_t us_Size = u64_Remaining < CUSTOM_SPOOL_CHUNK_SIZE ? u64_Remaining : CUSTOM_SPOOL_CHUNK_SIZE;
+    
+    v_Buffer.resize(us_Offset + us_Size);
+    
+    if (Read(i_FD, v_Buffer.data() + us_Offset, us_Size) != us_Size)
+    {
+        throw Exception("Custom spool file ended early!");
+    }
+    
+    u64_Remaining -= us_Size;
+}
+
+void CustomSpool::Close(int i_FD) noexcept
+{
+    if (i_FD >= 0)
+    {
+        close(i_FD);
+    }
+}
+
+//*************************************************************************************
+// Reference
+//*************************************************************************************
+
+std::vector<uint8_t> CustomSpool::ToReference(uint64_t u64_SpoolID)
+{
+    std::vector<uint8_t> v_Message(us_ReferenceSize, 0);
+    
+    v_Message[NetMessage::us_IDPos] = NetMessage::MSG_CUSTOM;
+    std::memcpy(&(v_Message[NetMessage::us_DataPos]), &u64_SpoolID, sizeof(uint64_t));
+    
+    return v_Message;
+}
+
+uint64_t CustomSpool::ToSpoolID(std::vector<uint8_t> const& v_Message, size_t us_Pos) noexcept
+{
+    // @NOTE: Recieved custom net messages are always spooled, every
+    //        custom net message kept by the server is a reference.
+    if (v_Message.size() != us_Pos + us_ReferenceSize || v_Message[us_Pos + NetMessage::us_IDPos] != NetMessage::MSG_CUSTOM)
+    {
+        return 0;
+    }
+    
+    uint64_t u64_SpoolID;
+    std::memcpy(&u64_SpoolID, &(v_Message[us_Pos + NetMessage::us_DataPos]), sizeof(uint64_t));
+    
+    return u64_SpoolID;
+}
+
+//*************************************************************************************
+// Getters
+//*************************************************************************************
+
+uint64_t CustomSpool::GetSizeMax() const noexcept
+{
+    return u64_SizeMax;
+}
+
+//*************************************************************************************
+// Path
+//*************************************************************************************
+
+std::string CustomSpool::GetPath(uint64_t u64_SpoolID) const noexcept
+{
+    return s_DirectoryPath + "/" + std::to_string(u64_SpoolID) + ".custom";
+}
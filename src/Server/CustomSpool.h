@@ -0,0 +1,211 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef CustomSpool_h
+#define CustomSpool_h
+
+// C / C++
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+
+// External
+
+// Project
+#include "../NetMessage/NetMessage.h"
+
+// Pre-defined
+#ifndef CUSTOM_SPOOL_CHUNK_SIZE
+    #define CUSTOM_SPOOL_CHUNK_SIZE (64 * 1024)
+#endif
+
+
+class CustomSpool
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     *
+     *  \param s_DirectoryPath The full path to the spool directory.
+     *  \param u64_SizeMax The max size of a custom net message in bytes.
+     */
+    
+    CustomSpool(std::string const& s_DirectoryPath,
+                uint64_t u64_SizeMax);
+    
+    /**
+     *  Copy constructor. Disabled for this class.
+     *
+     *  \param c_CustomSpool CustomSpool class source.
+     */
+    
+    CustomSpool(CustomSpool const& c_CustomSpool) = delete;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~CustomSpool() noexcept;
+    
+    //*************************************************************************************
+    // Spool
+    //*************************************************************************************
+    
+    /**
+     *  Create a spool file for a custom net message. This function is thread
+     *  safe.
+     *
+     *  \param i_FD The writable file descriptor to write.
+     *
+     *  \return The spool id of the created file.
+     */
+    
+    uint64_t Create(int& i_FD);
+    
+    /**
+     *  Open a spool file for reading. This function is thread safe.
+     *
+     *  \param u64_SpoolID The spool id of the file.
+     *  \param u64_Size The file size to write.
+     *
+     *  \return The readable file descriptor.
+     */
+    
+    int Open(uint64_t u64_SpoolID, uint64_t& u64_Size);
+    
+    /**
+     *  Remove a spool file. This function is thread safe.
+     *
+     *  \param u64_SpoolID The spool id of the file.
+     */
+    
+    void Remove(uint64_t u64_SpoolID) noexcept;
+    
+    /**
+     *  Write all bytes to a spool file.
+     *
+     *  \param i_FD The writable file descriptor.
+     *  \param p_Data The bytes to write.
+     *  \param us_Size The amount of bytes to write.
+     */
+    
+    static void Write(int i_FD, const uint8_t* p_Data, size_t us_Size);
+    
+    /**
+     *  Read bytes from a spool file.
+     *
+     *  \param i_FD The readable file descriptor.
+     *  \param p_Buffer The buffer to read to.
+     *  \param us_Size The amount of bytes to read.
+     *
+     *  \return The amount of bytes read, less than requested at the end.
+     */
+    
+    static size_t Read(int i_FD, uint8_t* p_Buffer, size_t us_Size);
+    
+    /**
+     *  Read the next chunk of a spool file, at most CUSTOM_SPOOL_CHUNK_SIZE bytes.
+     *
+     *  \param i_FD The readable file descriptor.
+     *  \param u64_Remaining The bytes left to read, updated to the bytes left after the chunk.
+     *  \param v_Buffer The buffer to read to, resized to the offset and chunk.
+     *  \param us_Offset The position of the chunk in the buffer.
+     */
+    
+    static void ReadChunk(int i_FD, uint64_t& u64_Remaining, std::vector<uint8_t>& v_Buffer, size_t us_Offset);
+    
+    /**
+     *  Close a spool file descriptor.
+     *
+     *  \param i_FD The file descriptor to close.
+     */
+    
+    static void Close(int i_FD) noexcept;
+    
+    //*************************************************************************************
+    // Reference
+    //*************************************************************************************
+    
+    /**
+     *  Create the net message referencing a spooled custom net message. The
+     *  reference is kept by stores and replaced by the file when sent.
+     *
+     *  \param u64_SpoolID The spool id of the file.
+     *
+     *  \return The full reference net message buffer.
+     */
+    
+    static std::vector<uint8_t> ToReference(uint64_t u64_SpoolID);
+    
+    /**
+     *  Get the spool id referenced by a net message.
+     *
+     *  \param v_Message The full net message buffer.
+     *  \param us_Pos The position of the reference in the buffer.
+     *
+     *  \return The spool id, 0 if no reference.
+     */
+    
+    static uint64_t ToSpoolID(std::vector<uint8_t> const& v_Message, size_t us_Pos = 0) noexcept;
+    
+    //*************************************************************************************
+    // Getters
+    //*************************************************************************************
+    
+    /**
+     *  Get the max size of a custom net message.
+     *
+     *  \return The max size in bytes.
+     */
+    
+    uint64_t GetSizeMax() const noexcept;
+    
+private:
+    
+    //*************************************************************************************
+    // Path
+    //*************************************************************************************
+    
+    /**
+     *  Get the path of a spool file.
+     *
+     *  \param u64_SpoolID The spool id of the file.
+     *
+     *  \return The full file path.
+     */
+    
+    std::string GetPath(uint64_t u64_SpoolID) const noexcept;
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    std::string s_DirectoryPath;
+    uint64_t u64_SizeMax;
+    
+    std::atomic<uint64_t> u64_NextSpoolID;
+    
+protected:
+
+};
+
+#endif /* CustomSpool_h */
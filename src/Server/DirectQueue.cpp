@@ -0,0 +1,119 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <algorithm>
+
+// External
+
+// Project
+#include "./DirectQueue.h"
+#include "../Database/MessageStore.h"
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+DirectQueue::DirectQueue() noexcept : u64_Generation(0),
+                                      b_Drained(false),
+                                      b_Closed(false)
+{}
+
+DirectQueue::~DirectQueue() noexcept
+{}
+
+//*************************************************************************************
+// Queue
+//*************************************************************************************
+
+bool DirectQueue::Add(NetMessage const& c_NetMessage)
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    
+    if (b_Closed == true || b_Drained == false)
+    {
+        return false;
+    }
+    
+    // Queued and not yet sent, replaced like stored messages
+    if (MessageStore::KeepLatest(c_NetMessage.v_Data) == true)
+    {
+        NetMessage::NetMessageList e_ID = c_NetMessage.GetID();
+        
+        dq_Message.erase(std::remove_if(dq_Message.begin(), dq_Message.end(), [e_ID](NetMessage const& c_Queued)
+        {
+            return c_Queued.GetID() == e_ID;
+        }), dq_Message.end());
+    }
+    
+    dq_Message.emplace_back(c_NetMessage);
+    return true;
+}
+
+void DirectQueue::Take(std::deque<NetMessage>& dq_Message) noexcept
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    
+    dq_Message.clear();
+    dq_Message.swap(this->dq_Message);
+}
+
+void DirectQueue::Return(std::deque<NetMessage>& dq_Message)
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    
+    this->dq_Message.insert(this->dq_Message.begin(),
+                            std::make_move_iterator(dq_Message.begin()),
+                            std::make_move_iterator(dq_Message.end()));
+    dq_Message.clear();
+}
+
+void DirectQueue::Close() noexcept
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    b_Closed = true;
+}
+
+//*************************************************************************************
+// Store
+//*************************************************************************************
+
+uint64_t DirectQueue::GetGeneration() noexcept
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    return u64_Generation;
+}
+
+void DirectQueue::SetDrained(uint64_t u64_Generation) noexcept
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    
+    // @NOTE: A message stored while retrieving might not have been
+    //        visible to the retrieval.
+    if (this->u64_Generation == u64_Generation)
+    {
+        b_Drained = true;
+    }
+}
+
+void DirectQueue::SetAvailable() noexcept
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    
+    u64_Generation += 1;
+    b_Drained = false;
+}
@@ -0,0 +1,142 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef DirectQueue_h
+#define DirectQueue_h
+
+// C / C++
+#include <mutex>
+#include <deque>
+
+// External
+
+// Project
+#include "../NetMessage/NetMessage.h"
+
+
+// @NOTE: Messages from online senders skip the store. They are only
+//        accepted once the recipient read all stored messages, a direct
+//        message never overtakes a stored one.
+class DirectQueue
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     */
+    
+    DirectQueue() noexcept;
+    
+    /**
+     *  Copy constructor. Disabled for this class.
+     *
+     *  \param c_DirectQueue DirectQueue class source.
+     */
+    
+    DirectQueue(DirectQueue const& c_DirectQueue) = delete;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~DirectQueue() noexcept;
+    
+    //*************************************************************************************
+    // Queue
+    //*************************************************************************************
+    
+    /**
+     *  Add a direct message. Queued messages of a replacing type are removed.
+     *  This function is thread safe.
+     *
+     *  \param c_NetMessage The message to add.
+     *
+     *  \return true if the message was accepted, false if it has to be stored.
+     */
+    
+    bool Add(NetMessage const& c_NetMessage);
+    
+    /**
+     *  Take all queued messages. This function is thread safe.
+     *
+     *  \param dq_Message The queued messages to write.
+     */
+    
+    void Take(std::deque<NetMessage>& dq_Message) noexcept;
+    
+    /**
+     *  Return unsent messages in front of the queue. This function is thread safe.
+     *
+     *  \param dq_Message The unsent messages in order.
+     */
+    
+    void Return(std::deque<NetMessage>& dq_Message);
+    
+    /**
+     *  Stop accepting messages. This function is thread safe.
+     */
+    
+    void Close() noexcept;
+    
+    //*************************************************************************************
+    // Store
+    //*************************************************************************************
+    
+    /**
+     *  Get the current store generation, read before retrieving from the store.
+     *  This function is thread safe.
+     *
+     *  \return The store generation.
+     */
+    
+    uint64_t GetGeneration() noexcept;
+    
+    /**
+     *  Set the store as read completely. Ignored if messages were stored since
+     *  the generation was read. This function is thread safe.
+     *
+     *  \param u64_Generation The generation read before the empty retrieval.
+     */
+    
+    void SetDrained(uint64_t u64_Generation) noexcept;
+    
+    /**
+     *  Set the store as containing messages. This function is thread safe.
+     */
+    
+    void SetAvailable() noexcept;
+    
+private:
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    std::mutex c_Mutex;
+    std::deque<NetMessage> dq_Message;
+    uint64_t u64_Generation;
+    bool b_Drained;
+    bool b_Closed;
+    
+protected:
+
+};
+
+#endif /* DirectQueue_h */
@@ -25,6 +25,80 @@
 #include "./StreamRecieveContext.h"
 #include "./StreamSendContext.h"
 
+namespace
+{
+    /**
+     *  Write the recieved bytes of a custom net message to the spool. The
+     *  final write replaces the bytes with the spool reference.
+     *
+     *  \param p_Context The recieving stream context.
+     *  \param b_Final If all bytes of the stream were recieved.
+     */
+    
+    void SpoolRecieved(StreamRecieveContext* p_Context, bool b_Final)
+    {
+        CustomSpool& c_CustomSpool = p_Context->c_ClientPool.GetCustomSpool();
+        std::vector<uint8_t>& v_Bytes = p_Context->c_Data.v_Bytes;
+        
+        if (p_Context->i_SpoolFD < 0)
+        {
+            p_Context->u64_SpoolID = c_CustomSpool.Create(p_Context->i_SpoolFD);
+            p_Context->u64_SpoolSize = 0;
+        }
+        
+        p_Context->u64_SpoolSize += v_Bytes.size();
+        
+        if (p_Context->u64_SpoolSize > c_CustomSpool.GetSizeMax())
+        {
+            throw Exception("Custom net message exceeds max size!");
+        }
+        
+        CustomSpool::Write(p_Context->i_SpoolFD, v_Bytes.data(), v_Bytes.size());
+        v_Bytes.clear();
+        
+        if (b_Final == true)
+        {
+            CustomSpool::Close(p_Context->i_SpoolFD);
+            p_Context->i_SpoolFD = -1;
+            
+            v_Bytes = CustomSpool::ToReference(p_Context->u64_SpoolID);
+        }
+    }
+    
+    /**
+     *  Remove the incomplete custom net message of a stream.
+     *
+     *  \param p_Context The recieving stream context.
+     */
+    
+    void ClearSpool(StreamRecieveContext* p_Context) noexcept
+    {
+        if (p_Context->i_SpoolFD < 0)
+        {
+            return;
+        }
+        
+        CustomSpool::Close(p_Context->i_SpoolFD);
+        p_Context->c_ClientPool.GetCustomSpool().Remove(p_Context->u64_SpoolID);
+        
+        p_Context->i_SpoolFD = -1;
+    }
+    
+    /**
+     *  Check if a stream recieves a custom net message.
+     *
+     *  \param p_Context The recieving stream context.
+     *
+     *  \return true if custom, false if not.
+     */
+    
+    bool IsCustom(StreamRecieveContext* p_Context) noexcept
+    {
+        return p_Context->i_SpoolFD >= 0 ||
+               (p_Context->c_Data.v_Bytes.size() > 0 && p_Context->c_Data.v_Bytes[NetMessage::us_IDPos] == NetMessage::MSG_CUSTOM);
+    }
+}
+
 
 //*************************************************************************************
 // Listener
@@ -161,6 +235,10 @@ QUIC_STATUS QUIC_API ConnectionCallback(_In_ HQUIC Connection, _In_opt_ void* Co
                 p_Stream->c_Data.e_State = StreamData::IN_USE;
             }
             
+            // Recieved net messages take the buffer, the stream gets
+            // a reused one in exchange
+            p_Stream->c_Data.v_Bytes.reserve(NET_MESSAGE_BUFFER_SIZE);
+            
             // Got context, start callback
             p_Context->p_APITable->SetCallbackHandler(Event->PEER_STREAM_STARTED.Stream,
                                                       (void*)StreamRecieveCallback,
@@ -199,11 +277,32 @@ QUIC_STATUS QUIC_API StreamRecieveCallback(_In_ HQUIC Stream, _In_opt_ void* Con
                                                  p_Start,
                                                  p_End);
             }
+            
+            // Custom net messages are written in chunks instead of
+            // being kept in memory
+            if (IsCustom(p_Context) == true && p_Context->c_Data.v_Bytes.size() >= CUSTOM_SPOOL_CHUNK_SIZE)
+            {
+                try
+                {
+                    SpoolRecieved(p_Context, false);
+                }
+                catch (...)
+                {
+                    ClearSpool(p_Context);
+                    
+                    p_Context->c_Data.e_State = StreamData::FREE;
+                    p_Context->p_APITable->StreamShutdown(Stream,
+                                                          QUIC_STREAM_SHUTDOWN_FLAG_ABORT,
+                                                          0);
+                }
+            }
             break;
         }
             
         case QUIC_STREAM_EVENT_PEER_SEND_ABORTED:
         {
+            ClearSpool(p_Context);
+            
             p_Context->c_Data.e_State = StreamData::FREE;
             p_Context->p_APITable->StreamShutdown(Stream,
                                                   QUIC_STREAM_SHUTDOWN_FLAG_ABORT,
@@ -213,6 +312,24 @@ QUIC_STATUS QUIC_API StreamRecieveCallback(_In_ HQUIC Stream, _In_opt_ void* Con
         
         case QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN:
         {
+            if (IsCustom(p_Context) == true)
+            {
+                try
+                {
+                    SpoolRecieved(p_Context, true);
+                }
+                catch (...)
+                {
+                    ClearSpool(p_Context);
+                    
+                    p_Context->c_Data.e_State = StreamData::FREE;
+                    p_Context->p_APITable->StreamShutdown(Stream,
+                                                          QUIC_STREAM_SHUTDOWN_FLAG_ABORT,
+                                                          0);
+                    break;
+                }
+            }
+            
             p_Context->c_Data.e_State = StreamData::COMPLETED; // Stream shutdown, so full message
             p_Context->p_APITable->StreamShutdown(Stream,
                                                   QUIC_STREAM_SHUTDOWN_FLAG_GRACEFUL,
@@ -246,15 +363,63 @@ QUIC_STATUS QUIC_API StreamSendCallback(_In_ HQUIC Stream, _In_opt_ void* Contex
     {
         case QUIC_STREAM_EVENT_SEND_COMPLETE:
         {
+            bool b_Delivered = Event->SEND_COMPLETE.Canceled == FALSE;
+            
+            // Custom net messages continue with the next chunk
+            if (p_Context->i_SpoolFD >= 0)
+            {
+                if (b_Delivered == true && p_Context->u64_SpoolRemaining > 0)
+                {
+                    try
+                    {
+                        QUIC_BUFFER* p_QuicBuffer = p_Context->ReadSpooled(0);
+                        
+                        if (QUIC_FAILED(p_Context->p_APITable->StreamSend(Stream,
+                                                                          p_QuicBuffer,
+                                                                          1,
+                                                                          p_Context->u64_SpoolRemaining > 0 ? QUIC_SEND_FLAG_NONE : QUIC_SEND_FLAG_FIN,
+                                                                          NULL)))
+                        {
+                            throw Exception("Failed to send on stream!");
+                        }
+                        
+                        // Next chunk in flight
+                        break;
+                    }
+                    catch (...)
+                    {}
+                    
+                    b_Delivered = false;
+                    p_Context->p_APITable->StreamShutdown(Stream,
+                                                          QUIC_STREAM_SHUTDOWN_FLAG_ABORT,
+                                                          0);
+                }
+                
+                CustomSpool::Close(p_Context->i_SpoolFD);
+                p_Context->i_SpoolFD = -1;
+            }
+            
+            // Grab before the context can be reused
+            uint64_t u64_SendID = p_Context->u64_SendID;
+            
             p_Context->c_Data.e_State = StreamData::COMPLETED; // Can be used for sending again
             p_Context->p_APITable->StreamShutdown(Stream,
                                                   QUIC_STREAM_SHUTDOWN_FLAG_GRACEFUL,
                                                   0);
+            
+            // Tracked sends are finished by the client
+            if (u64_SendID != 0)
+            {
+                p_Context->c_ClientPool.DataSent(p_Context->us_ClientID,
+                                                 u64_SendID,
+                                                 b_Delivered);
+            }
             break;
         }
             
         case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
         {
+            p_Context->ClearStream(Stream);
             p_Context->p_APITable->StreamClose(Stream);
             break;
         }
@@ -29,6 +29,7 @@
 #include "./StreamData.h"
 #include "../../Job/JobList.h"
 #include "../ClientPool.h"
+#include "../CustomSpool.h"
 
 
 struct StreamRecieveContext
@@ -54,9 +55,26 @@ public:
                          size_t us_ClientID) noexcept : p_APITable(p_APITable),
                                                         p_Connection(p_Connection),
                                                         c_ClientPool(c_ClientPool),
-                                                        us_ClientID(us_ClientID)
+                                                        us_ClientID(us_ClientID),
+                                                        i_SpoolFD(-1),
+                                                        u64_SpoolID(0),
+                                                        u64_SpoolSize(0)
     {}
     
+    /**
+     *  Default destructor.
+     */
+    
+    ~StreamRecieveContext() noexcept
+    {
+        // Custom net message never completed
+        if (i_SpoolFD >= 0)
+        {
+            CustomSpool::Close(i_SpoolFD);
+            c_ClientPool.GetCustomSpool().Remove(u64_SpoolID);
+        }
+    }
+    
     //*************************************************************************************
     // Types
     //*************************************************************************************
@@ -68,6 +86,11 @@ public:
     size_t us_ClientID;
     
     StreamData c_Data;
+    
+    // Custom net messages are written to disk while recieved
+    int i_SpoolFD; // -1 if not spooled
+    uint64_t u64_SpoolID;
+    uint64_t u64_SpoolSize;
 };
 
 #endif /* StreamRecieveContext_h */
@@ -18,12 +18,23 @@
 #define StreamSendContext_h
 
 // C / C++
+#include <cstdint>
+#include <cstring>
+#include <mutex>
 
 // External
 #include <msquic.h>
 
 // Project
 #include "./StreamData.h"
+#include "../CustomSpool.h"
+
+// Pre-defined
+#ifndef STREAM_SEND_BUFFER_SIZE
+    #define STREAM_SEND_BUFFER_SIZE 1025 // Net message id and data
+#endif
+
+class ClientPool;
 
 
 struct StreamSendContext
@@ -38,18 +49,155 @@ public:
      *  Default constructor.
      *
      *  \param p_APITable The library api table.
+     *  \param c_ClientPool The client pool containing all clients.
+     *  \param us_ClientID The id of the client which sends.
      */
     
-    StreamSendContext(const QUIC_API_TABLE* p_APITable) noexcept : p_APITable(p_APITable)
+    StreamSendContext(const QUIC_API_TABLE* p_APITable,
+                      ClientPool& c_ClientPool,
+                      size_t us_ClientID) noexcept : p_APITable(p_APITable),
+                                                     c_ClientPool(c_ClientPool),
+                                                     us_ClientID(us_ClientID),
+                                                     u64_SendID(0),
+                                                     p_Stream(NULL),
+                                                     i_SpoolFD(-1),
+                                                     u64_SpoolRemaining(0)
     {}
     
+    //*************************************************************************************
+    // Buffer
+    //*************************************************************************************
+    
+    /**
+     *  Copy a net message to the send buffer. The buffer is kept for
+     *  following sends, no allocation is needed once the context was used.
+     *
+     *  \param v_Message The full net message buffer, at most STREAM_SEND_BUFFER_SIZE.
+     *
+     *  \return The quic buffer for the net message.
+     */
+    
+    QUIC_BUFFER* CopyBuffer(std::vector<uint8_t> const& v_Message)
+    {
+        static constexpr size_t us_Capacity = sizeof(QUIC_BUFFER) + STREAM_SEND_BUFFER_SIZE;
+        
+        // Release larger buffers from swapped or spooled sends
+        if (c_Data.v_Bytes.capacity() > us_Capacity)
+        {
+            std::vector<uint8_t>().swap(c_Data.v_Bytes);
+        }
+        
+        c_Data.v_Bytes.reserve(us_Capacity);
+        c_Data.v_Bytes.resize(sizeof(QUIC_BUFFER) + v_Message.size());
+        
+        memcpy(&(c_Data.v_Bytes[sizeof(QUIC_BUFFER)]), v_Message.data(), v_Message.size());
+        
+        QUIC_BUFFER* p_QuicBuffer = (QUIC_BUFFER*)&(c_Data.v_Bytes[0]);
+        p_QuicBuffer->Buffer = &(c_Data.v_Bytes[sizeof(QUIC_BUFFER)]);
+        p_QuicBuffer->Length = v_Message.size();
+        
+        return p_QuicBuffer;
+    }
+    
+    //*************************************************************************************
+    // Stream
+    //*************************************************************************************
+    
+    /**
+     *  Set the stream used for the current send.
+     *
+     *  \param p_Stream The opened stream.
+     */
+    
+    void SetStream(HQUIC p_Stream) noexcept
+    {
+        std::lock_guard<std::mutex> c_Guard(c_StreamMutex);
+        this->p_Stream = p_Stream;
+    }
+    
+    /**
+     *  Clear a stream before it is closed. Streams of earlier sends are ignored.
+     *
+     *  \param p_Stream The stream to close.
+     */
+    
+    void ClearStream(HQUIC p_Stream) noexcept
+    {
+        std::lock_guard<std::mutex> c_Guard(c_StreamMutex);
+        
+        if (this->p_Stream == p_Stream)
+        {
+            this->p_Stream = NULL;
+        }
+    }
+    
+    /**
+     *  Abort the send of a tracked send id if still in progress.
+     *
+     *  \param u64_SendID The id of the tracked send.
+     *
+     *  \return true if the send belongs to this context, false if not.
+     */
+    
+    bool Abort(uint64_t u64_SendID) noexcept
+    {
+        std::lock_guard<std::mutex> c_Guard(c_StreamMutex);
+        
+        if (p_Stream == NULL || this->u64_SendID != u64_SendID || c_Data.e_State != StreamData::IN_USE)
+        {
+            return false;
+        }
+        
+        // @NOTE: Shutdown is queued by msquic, the send completes
+        //        as canceled on the worker thread.
+        p_APITable->StreamShutdown(p_Stream,
+                                   QUIC_STREAM_SHUTDOWN_FLAG_ABORT,
+                                   0);
+        return true;
+    }
+    
+    //*************************************************************************************
+    // Spool
+    //*************************************************************************************
+    
+    /**
+     *  Read the next chunk of the spooled custom net message to send.
+     *
+     *  \param us_PrefixSize The size of the bytes to keep in front of the chunk.
+     *
+     *  \return The quic buffer for the chunk.
+     */
+    
+    QUIC_BUFFER* ReadSpooled(size_t us_PrefixSize)
+    {
+        CustomSpool::ReadChunk(i_SpoolFD, u64_SpoolRemaining, c_Data.v_Bytes, sizeof(QUIC_BUFFER) + us_PrefixSize);
+        
+        QUIC_BUFFER* p_QuicBuffer = (QUIC_BUFFER*)&(c_Data.v_Bytes[0]);
+        p_QuicBuffer->Buffer = &(c_Data.v_Bytes[sizeof(QUIC_BUFFER)]);
+        p_QuicBuffer->Length = c_Data.v_Bytes.size() - sizeof(QUIC_BUFFER);
+        
+        return p_QuicBuffer;
+    }
+    
     //*************************************************************************************
     // Types
     //*************************************************************************************
     
     const QUIC_API_TABLE* p_APITable;
     
+    ClientPool& c_ClientPool;
+    size_t us_ClientID;
+    
+    uint64_t u64_SendID; // Tracked by the client, 0 if untracked
     StreamData c_Data;
+    
+    // Stream of the current send, NULL once closed
+    std::mutex c_StreamMutex;
+    HQUIC p_Stream;
+    
+    // Custom net messages are read from disk while sent
+    int i_SpoolFD; // -1 if not spooled
+    uint64_t u64_SpoolRemaining;
 };
 
 #endif /* StreamSendContext_h */
@@ -0,0 +1,84 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+
+// External
+
+// Project
+#include "./NotificationWindow.h"
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+NotificationWindow::NotificationWindow() noexcept
+{}
+
+NotificationWindow::~NotificationWindow() noexcept
+{}
+
+//*************************************************************************************
+// Window
+//*************************************************************************************
+
+bool NotificationWindow::Add(std::vector<uint8_t> const& v_Notification, std::chrono::steady_clock::time_point c_Expire)
+{
+    bool b_Opened = this->v_Notification.size() == 0;
+    
+    if (b_Opened == true)
+    {
+        this->c_Expire = c_Expire;
+    }
+    
+    // Copied into the kept buffer, no allocation within a window
+    this->v_Notification.assign(v_Notification.begin(), v_Notification.end());
+    
+    return b_Opened;
+}
+
+bool NotificationWindow::Take(std::chrono::steady_clock::time_point c_Time, std::vector<uint8_t>& v_Notification) noexcept
+{
+    if (c_Time < c_Expire)
+    {
+        return false;
+    }
+    
+    return Take(v_Notification);
+}
+
+bool NotificationWindow::Take(std::vector<uint8_t>& v_Notification) noexcept
+{
+    if (this->v_Notification.size() == 0)
+    {
+        return false;
+    }
+    
+    v_Notification.swap(this->v_Notification);
+    this->v_Notification.clear();
+    
+    return true;
+}
+
+//*************************************************************************************
+// Getters
+//*************************************************************************************
+
+std::chrono::steady_clock::time_point NotificationWindow::GetExpire() const noexcept
+{
+    return c_Expire;
+}
@@ -0,0 +1,112 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef NotificationWindow_h
+#define NotificationWindow_h
+
+// C / C++
+#include <vector>
+#include <chrono>
+
+// External
+
+// Project
+
+
+// @NOTE: Bursts are coalesced, the newest notification is forwarded
+//        once the window of the first ended.
+class NotificationWindow
+{
+public:
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     */
+    
+    NotificationWindow() noexcept;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~NotificationWindow() noexcept;
+    
+    //*************************************************************************************
+    // Window
+    //*************************************************************************************
+    
+    /**
+     *  Add a notification, replacing the one of the current window.
+     *
+     *  \param v_Notification The full notification net message buffer.
+     *  \param c_Expire The end of the window if this notification opens one.
+     *
+     *  \return true if a window was opened, false if added to the current one.
+     */
+    
+    bool Add(std::vector<uint8_t> const& v_Notification, std::chrono::steady_clock::time_point c_Expire);
+    
+    /**
+     *  Take the notification of a ended window.
+     *
+     *  \param c_Time The current time.
+     *  \param v_Notification The notification to write.
+     *
+     *  \return true if the window ended with a notification, false if not.
+     */
+    
+    bool Take(std::chrono::steady_clock::time_point c_Time, std::vector<uint8_t>& v_Notification) noexcept;
+    
+    /**
+     *  Take the notification of the current window, ended or not.
+     *
+     *  \param v_Notification The notification to write.
+     *
+     *  \return true if a notification was taken, false if none.
+     */
+    
+    bool Take(std::vector<uint8_t>& v_Notification) noexcept;
+    
+    //*************************************************************************************
+    // Getters
+    //*************************************************************************************
+    
+    /**
+     *  Get the end of the current window.
+     *
+     *  \return The window end time.
+     */
+    
+    std::chrono::steady_clock::time_point GetExpire() const noexcept;
+    
+private:
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    std::vector<uint8_t> v_Notification; // Newest of the window, empty if none
+    std::chrono::steady_clock::time_point c_Expire;
+    
+protected:
+
+};
+
+#endif /* NotificationWindow_h */
@@ -0,0 +1,106 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+
+// External
+
+// Project
+#include "./SendTracker.h"
+
+
+//*************************************************************************************
+// Constructor / Destructor
+//*************************************************************************************
+
+SendTracker::SendTracker() noexcept
+{}
+
+SendTracker::~SendTracker() noexcept
+{}
+
+//*************************************************************************************
+// Track
+//*************************************************************************************
+
+SendTracker::Send& SendTracker::Add(uint64_t u64_SendID)
+{
+    Send& c_Send = m_Send[u64_SendID];
+    c_Send = Send();
+    
+    return c_Send;
+}
+
+void SendTracker::Remove(uint64_t u64_SendID) noexcept
+{
+    m_Send.erase(u64_SendID);
+}
+
+void SendTracker::Complete(uint64_t u64_SendID, bool b_Delivered)
+{
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    dq_Completed.emplace_back(u64_SendID, b_Delivered);
+}
+
+void SendTracker::Update(std::chrono::steady_clock::time_point c_Time, std::vector<Result>& v_Result, std::vector<uint64_t>& v_Expired)
+{
+    std::deque<std::pair<uint64_t, bool>> dq_Result;
+    
+    c_Mutex.lock();
+    dq_Result.swap(dq_Completed);
+    c_Mutex.unlock();
+    
+    v_Result.clear();
+    v_Expired.clear();
+    
+    for (auto& Completed : dq_Result)
+    {
+        auto Tracked = m_Send.find(Completed.first);
+        
+        if (Tracked == m_Send.end())
+        {
+            continue;
+        }
+        
+        v_Result.push_back({ std::move(Tracked->second), Completed.second });
+        m_Send.erase(Tracked);
+    }
+    
+    for (auto& Tracked : m_Send)
+    {
+        if (Tracked.second.b_Aborted == false && Tracked.second.c_Expire <= c_Time)
+        {
+            Tracked.second.b_Aborted = true;
+            v_Expired.emplace_back(Tracked.first);
+        }
+    }
+}
+
+void SendTracker::Clear(std::vector<Send>& v_Send)
+{
+    v_Send.clear();
+    v_Send.reserve(m_Send.size());
+    
+    for (auto& Tracked : m_Send)
+    {
+        v_Send.emplace_back(std::move(Tracked.second));
+    }
+    
+    m_Send.clear();
+    
+    std::lock_guard<std::mutex> c_Guard(c_Mutex);
+    dq_Completed.clear();
+}
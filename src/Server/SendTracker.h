@@ -0,0 +1,172 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef SendTracker_h
+#define SendTracker_h
+
+// C / C++
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <utility>
+
+// External
+
+// Project
+
+
+// @NOTE: A send which does not complete in time is aborted, never
+//        given up on. The canceled completion decides the fallback,
+//        a message is either delivered or stored but not both.
+class SendTracker
+{
+public:
+    
+    //*************************************************************************************
+    // Types
+    //*************************************************************************************
+    
+    struct Send
+    {
+    public:
+        
+        //*************************************************************************************
+        // Constructor
+        //*************************************************************************************
+        
+        /**
+         *  Default constructor.
+         */
+        
+        Send() noexcept : u64_MessageID(0),
+                          u64_SpoolID(0),
+                          b_Aborted(false)
+        {}
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        uint64_t u64_MessageID; // Stored message, 0 if sent directly
+        std::vector<uint8_t> v_Data; // Direct message to store if not delivered
+        uint64_t u64_SpoolID; // Custom net message removed once delivered, 0 if none
+        std::chrono::steady_clock::time_point c_Expire;
+        bool b_Aborted; // Timed out, waiting for the canceled completion
+    };
+    
+    struct Result
+    {
+    public:
+        
+        //*************************************************************************************
+        // Data
+        //*************************************************************************************
+        
+        Send c_Send;
+        bool b_Delivered;
+    };
+    
+    //*************************************************************************************
+    // Constructor / Destructor
+    //*************************************************************************************
+    
+    /**
+     *  Default constructor.
+     */
+    
+    SendTracker() noexcept;
+    
+    /**
+     *  Copy constructor. Disabled for this class.
+     *
+     *  \param c_SendTracker SendTracker class source.
+     */
+    
+    SendTracker(SendTracker const& c_SendTracker) = delete;
+    
+    /**
+     *  Default destructor.
+     */
+    
+    ~SendTracker() noexcept;
+    
+    //*************************************************************************************
+    // Track
+    //*************************************************************************************
+    
+    /**
+     *  Start tracking a send.
+     *
+     *  \param u64_SendID The id of the send.
+     *
+     *  \return The tracked send to fill.
+     */
+    
+    Send& Add(uint64_t u64_SendID);
+    
+    /**
+     *  Stop tracking a send which failed to start.
+     *
+     *  \param u64_SendID The id of the send.
+     */
+    
+    void Remove(uint64_t u64_SendID) noexcept;
+    
+    /**
+     *  Add a send completion. This function is thread safe.
+     *
+     *  \param u64_SendID The id of the send.
+     *  \param b_Delivered If the send was delivered or canceled.
+     */
+    
+    void Complete(uint64_t u64_SendID, bool b_Delivered);
+    
+    /**
+     *  Finish completed sends and find sends which timed out. Timed out sends
+     *  are reported once and stay tracked until completed.
+     *
+     *  \param c_Time The current time.
+     *  \param v_Result The completed sends to write.
+     *  \param v_Expired The ids of sends to abort to write.
+     */
+    
+    void Update(std::chrono::steady_clock::time_point c_Time, std::vector<Result>& v_Result, std::vector<uint64_t>& v_Expired);
+    
+    /**
+     *  Stop tracking all sends.
+     *
+     *  \param v_Send The sends which did not complete to write.
+     */
+    
+    void Clear(std::vector<Send>& v_Send);
+    
+private:
+    
+    //*************************************************************************************
+    // Data
+    //*************************************************************************************
+    
+    std::mutex c_Mutex;
+    std::deque<std::pair<uint64_t, bool>> dq_Completed; // Guarded by mutex
+    std::unordered_map<uint64_t, Send> m_Send; // Guarded by the owner
+    
+protected:
+
+};
+
+#endif /* SendTracker_h */
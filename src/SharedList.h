@@ -23,6 +23,7 @@
 #include <memory>
 #include <deque>
 #include <list>
+#include <utility>
 
 // External
 
@@ -30,7 +31,7 @@
 #include "./Exception.h"
 
 
-template<typename T> class SharedList
+template<typename T, typename Pointer = std::shared_ptr<T>> class SharedList
 {
 public:
     
@@ -58,12 +59,13 @@ public:
     //*************************************************************************************
     
     /**
-     *  Add a element to the shared list.
+     *  Add a element to the shared list. The element is moved into the
+     *  list, pass a temporary or moved pointer to skip reference counting.
      *
      *  \param p_Element The element to add.
      */
     
-    void Add(std::shared_ptr<T> p_Element)
+    void Add(Pointer p_Element)
     {
         if (p_Element == NULL || p_Element == nullptr)
         {
@@ -101,7 +103,7 @@ public:
             // Lock for outside multithreading
             std::lock_guard<std::mutex> c_Guard(c_Mutex);
             
-            dq_Element.emplace_back(p_Element);
+            dq_Element.emplace_back(std::move(p_Element));
             us_TotalCount += 1;
             us_AvailableCount += 1;
         }
@@ -121,9 +123,9 @@ public:
      *  \return The first available list element on success, NULL on failure.
      */
     
-    std::shared_ptr<T> GetElement() noexcept
+    Pointer GetElement() noexcept
     {
-        std::shared_ptr<T> p_Result(NULL);
+        Pointer p_Result(nullptr);
         
         for (size_t i = 0; i < us_TotalCount; ++i)
         {
@@ -155,9 +157,9 @@ public:
      *  \return The available list elements.
      */
     
-    std::list<std::shared_ptr<T>> GetElements() noexcept
+    std::list<Pointer> GetElements() noexcept
     {
-        std::list<std::shared_ptr<T>> l_Result;
+        std::list<Pointer> l_Result;
         
         for (size_t i = 0; i < us_TotalCount; ++i)
         {
@@ -168,10 +170,8 @@ public:
             
             if (dq_Element[i].p_Element != NULL)
             {
-                l_Result.push_back(dq_Element[i].p_Element);
-                
-                dq_Element[i].p_Element.reset();
-                dq_Element[i].p_Element = NULL;
+                // Moved, leaves the entry empty
+                l_Result.push_back(std::move(dq_Element[i].p_Element));
                 
                 us_AvailableCount -= 1;
             }
@@ -220,7 +220,7 @@ private:
          *  \param p_Element The element to add.
          */
             
-        Entry(std::shared_ptr<T>& p_Element) noexcept : p_Element(p_Element)
+        Entry(Pointer&& p_Element) noexcept : p_Element(std::move(p_Element))
         {}
         
         /**
@@ -243,7 +243,7 @@ private:
         //*************************************************************************************
         
         std::mutex c_Mutex;
-        std::shared_ptr<T> p_Element;
+        Pointer p_Element;
     };
     
     //*************************************************************************************
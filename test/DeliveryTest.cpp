@@ -0,0 +1,285 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+// C / C++
+#include <chrono>
+#include <deque>
+#include <vector>
+
+// External
+
+// Project
+#include "../src/Server/DirectQueue.h"
+#include "../src/Server/SendTracker.h"
+#include "../src/Server/NotificationWindow.h"
+#include "../src/Database/Memory/MemoryStore.h"
+#include "./Test.h"
+
+
+namespace
+{
+    //*************************************************************************************
+    // Recipient
+    //*************************************************************************************
+    
+    constexpr uint32_t u32_UserID = 1;
+    const std::string s_DeviceKey = "device";
+    constexpr uint8_t u8_ActorType = 0;
+    
+    std::vector<uint8_t> Message(NetMessage::NetMessageList e_ID, uint8_t u8_Value)
+    {
+        return { static_cast<uint8_t>(e_ID), u8_Value };
+    }
+    
+    // @NOTE: Same handling as the client, undelivered direct messages
+    //        are stored and delivered stored messages acknowledged.
+    void Finish(SendTracker& c_Tracker, MemoryStore& c_Store, std::chrono::steady_clock::time_point c_Time, std::vector<uint64_t>& v_Expired)
+    {
+        std::vector<SendTracker::Result> v_Result;
+        
+        c_Tracker.Update(c_Time, v_Result, v_Expired);
+        
+        for (auto& Result : v_Result)
+        {
+            if (Result.c_Send.u64_MessageID != 0)
+            {
+                if (Result.b_Delivered == true)
+                {
+                    c_Store.AcknowledgeMessage(u32_UserID, s_DeviceKey, u8_ActorType, Result.c_Send.u64_MessageID);
+                }
+            }
+            else if (Result.b_Delivered == false)
+            {
+                c_Store.StoreMessage(u32_UserID, s_DeviceKey, u8_ActorType, Result.c_Send.v_Data);
+            }
+        }
+    }
+    
+    size_t StoredCount(MemoryStore& c_Store)
+    {
+        std::vector<uint8_t> v_Message;
+        uint64_t u64_MessageID;
+        size_t us_Count = 0;
+        
+        while (c_Store.RetrieveMessage(u32_UserID, s_DeviceKey, u8_ActorType, v_Message, u64_MessageID) == true)
+        {
+            c_Store.AcknowledgeMessage(u32_UserID, s_DeviceKey, u8_ActorType, u64_MessageID);
+            ++us_Count;
+        }
+        
+        return us_Count;
+    }
+    
+    //*************************************************************************************
+    // Direct
+    //*************************************************************************************
+    
+    void DirectDelivery()
+    {
+        DirectQueue c_Direct;
+        std::deque<NetMessage> dq_Send;
+        
+        // Stored messages might exist until a retrieval was empty
+        TEST_CHECK(c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 1))) == false);
+        
+        c_Direct.SetDrained(c_Direct.GetGeneration());
+        
+        TEST_CHECK(c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 2))) == true);
+        TEST_CHECK(c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 3))) == true);
+        
+        c_Direct.Take(dq_Send);
+        
+        TEST_CHECK(dq_Send.size() == 2);
+        TEST_CHECK(dq_Send.size() == 2 && dq_Send[0].v_Data[1] == 2 && dq_Send[1].v_Data[1] == 3);
+        
+        // Unsent are returned in front of newer ones
+        TEST_CHECK(c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 4))) == true);
+        dq_Send.pop_front();
+        c_Direct.Return(dq_Send);
+        c_Direct.Take(dq_Send);
+        
+        TEST_CHECK(dq_Send.size() == 2 && dq_Send[0].v_Data[1] == 3 && dq_Send[1].v_Data[1] == 4);
+        
+        // Disconnected clients store everything
+        c_Direct.Close();
+        
+        TEST_CHECK(c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 5))) == false);
+    }
+    
+    void DirectOrder()
+    {
+        DirectQueue c_Direct;
+        
+        c_Direct.SetDrained(c_Direct.GetGeneration());
+        
+        // Stored messages have to be read before direct ones pass
+        c_Direct.SetAvailable();
+        
+        TEST_CHECK(c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 1))) == false);
+        
+        // A message stored during an empty retrieval might have been missed
+        uint64_t u64_Generation = c_Direct.GetGeneration();
+        c_Direct.SetAvailable();
+        c_Direct.SetDrained(u64_Generation);
+        
+        TEST_CHECK(c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 2))) == false);
+        
+        c_Direct.SetDrained(c_Direct.GetGeneration());
+        
+        TEST_CHECK(c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 3))) == true);
+    }
+    
+    void DirectReplace()
+    {
+        DirectQueue c_Direct;
+        std::deque<NetMessage> dq_Send;
+        
+        c_Direct.SetDrained(c_Direct.GetGeneration());
+        
+        c_Direct.Add(NetMessage(Message(NetMessage::MSG_LOCATION, 1)));
+        c_Direct.Add(NetMessage(Message(NetMessage::MSG_TEXT, 2)));
+        c_Direct.Add(NetMessage(Message(NetMessage::MSG_LOCATION, 3)));
+        c_Direct.Take(dq_Send);
+        
+        TEST_CHECK(dq_Send.size() == 2 && dq_Send[0].v_Data[1] == 2 && dq_Send[1].v_Data[1] == 3);
+    }
+    
+    //*************************************************************************************
+    // Timeout
+    //*************************************************************************************
+    
+    void TimeoutStore()
+    {
+        SendTracker c_Tracker;
+        MemoryStore c_Store;
+        std::vector<uint64_t> v_Expired;
+        auto c_Time = std::chrono::steady_clock::now();
+        
+        SendTracker::Send& c_Send = c_Tracker.Add(1);
+        c_Send.v_Data = Message(NetMessage::MSG_TEXT, 1);
+        c_Send.c_Expire = c_Time + std::chrono::seconds(10);
+        
+        Finish(c_Tracker, c_Store, c_Time, v_Expired);
+        
+        TEST_CHECK(v_Expired.size() == 0);
+        
+        // Timed out sends are aborted once, not stored yet
+        Finish(c_Tracker, c_Store, c_Time + std::chrono::seconds(10), v_Expired);
+        
+        TEST_CHECK(v_Expired.size() == 1 && v_Expired[0] == 1);
+        TEST_CHECK(StoredCount(c_Store) == 0);
+        
+        Finish(c_Tracker, c_Store, c_Time + std::chrono::seconds(11), v_Expired);
+        
+        TEST_CHECK(v_Expired.size() == 0);
+        
+        // The canceled completion stores the message
+        c_Tracker.Complete(1, false);
+        Finish(c_Tracker, c_Store, c_Time + std::chrono::seconds(12), v_Expired);
+        
+        TEST_CHECK(StoredCount(c_Store) == 1);
+    }
+    
+    void TimeoutDelivered()
+    {
+        SendTracker c_Tracker;
+        MemoryStore c_Store;
+        std::vector<uint64_t> v_Expired;
+        auto c_Time = std::chrono::steady_clock::now();
+        
+        SendTracker::Send& c_Send = c_Tracker.Add(1);
+        c_Send.v_Data = Message(NetMessage::MSG_TEXT, 1);
+        c_Send.c_Expire = c_Time;
+        
+        Finish(c_Tracker, c_Store, c_Time, v_Expired);
+        
+        TEST_CHECK(v_Expired.size() == 1);
+        
+        // Delivered before the abort took effect, not duplicated
+        c_Tracker.Complete(1, true);
+        c_Tracker.Complete(1, false);
+        Finish(c_Tracker, c_Store, c_Time, v_Expired);
+        
+        TEST_CHECK(StoredCount(c_Store) == 0);
+    }
+    
+    void TimeoutDisconnect()
+    {
+        SendTracker c_Tracker;
+        std::vector<SendTracker::Send> v_Send;
+        
+        c_Tracker.Add(1).u64_MessageID = 7;
+        c_Tracker.Add(2).v_Data = Message(NetMessage::MSG_TEXT, 1);
+        c_Tracker.Complete(1, true);
+        c_Tracker.Clear(v_Send);
+        
+        TEST_CHECK(v_Send.size() == 2);
+        
+        // Completions after clearing are ignored
+        std::vector<SendTracker::Result> v_Result;
+        std::vector<uint64_t> v_Expired;
+        
+        c_Tracker.Complete(2, false);
+        c_Tracker.Update(std::chrono::steady_clock::now(), v_Result, v_Expired);
+        
+        TEST_CHECK(v_Result.size() == 0);
+    }
+    
+    //*************************************************************************************
+    // Notification
+    //*************************************************************************************
+    
+    void NotificationCoalesce()
+    {
+        NotificationWindow c_Window;
+        std::vector<uint8_t> v_Notification;
+        auto c_Time = std::chrono::steady_clock::now();
+        auto c_Expire = c_Time + std::chrono::milliseconds(100);
+        
+        TEST_CHECK(c_Window.Take(c_Time, v_Notification) == false);
+        
+        // The first opens the window, later ones replace it
+        TEST_CHECK(c_Window.Add(Message(NetMessage::MSG_NOTIFICATION, 1), c_Expire) == true);
+        TEST_CHECK(c_Window.Add(Message(NetMessage::MSG_NOTIFICATION, 2), c_Expire + std::chrono::milliseconds(50)) == false);
+        TEST_CHECK(c_Window.Add(Message(NetMessage::MSG_NOTIFICATION, 3), c_Expire + std::chrono::milliseconds(80)) == false);
+        TEST_CHECK(c_Window.GetExpire() == c_Expire);
+        
+        TEST_CHECK(c_Window.Take(c_Expire - std::chrono::milliseconds(1), v_Notification) == false);
+        TEST_CHECK(c_Window.Take(c_Expire, v_Notification) == true);
+        TEST_CHECK(v_Notification.size() == 2 && v_Notification[1] == 3);
+        
+        // Forwarded once, the next opens a new window
+        TEST_CHECK(c_Window.Take(c_Expire, v_Notification) == false);
+        TEST_CHECK(c_Window.Add(Message(NetMessage::MSG_NOTIFICATION, 4), c_Expire + std::chrono::milliseconds(100)) == true);
+        
+        // Disconnected clients forward at once
+        TEST_CHECK(c_Window.Take(v_Notification) == true);
+        TEST_CHECK(v_Notification.size() == 2 && v_Notification[1] == 4);
+    }
+}
+
+int main()
+{
+    Test::Run("Direct delivery", DirectDelivery);
+    Test::Run("Direct order after stored", DirectOrder);
+    Test::Run("Direct replace latest", DirectReplace);
+    Test::Run("Timeout falls back to store", TimeoutStore);
+    Test::Run("Timeout delivered late", TimeoutDelivered);
+    Test::Run("Timeout disconnect", TimeoutDisconnect);
+    Test::Run("Notification coalesce", NotificationCoalesce);
+    
+    return Test::Failed();
+}
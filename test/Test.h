@@ -0,0 +1,86 @@
+/**
+ *  Copyright (C) 2021 - 2022 The MRH Project Authors.
+ * 
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef Test_h
+#define Test_h
+
+// C / C++
+#include <cstdio>
+#include <string>
+
+// External
+
+// Project
+
+
+// @NOTE: Tests print one line per failed check, the exit code is
+//        the number of failed checks.
+namespace Test
+{
+    //*************************************************************************************
+    // Check
+    //*************************************************************************************
+    
+    /**
+     *  Get the failed check count.
+     *
+     *  \return The failed check count.
+     */
+    
+    inline int& Failed() noexcept
+    {
+        static int i_Failed = 0;
+        return i_Failed;
+    }
+    
+    /**
+     *  Check a condition.
+     *
+     *  \param b_Condition The condition which has to be true.
+     *  \param s_Name The name to print on failure.
+     *  \param p_File The file of the check.
+     *  \param i_Line The line of the check.
+     */
+    
+    inline void Check(bool b_Condition, std::string const& s_Name, const char* p_File, int i_Line) noexcept
+    {
+        if (b_Condition == false)
+        {
+            printf("%s:%d: Check failed: %s\n", p_File, i_Line, s_Name.c_str());
+            ++(Failed());
+        }
+    }
+    
+    /**
+     *  Run a test case.
+     *
+     *  \param s_Name The name to print.
+     *  \param c_Function The test case to run.
+     */
+    
+    template <typename Function> void Run(std::string const& s_Name, Function&& c_Function)
+    {
+        int i_Before = Failed();
+        
+        c_Function();
+        
+        printf("%-48s %s\n", s_Name.c_str(), Failed() == i_Before ? "passed" : "FAILED");
+    }
+}
+
+#define TEST_CHECK(Condition) Test::Check((Condition), #Condition, __FILE__, __LINE__)
+
+#endif /* Test_h */